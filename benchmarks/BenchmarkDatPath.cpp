@@ -0,0 +1,82 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <DatPath.h>
+#include <DatPathBuf.h>
+#include <DatPathScan.h>
+
+using namespace Dvfs;
+
+namespace {
+    // Paths of the lengths seen in real asset trees
+    const std::string shortPath = "data/config.json";
+    const std::string mediumPath = "textures/characters/player/armour/iron_chestplate.png";
+    const std::string longPath = "mods/example_mod/assets/textures/characters/player/armour/chest/variants/"
+                                 "iron_chestplate_normal_map_high_resolution.png";
+}
+
+TEST_CASE("DatPathScan scan", "[!benchmark][DatPathScan]") {
+    INFO("Implementation: " << DatPathScan::getImplementation());
+
+    for (const std::string* path: {&shortPath, &mediumPath, &longPath}) {
+        BENCHMARK("Scalar scan, " + std::to_string(path->size()) + " bytes") {
+            return DatPathScan::scanScalar(*path);
+        };
+
+        BENCHMARK("Vector scan, " + std::to_string(path->size()) + " bytes") {
+            return DatPathScan::scan(*path);
+        };
+    }
+}
+
+TEST_CASE("DatPathScan split", "[!benchmark][DatPathScan]") {
+    std::vector<std::string_view> parts;
+    parts.reserve(32);
+
+    for (const std::string* path: {&shortPath, &mediumPath, &longPath}) {
+        BENCHMARK("Scalar split, " + std::to_string(path->size()) + " bytes") {
+            parts.clear();
+            DatPathScan::splitScalar(*path, parts);
+            return parts.size();
+        };
+
+        BENCHMARK("Vector split, " + std::to_string(path->size()) + " bytes") {
+            parts.clear();
+            DatPathScan::split(*path, parts);
+            return parts.size();
+        };
+    }
+}
+
+TEST_CASE("DatPath construction", "[!benchmark][DatPath]") {
+    const std::string untrimmedPath = "/" + longPath + "/";
+
+    BENCHMARK("Clean path") {
+        return DatPath(longPath);
+    };
+
+    BENCHMARK("Path with leading and trailing slashes") {
+        return DatPath(untrimmedPath);
+    };
+
+    const DatPath path(longPath);
+    BENCHMARK("Depth") {
+        return path.depth();
+    };
+
+    BENCHMARK("Split") {
+        return path.split();
+    };
+}
+
+TEST_CASE("DatPathBuf composition", "[!benchmark][DatPathBuf]") {
+    const DatPath base("textures/characters/player/armour");
+
+    BENCHMARK("DatPath base / name") {
+        return base / "iron_chestplate.png";
+    };
+
+    BENCHMARK("DatPathBuf base / name") {
+        return DatPathBuf<>(base) / "iron_chestplate.png";
+    };
+}
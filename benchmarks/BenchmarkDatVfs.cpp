@@ -0,0 +1,134 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <DatVfs.h>
+
+using namespace Dvfs;
+
+namespace {
+    class BenchmarkDvfsFile : public IDvfsFile {
+    public:
+        [[nodiscard]] uint64_t fileSize() const override {
+            return 0;
+        }
+
+        [[nodiscard]] bool isValidFile() const override {
+            return true;
+        }
+
+        bool getContent(char*) const override {
+            return false;
+        }
+    };
+
+    /**
+     * Build a VFS shaped like an asset tree, with a few directory levels of files
+     */
+    void populate(DatVFS& vfs) {
+        for (int i = 0; i < 16; ++i) {
+            for (int j = 0; j < 16; ++j) {
+                for (int k = 0; k < 16; ++k) {
+                    const std::string path = "shaders/group_" + std::to_string(i) + "/set_" + std::to_string(j)
+                                             + "/shader_" + std::to_string(k) + ".vert";
+                    vfs.mountFile(path, new BenchmarkDvfsFile, true);
+                }
+            }
+        }
+        vfs.mountFile("shaders/main.vert", new BenchmarkDvfsFile, true);
+    }
+}
+
+TEST_CASE("DatVFS lookup", "[!benchmark][DatVFS]") {
+    DatVFS vfs;
+    populate(vfs);
+
+    BENCHMARK("getFile string literal") {
+        return vfs.getFile("shaders/group_7/set_3/shader_11.vert");
+    };
+
+    const DatPath path("shaders/group_7/set_3/shader_11.vert");
+    BENCHMARK("getFile DatPath") {
+        return vfs.getFile(path);
+    };
+
+    BENCHMARK("getFile DatPath after a change") {
+        DvfsLookupCache::invalidate();
+        return vfs.getFile(path);
+    };
+
+    BENCHMARK("getFile DatPathView") {
+        return vfs.getFile(DatPathView(path));
+    };
+
+    BENCHMARK("getFile path literal") {
+        return vfs.getFile("shaders/group_7/set_3/shader_11.vert"_dp);
+    };
+}
+
+TEST_CASE("DatVFS frozen lookup", "[!benchmark][DatVFS]") {
+    DatVFS vfs;
+    populate(vfs);
+    for (int i = 0; i < 4096; ++i) {
+        vfs.mountFile("flat/file_" + std::to_string(i) + ".bin", new BenchmarkDvfsFile, true);
+    }
+
+    const DatPath path("shaders/group_7/set_3/shader_11.vert");
+    const DatPath flat("flat/file_1234.bin");
+    const DatPath missing("flat/file_4096.bin");
+
+    BENCHMARK("getFile mutable") {
+        return vfs.getFile(path);
+    };
+
+    BENCHMARK("getFile mutable flat") {
+        return vfs.getFile(flat);
+    };
+
+    BENCHMARK("getFile mutable miss") {
+        return vfs.getFile(missing);
+    };
+
+    vfs.freeze();
+
+    BENCHMARK("getFile frozen") {
+        return vfs.getFile(path);
+    };
+
+    BENCHMARK("getFile frozen flat") {
+        return vfs.getFile(flat);
+    };
+
+    BENCHMARK("getFile frozen miss") {
+        return vfs.getFile(missing);
+    };
+
+    BENCHMARK("getFile frozen path literal") {
+        return vfs.getFile("shaders/group_7/set_3/shader_11.vert"_dp);
+    };
+}
+
+TEST_CASE("LooseDvfsFile reads", "[!benchmark][IDvfsFile]") {
+    LooseDvfsFile file("../../include/DatPath.h");
+    std::vector<char> buffer(file.fileSize());
+
+    BENCHMARK("getContent") {
+        return file.getContent(buffer.data());
+    };
+
+    BENCHMARK("getContentRange") {
+        return file.getContentRange(buffer.data(), 64, 256);
+    };
+
+    DvfsDescriptorCache cache;
+    LooseDvfsFile::setDescriptorCache(&cache);
+
+    BENCHMARK("getContent cached descriptor") {
+        return file.getContent(buffer.data());
+    };
+
+    BENCHMARK("getContentRange cached descriptor") {
+        return file.getContentRange(buffer.data(), 64, 256);
+    };
+
+    LooseDvfsFile::setDescriptorCache(nullptr);
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "DatPath.h"
+
+namespace Dvfs {
+    /**
+     * A glob pattern, compiled once so it can be matched against many paths in a DatVFS
+     * <br>
+     * Patterns are split on '/' into segments, each segment matches one name in the path and supports:
+     * <ul>
+     *     <li><b>*</b> Matches any number of characters</li>
+     *     <li><b>?</b> Matches any single character</li>
+     *     <li><b>[abc]</b>, <b>[a-z]</b> Matches one character from the set, <b>[!abc]</b> negates the set</li>
+     * </ul>
+     * A segment that is exactly <b>**</b> matches zero or more directories
+     */
+    class DatGlob {
+    public:
+        /**
+         * A single compiled segment of a glob pattern
+         */
+        struct Segment {
+            enum class Type : uint8_t {
+                /** Contains no wildcards, can be looked up directly */
+                Literal,
+                /** Contains wildcards, names must be matched against it */
+                Wildcard,
+                /** The "**" segment */
+                Recursive
+            };
+
+            Type type;
+            std::string pattern;
+
+            /** The number of characters at the start of the pattern that must match literally */
+            size_t prefixLength = 0;
+            /** The number of characters at the end of the pattern that must match literally */
+            size_t suffixLength = 0;
+            /** The shortest name that could match the pattern */
+            size_t minLength = 0;
+            /** Whether the pattern contains a '*', when it doesn't the name must be exactly minLength long */
+            bool hasStar = false;
+
+            /**
+             * Check if a name matches this segment
+             * @param name The name of a file or directory
+             * @return true if the name matches
+             */
+            [[nodiscard]] bool matches(std::string_view name) const;
+        };
+
+    private:
+        std::vector<Segment> segments;
+        bool valid = true;
+
+    public:
+        /**
+         * Create a glob that matches nothing
+         */
+        DatGlob() = default;
+
+        /**
+         * Compile a glob pattern
+         * @param pattern The pattern to compile
+         */
+        DatGlob(std::string_view pattern); // NOLINT(google-explicit-constructor)
+        DatGlob(const std::string& pattern) : DatGlob(std::string_view(pattern)) {} // NOLINT(google-explicit-constructor)
+        DatGlob(const char* pattern) : DatGlob(std::string_view(pattern)) {} // NOLINT(google-explicit-constructor)
+
+        /**
+         * Get the compiled segments of the pattern
+         * @return The segments of the pattern
+         */
+        [[nodiscard]] const std::vector<Segment>& getSegments() const;
+
+        /**
+         * Check if the pattern compiled successfully
+         * <br>
+         * Patterns with an unterminated character set are invalid, and never match anything
+         * @return true if the pattern is valid
+         */
+        [[nodiscard]] bool isValid() const;
+
+        /**
+         * Check if a path matches the whole pattern
+         * @param path The path to check
+         * @return true if the path matches
+         */
+        [[nodiscard]] bool matches(const DatPath& path) const;
+
+        /**
+         * Get a copy of the glob with its ASCII uppercase letters folded to lowercase, for matching case-insensitive VFSs
+         * @return The folded glob
+         */
+        [[nodiscard]] DatGlob foldCase() const;
+
+        /**
+         * Match a name against a single wildcard pattern, without any precompiled information
+         * @param pattern The pattern to match against
+         * @param name The name to match
+         * @return true if the name matches
+         */
+        static bool wildcardMatch(std::string_view pattern, std::string_view name);
+    };
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Dvfs {
+    /**
+     * A fast, non-cryptographic 64 bit hash of file contents, producing the same values as XXH64
+     * <br>
+     * Data can either be hashed in one go with hash(), or streamed in pieces with update() and digest()
+     */
+    class DvfsHasher {
+        uint64_t accumulators[4];
+        uint64_t totalLength = 0;
+        uint64_t seed;
+
+        /** Input that didn't fill a whole 32 byte stripe */
+        unsigned char buffer[32];
+        size_t bufferedLength = 0;
+
+    public:
+        /**
+         * Create a hasher
+         * @param seed The seed for the hash
+         */
+        explicit DvfsHasher(uint64_t seed = 0);
+
+        /**
+         * Add data to the hash
+         * @param data The data to add
+         * @param length The length of the data in bytes
+         */
+        void update(const void* data, size_t length);
+
+        /**
+         * Get the hash of all the data added so far
+         * <br>
+         * This doesn't reset the hasher, more data can be added afterwards
+         * @return The hash
+         */
+        [[nodiscard]] uint64_t digest() const;
+
+        /**
+         * Hash a block of data
+         * @param data The data to hash
+         * @param length The length of the data in bytes
+         * @param seed The seed for the hash
+         * @return The hash
+         */
+        static uint64_t hash(const void* data, size_t length, uint64_t seed = 0);
+    };
+}
@@ -4,6 +4,8 @@
 #include <string>
 #include <vector>
 
+#include "DatPathView.h"
+
 namespace Dvfs {
 /**
  * A wrapper for strings that represents paths in a DatVFS
@@ -12,8 +14,10 @@ namespace Dvfs {
  */
     class DatPath {
         std::string path;
+        /** The path with uppercase letters folded to lowercase, empty if the path has no uppercase letters */
+        std::string folded;
 
-        static std::string sanitisePath(std::string path);
+        static std::string sanitisePath(std::string path, bool& hasUppercase);
 
     public:
         /**
@@ -23,13 +27,25 @@ namespace Dvfs {
 
         /**
          * Create a path
+         * <br>
+         * The path is normalised, leading and trailing slashes are removed, repeated slashes are collapsed and "." and
+         * ".." sections are resolved. A ".." that would go above the start of the path is dropped.
          * @param path A string representing the path
+         * @throws std::invalid_argument If the path contains a backslash
          */
-        DatPath(std::string path) : path(sanitisePath(std::move(path))) {} // NOLINT(google-explicit-constructor)
+        DatPath(std::string path); // NOLINT(google-explicit-constructor)
         DatPath(const char* path) : DatPath(std::string(path)) {} // NOLINT(google-explicit-constructor)
 
+        /**
+         * Create a path from a view of a path that's already normalised
+         * @param path The path to copy
+         */
+        DatPath(DatPathView path); // NOLINT(google-explicit-constructor)
+
         explicit operator std::string() const;
 
+        operator DatPathView() const; // NOLINT(google-explicit-constructor)
+
         bool operator==(const DatPath& rh) const;
 
         /**
@@ -71,7 +87,27 @@ namespace Dvfs {
          */
         [[nodiscard]] bool empty() const;
 
-        [[nodiscard]] std::vector<std::string_view> split() const;
+        /**
+         * Get the path with its ASCII uppercase letters folded to lowercase, used as the key in case-insensitive VFSs
+         * <br>
+         * The folded key is computed once when the path is created
+         * @return The folded path
+         */
+        [[nodiscard]] const std::string& getFoldedKey() const;
+
+        /**
+         * Split the path into its sections
+         * @param folded Whether to split the folded key instead of the path
+         * @return Views of each section, which are valid as long as this path is
+         */
+        [[nodiscard]] std::vector<std::string_view> split(bool folded = false) const;
+
+        /**
+         * Fold the ASCII uppercase letters in some text to lowercase
+         * @param text The text to fold
+         * @return The folded text
+         */
+        static std::string foldCase(std::string_view text);
     };
 }
 
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "DatPath.h"
+#include "DatPathView.h"
+
+namespace Dvfs {
+    /**
+     * A path with inline storage, for composing paths in hot code without allocating
+     * <br>
+     * Paths are normalised the same way as DatPath as they're built. Paths longer than the inline capacity spill onto
+     * the heap, so the capacity only needs to fit typical paths. DatPathBuf converts to a DatPathView for allocation
+     * free lookups, and to a DatPath for every other DatVFS function.
+     * @tparam Capacity The number of characters stored inline
+     */
+    template<size_t Capacity = 256>
+    class DatPathBuf {
+        std::array<char, Capacity> buffer;
+        size_t length = 0;
+
+        /** The storage used once the path no longer fits in the buffer */
+        std::string overflow;
+        bool spilled = false;
+
+        [[nodiscard]] const char* data() const {
+            return spilled ? overflow.data() : buffer.data();
+        }
+
+        /**
+         * Append characters to the path without normalising them
+         * @param text The characters to append
+         */
+        void appendRaw(std::string_view text) {
+            if (!spilled && length + text.size() > Capacity) {
+                overflow.assign(buffer.data(), length);
+                spilled = true;
+            }
+
+            if (spilled) overflow.append(text);
+            else text.copy(buffer.data() + length, text.size());
+            length += text.size();
+        }
+
+        /**
+         * Append a single section to the path, resolving "." and ".."
+         * @param section The section to append
+         */
+        void appendSection(std::string_view section) {
+            if (section.empty() || section == ".") return;
+            if (section == "..") {
+                removeLast();
+                return;
+            }
+
+            if (length != 0) appendRaw("/");
+            appendRaw(section);
+        }
+
+        /**
+         * Shorten the path
+         * @param size The new length of the path
+         */
+        void truncate(size_t size) {
+            length = size;
+            if (spilled) overflow.resize(size);
+        }
+
+    public:
+        /**
+         * Create an empty path
+         */
+        DatPathBuf() = default;
+
+        /**
+         * Create a path, normalising it the same way as DatPath
+         * @param path A string representing the path
+         * @throws std::invalid_argument If the path contains a backslash
+         */
+        explicit DatPathBuf(std::string_view path) {
+            *this /= path;
+        }
+        explicit DatPathBuf(const std::string& path) : DatPathBuf(std::string_view(path)) {}
+        explicit DatPathBuf(const char* path) : DatPathBuf(std::string_view(path)) {}
+
+        /**
+         * Create a path from a path that's already normalised
+         * @param path The path to copy
+         */
+        DatPathBuf(DatPathView path) { // NOLINT(google-explicit-constructor)
+            appendRaw(path.str());
+        }
+
+        DatPathBuf(const DatPath& path) : DatPathBuf(DatPathView(path)) {} // NOLINT(google-explicit-constructor)
+
+        /**
+         * Append the sub-path onto the path in place
+         * <br>
+         * ".." sections in the sub-path remove sections from this path, like they do for DatPath
+         * @param subPath The path to append
+         * @return This path
+         * @throws std::invalid_argument If the sub-path contains a backslash
+         */
+        DatPathBuf& operator/=(std::string_view subPath) {
+            if (subPath.find('\\') != std::string_view::npos) {
+                throw std::invalid_argument("DatPath cannot contain backslashes: " + std::string(subPath));
+            }
+
+            size_t start = 0;
+            while (start < subPath.size()) {
+                size_t end = subPath.find('/', start);
+                if (end == std::string_view::npos) end = subPath.size();
+
+                appendSection(subPath.substr(start, end - start));
+                start = end + 1;
+            }
+
+            return *this;
+        }
+
+        /**
+         * Append the normalised sub-path onto the path in place
+         * @param subPath The path to append
+         * @return This path
+         */
+        DatPathBuf& operator/=(DatPathView subPath) {
+            if (subPath.empty()) return *this;
+
+            if (length != 0) appendRaw("/");
+            appendRaw(subPath.str());
+            return *this;
+        }
+
+        /**
+         * Append the sub-path onto a copy of the path
+         * @param subPath The path to append
+         * @return A new path made out of this one and the sub-path
+         */
+        DatPathBuf operator/(std::string_view subPath) const {
+            DatPathBuf newPath = *this;
+            newPath /= subPath;
+            return newPath;
+        }
+
+        DatPathBuf operator/(DatPathView subPath) const {
+            DatPathBuf newPath = *this;
+            newPath /= subPath;
+            return newPath;
+        }
+
+        /**
+         * Remove the last section of the path
+         */
+        void removeLast() {
+            const size_t separator = str().rfind('/');
+            truncate(separator == std::string_view::npos ? 0 : separator);
+        }
+
+        /**
+         * Remove every section of the path
+         */
+        void clear() {
+            truncate(0);
+        }
+
+        /**
+         * Fold the ASCII uppercase letters in the path to lowercase in place
+         */
+        void foldCase() {
+            char* characters = spilled ? overflow.data() : buffer.data();
+            for (size_t i = 0; i < length; ++i) {
+                if (characters[i] >= 'A' && characters[i] <= 'Z') characters[i] += 'a' - 'A';
+            }
+        }
+
+        /**
+         * Get the path as a string
+         * @return The path, valid until the path is next modified
+         */
+        [[nodiscard]] std::string_view str() const {
+            return {data(), length};
+        }
+
+        /**
+         * Check if the path is empty
+         * @return True if the path is empty
+         */
+        [[nodiscard]] bool empty() const {
+            return length == 0;
+        }
+
+        /**
+         * Check if the path still fits in the inline storage
+         * @return True if the path hasn't spilled onto the heap
+         */
+        [[nodiscard]] bool isInline() const {
+            return !spilled;
+        }
+
+        operator DatPathView() const { // NOLINT(google-explicit-constructor)
+            return DatPathView(str());
+        }
+
+        operator DatPath() const { // NOLINT(google-explicit-constructor)
+            return DatPath(DatPathView(str()));
+        }
+    };
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+#include "DatPath.h"
+#include "DatPathView.h"
+
+namespace Dvfs {
+    /**
+     * A name paired with its hash, so maps in a DatVFS can be searched without hashing the name again
+     */
+    struct HashedName {
+        std::string_view name;
+        size_t hash;
+
+        /**
+         * Hash a name the same way DatVFS hashes its keys
+         * <br>
+         * This is 64-bit FNV-1a, which is simple enough to run at compile time
+         * @param name The name to hash
+         * @return The hash of the name
+         */
+        static constexpr size_t hashName(std::string_view name) {
+            uint64_t hash = 0xcbf29ce484222325ull;
+            for (const char c: name) {
+                hash ^= static_cast<unsigned char>(c);
+                hash *= 0x100000001b3ull;
+            }
+            return static_cast<size_t>(hash);
+        }
+
+        constexpr HashedName(std::string_view name, size_t hash) : name(name), hash(hash) {}
+        constexpr explicit HashedName(std::string_view name) : HashedName(name, hashName(name)) {}
+
+        friend bool operator==(const HashedName& lh, std::string_view rh) {
+            return lh.name == rh;
+        }
+    };
+
+    /**
+     * A path validated, split and hashed at compile time, created with the _dp literal
+     * <br>
+     * Literals have to already be normalised, so they can't start or end with '/', repeat '/', or contain '\', "." or
+     * ".." sections, and must not be empty. Malformed literals fail to compile.
+     * <br>
+     * The members are only public so literals can be used as template arguments, and shouldn't be set directly.
+     * @tparam N The size of the string literal, including the null terminator
+     */
+    template<size_t N>
+    struct DatPathLiteral {
+        struct Section {
+            size_t offset = 0;
+            size_t length = 0;
+            size_t hash = 0;
+            size_t foldedHash = 0;
+        };
+
+        /** The path, without the null terminator */
+        std::array<char, N - 1> path{};
+        /** The path with ASCII uppercase letters folded to lowercase */
+        std::array<char, N - 1> folded{};
+        /** Every section is at least one character followed by a '/', apart from the last */
+        std::array<Section, N / 2 + 1> sections{};
+        size_t sectionCount = 0;
+
+        consteval DatPathLiteral(const char (&text)[N]) { // NOLINT(google-explicit-constructor)
+            if (N <= 1) throw std::invalid_argument("DatPath literals cannot be empty");
+
+            size_t start = 0;
+            for (size_t i = 0; i < N; ++i) {
+                // Treat the null terminator as the end of the last section
+                const char c = i < N - 1 ? text[i] : '/';
+
+                if (c == '\\') throw std::invalid_argument("DatPath literals cannot contain backslashes");
+                if (c != '/') {
+                    path[i] = c;
+                    folded[i] = c >= 'A' && c <= 'Z' ? static_cast<char>(c + ('a' - 'A')) : c;
+                    continue;
+                }
+                if (i < N - 1) path[i] = folded[i] = '/';
+
+                const std::string_view section(path.data() + start, i - start);
+                if (section.empty()) {
+                    throw std::invalid_argument("DatPath literals cannot start or end with '/', or repeat '/'");
+                }
+                if (section == "." || section == "..") {
+                    throw std::invalid_argument("DatPath literals cannot contain \".\" or \"..\" sections");
+                }
+
+                sections[sectionCount++] = {
+                        start,
+                        i - start,
+                        HashedName::hashName(section),
+                        HashedName::hashName(std::string_view(folded.data() + start, i - start))
+                };
+                start = i + 1;
+            }
+        }
+
+        /**
+         * Get a section of the path along with its precomputed hash
+         * @param index The index of the section
+         * @param caseFolded Whether to get the section from the folded path
+         * @return The section and its hash
+         */
+        [[nodiscard]] constexpr HashedName getSection(size_t index, bool caseFolded = false) const {
+            const Section& section = sections[index];
+            return caseFolded
+                    ? HashedName(std::string_view(folded.data() + section.offset, section.length), section.foldedHash)
+                    : HashedName(std::string_view(path.data() + section.offset, section.length), section.hash);
+        }
+
+        /**
+         * Get the path as a string
+         * @return The path
+         */
+        [[nodiscard]] constexpr std::string_view str() const {
+            return {path.data(), path.size()};
+        }
+
+        operator DatPathView() const { // NOLINT(google-explicit-constructor)
+            return DatPathView(str());
+        }
+
+        operator DatPath() const { // NOLINT(google-explicit-constructor)
+            return DatPath(DatPathView(str()));
+        }
+    };
+
+    inline namespace literals {
+        /**
+         * Create a path literal, validated, split and hashed at compile time
+         * @return A reference to the literal, which lives for the whole program
+         */
+        template<DatPathLiteral Literal>
+        consteval const auto& operator""_dp() {
+            return Literal;
+        }
+    }
+}
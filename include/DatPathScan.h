@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace Dvfs {
+    /**
+     * The result of scanning a path string in a single pass, along with the vectorised routines that produce it
+     * <br>
+     * The routines use AVX2 or SSE2 when the library is compiled with them enabled, and fall back to scalar code
+     * otherwise. The scalar versions are always available for comparison.
+     */
+    struct DatPathScan {
+        /** The number of '/' characters in the path */
+        size_t separators = 0;
+        /** Whether the path contains a '\' */
+        bool hasBackslash = false;
+        /** Whether the path contains two or more '/' in a row */
+        bool hasRepeatedSeparator = false;
+        /** Whether a section of the path starts with '.', so may be a "." or ".." section */
+        bool hasDotSection = false;
+        /** Whether the path contains any uppercase ASCII letters */
+        bool hasUppercase = false;
+
+        bool operator==(const DatPathScan& rh) const = default;
+
+        /**
+         * Scan a path
+         * @param path The path to scan
+         * @return The result of the scan
+         */
+        static DatPathScan scan(std::string_view path);
+
+        /**
+         * Scan a path without using vector instructions
+         * @param path The path to scan
+         * @return The result of the scan
+         */
+        static DatPathScan scanScalar(std::string_view path);
+
+        /**
+         * Split a path on '/', skipping empty sections
+         * @param path The path to split
+         * @param parts The vector to add the sections to
+         */
+        static void split(std::string_view path, std::vector<std::string_view>& parts);
+
+        /**
+         * Split a path on '/', skipping empty sections, without using vector instructions
+         * @param path The path to split
+         * @param parts The vector to add the sections to
+         */
+        static void splitScalar(std::string_view path, std::vector<std::string_view>& parts);
+
+        /**
+         * Get the name of the instruction set used by scan() and split()
+         * @return "avx2", "sse2" or "scalar"
+         */
+        static const char* getImplementation();
+    };
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace Dvfs {
+    class DatPath;
+
+    template<size_t Capacity>
+    class DatPathBuf;
+
+    template<size_t N>
+    struct DatPathLiteral;
+
+    /**
+     * A non-owning view of a normalised path, created from a DatPath, DatPathBuf or DatPathLiteral
+     * <br>
+     * Views are only valid as long as the path they were created from is, and can be passed to DatVFS lookups without
+     * allocating
+     */
+    class DatPathView {
+        std::string_view path;
+
+        /**
+         * Create a view of a string that's already normalised
+         * @param path The normalised path
+         */
+        explicit DatPathView(std::string_view path) : path(path) {}
+
+        friend class DatPath;
+
+        template<size_t Capacity>
+        friend class DatPathBuf;
+
+        template<size_t N>
+        friend struct DatPathLiteral;
+
+    public:
+        /**
+         * Create an empty view
+         */
+        DatPathView() = default;
+
+        bool operator==(const DatPathView& rh) const = default;
+
+        /**
+         * Get the viewed path as a string
+         * @return The path
+         */
+        [[nodiscard]] std::string_view str() const {
+            return path;
+        }
+
+        /**
+         * Check if the path is empty
+         * @return True if the path is empty
+         */
+        [[nodiscard]] bool empty() const {
+            return path.empty();
+        }
+
+        /**
+         * Get the first section of the path
+         * @return The first section, or an empty string if the path is empty
+         */
+        [[nodiscard]] std::string_view front() const {
+            return path.substr(0, path.find('/'));
+        }
+
+        /**
+         * Get the path without its first section
+         * @return The rest of the path, empty if the path only has one section
+         */
+        [[nodiscard]] DatPathView next() const {
+            const size_t separator = path.find('/');
+            return DatPathView(separator == std::string_view::npos ? std::string_view() : path.substr(separator + 1));
+        }
+    };
+}
@@ -1,22 +1,66 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <set>
 #include <string>
 #include <vector>
 #include <span>
 #include <unordered_map>
 #include <functional>
 
+#include "DatGlob.h"
 #include "DatPath.h"
+#include "DatPathBuf.h"
+#include "DatPathLiteral.h"
+#include "DatVfsAsync.h"
+#include "DatVfsBufferPool.h"
+#include "DatVfsDedup.h"
+#include "DatVfsDescriptorCache.h"
 #include "DatVfsFile.h"
 #include "DatVfsFileInserter.h"
+#include "DatVfsHandle.h"
+#include "DatVfsIndex.h"
+#include "DatVfsLookupCache.h"
+#include "DatVfsManifest.h"
+#include "DatVfsMountGroup.h"
+#include "DatVfsNameTable.h"
+#include "DatVfsPatch.h"
+#include "DatVfsResidency.h"
+#include "DatVfsThreadPool.h"
 
 namespace Dvfs {
     /**
      * A root or directory node in the Virtual File System
      */
     class DatVFS {
-        std::unordered_map<std::string, DatVFS*> directories;
-        std::unordered_map<std::string, IDvfsFile*> files;
+        DvfsNameTable<DatVFS*> directories;
+        DvfsNameTable<IDvfsFile*> files;
+
+        /** The root of the VFS this directory belongs to */
+        DatVFS* root;
+
+        /** The directory containing this one, null for the root */
+        DatVFS* parent;
+
+        /** The name of this directory in its parent, which views the parent's key, empty for the root */
+        std::string_view name;
+
+        /** Whether paths are looked up by their folded key, only used by the root */
+        bool caseInsensitive = false;
+
+        /** The secondary index of mounted files, only used by the root and null when indexing is disabled */
+        std::unique_ptr<DvfsFileIndex> fileIndex;
+
+        /** The content deduplicator, only used by the root and null when deduplication is disabled */
+        std::unique_ptr<DvfsDeduplicator> deduplicator;
+
+        /** The slots file handles point into, only used by the root and created with it */
+        std::unique_ptr<DvfsHandleTable> handles;
+
+        /** The groups files were mounted in, only used by the root and null until files are first mounted in bulk */
+        std::unique_ptr<DvfsMountGroups> groups;
 
         // Directory management
         /**
@@ -33,18 +77,32 @@ namespace Dvfs {
          * @param path The path to mount the file at
          * @param dvfsFile The file to mount
          * @param createDirectories Whether to create parent directories as needed
+         * @param tag The tag to index the file under, empty for no tag
          * @return true if successful
          */
-        bool mountFile(std::span<std::string_view> path, IDvfsFile* dvfsFile, bool createDirectories = false);
+        bool mountFile(std::span<std::string_view> path, IDvfsFile* dvfsFile, bool createDirectories = false, std::string_view tag = {});
 
         /**
          * Mount multiple files on the VFS using an inserter
+         * <br>
+         * Each file follows the same rules as mountFile, files that fail to mount are passed to the inserter's
+         * handleInsertFailure. Files are mounted as the inserter streams them, so the whole set is never held at once.
          * @param basePath The starting path to mount the files on
          * @param inserter A DvfsFileInserter defining what files to mount
          * @param createDirectories Whether to create parent directories for the basePath and any paths for files being mounted
-         * @return the number of files mounted
+         * @param tag The tag to index the files under, empty for no tag
+         * @return The group the files were mounted in, with the number of files mounted
          */
-        int mountFiles(std::span<std::string_view> path, const IDvfsFileInserter& inserter, bool createDirectories = false);
+        DvfsMountGroup mountFiles(std::span<std::string_view> path, const IDvfsFileInserter& inserter, bool createDirectories = false, std::string_view tag = {});
+
+        /**
+         * Mount a file directly in this directory
+         * @param name The name to mount the file under
+         * @param dvfsFile The file to mount
+         * @param tag The tag to index the file under, empty for no tag
+         * @return The name as stored in the directory, or nullptr if the file couldn't be mounted
+         */
+        const std::string* mountLeaf(std::string_view name, IDvfsFile* dvfsFile, std::string_view tag);
 
         // Unmount
         /**
@@ -57,6 +115,38 @@ namespace Dvfs {
          */
         bool unmountFile(std::span<std::string_view> path, bool deleteDvfsFile = true);
 
+        /**
+         * Unmount a file stored directly in this directory, removing it from the index and its group
+         * <br>
+         * The directory must already be thawed
+         * @param it The file's entry in this directory
+         * @param deleteDvfsFile Whether to delete the DvfsFile if this was the last reference
+         */
+        void unmountEntry(DvfsNameTable<IDvfsFile*>::iterator it, bool deleteDvfsFile);
+
+        /**
+         * Turn this directory's tables back into hash maps so they can be changed, if they're frozen
+         * <br>
+         * This is called before every change to the directory, and keeps the index, groups and subdirectories
+         * pointing at the names as they move
+         */
+        void thaw();
+
+        /**
+         * Turn only this directory's subdirectory table back into a hash map, if it's frozen
+         * <br>
+         * For changes that only add or remove subdirectories. Unlike thaw(), this doesn't touch the index or groups
+         * the whole tree shares, so sibling directories can do it at the same time.
+         */
+        void thawDirectories();
+
+        /**
+         * Update the index and groups after a file's name has moved
+         * @param previous The address the name was stored at
+         * @param name The name as it is now stored in this directory
+         */
+        void fileMoved(const char* previous, const std::string& name) const;
+
         /**
          * Remove a directory from the VFS, deleting it and all files and directories contained within
          * @param path The path to the directory to remove
@@ -145,6 +235,204 @@ namespace Dvfs {
                        bool recursive = false,
                        const std::function<bool(const std::string&, DatVFS*)>& predicate = [](const std::string&, DatVFS*){return true;}) const;
 
+        /**
+         * Find the files matching the remaining segments of a glob pattern
+         * @param segments The segments of the pattern left to match, starting with this directory
+         * @param path The path of this directory, relative to where the search started
+         * @param callback The function to call with each matching file, returns false to stop searching
+         * @param count The running total of matched files
+         * @param visited The directories already searched for each number of remaining segments, nullptr if the
+         * pattern can only reach each directory one way
+         * @return false if the callback asked to stop searching
+         */
+        bool glob(std::span<const DatGlob::Segment> segments,
+                  const DatPath& path,
+                  const std::function<bool(const DatPath&, IDvfsFile*)>& callback,
+                  int& count,
+                  std::set<std::pair<const DatVFS*, size_t>>* visited) const;
+
+        /**
+         * Release this directory's reference to a file, deleting it if nothing else in the VFS references it
+         * @param file The file to release
+         * @param deleteFile Whether to delete the file if this was the last reference
+         */
+        void releaseFile(IDvfsFile* file, bool deleteFile = true);
+
+        /**
+         * Replace every file in this directory and its subdirectories with an identical file already seen by the
+         * deduplicator
+         * @param deduplicator The deduplicator to use
+         */
+        void deduplicateTree(DvfsDeduplicator& deduplicator);
+
+        // Indexing
+        /**
+         * Add every file in this directory and its subdirectories to the index
+         * @param index The index to add to
+         */
+        void indexTree(DvfsFileIndex& index) const;
+
+        /**
+         * Remove every file in this directory and its subdirectories from the index
+         * @param index The index to remove from
+         */
+        void unindexTree(DvfsFileIndex& index) const;
+
+        /**
+         * Check if this directory is inside the given directory
+         * @param directory The directory that may contain this one
+         * @return true if this directory is, or is below, the given directory
+         */
+        bool isWithin(const DatVFS* directory) const;
+
+        /**
+         * Find files with the given extension by walking the tree, used when indexing is disabled
+         * @param extension The extension, without the leading '.'
+         * @param entries The vector to add the files to
+         */
+        void findByExtension(std::string_view extension, std::vector<DvfsFileIndex::Entry>& entries) const;
+
+        /**
+         * Get the key to look a path up by, folding it into the buffer if the VFS is case-insensitive
+         * @param path The path to look up
+         * @param buffer The storage for the folded path
+         * @return The key to look the path up by
+         */
+        DatPathView getLookupKey(DatPathView path, DatPathBuf<>& buffer) const;
+
+        /**
+         * Walk to the directory containing the last section of a path without allocating
+         * @param path The non-empty path to walk, already folded if needed
+         * @param name Set to the last section of the path
+         * @return The directory containing the last section, or nullptr if it doesn't exist
+         */
+        const DatVFS* findParent(DatPathView path, std::string_view& name) const;
+
+        /**
+         * Walk to the directory containing the last section of a path literal, using its precomputed hashes
+         * @param path The path to walk
+         * @return The directory containing the last section, or nullptr if it doesn't exist
+         */
+        template<size_t N>
+        const DatVFS* findParent(const DatPathLiteral<N>& path) const {
+            const bool caseFolded = root->caseInsensitive;
+            const DatVFS* directory = this;
+
+            for (size_t i = 0; i + 1 < path.sectionCount; ++i) {
+                auto it = directory->directories.find(path.getSection(i, caseFolded));
+                if (it == directory->directories.end()) return nullptr;
+                directory = it->second;
+            }
+
+            return directory;
+        }
+
+        /**
+         * Split a path into the keys used by this VFS, folding the case if the VFS is case-insensitive
+         * @param path The path to split
+         * @return The keys of each section of the path
+         */
+        [[nodiscard]] std::vector<std::string_view> splitPath(const DatPath& path) const;
+
+        // Parallel
+        /**
+         * Count the files in this directory and queue counting the subdirectories on the task group
+         * @param group The task group to queue subdirectories on
+         * @param count The running total to add to
+         * @param recursive Whether to count files in subdirectories too
+         * @param predicate The filter that decides which files to count
+         */
+        template<typename Predicate>
+        void countFilesTask(DvfsThreadPool::TaskGroup& group, std::atomic<int>& count, bool recursive, const Predicate& predicate) const {
+            int local = 0;
+            for (const auto& [name, file]: files) {
+                if (predicate(name, file)) ++local;
+            }
+            count.fetch_add(local, std::memory_order_relaxed);
+
+            if (!recursive) return;
+
+            for (const auto& [name, directory]: directories) {
+                group.run([directory, &group, &count, &predicate]() {
+                    directory->countFilesTask(group, count, true, predicate);
+                });
+            }
+        }
+
+        /**
+         * Count the directories in this directory and queue counting the subdirectories on the task group
+         * @param group The task group to queue subdirectories on
+         * @param count The running total to add to
+         * @param recursive Whether to count directories in subdirectories too
+         * @param predicate The filter that decides which directories to count
+         */
+        template<typename Predicate>
+        void countDirectoriesTask(DvfsThreadPool::TaskGroup& group, std::atomic<int>& count, bool recursive, const Predicate& predicate) const {
+            int local = 0;
+            for (const auto& [name, directory]: directories) {
+                if (predicate(name, directory)) ++local;
+
+                if (recursive) {
+                    group.run([directory, &group, &count, &predicate]() {
+                        directory->countDirectoriesTask(group, count, true, predicate);
+                    });
+                }
+            }
+            count.fetch_add(local, std::memory_order_relaxed);
+        }
+
+        /** The number of files hashed by each task when verifying or creating a manifest in parallel */
+        static constexpr size_t hashBatchSize = 8;
+
+        /**
+         * Visit the files in this directory and queue visiting the subdirectories on the task group
+         * @param group The task group to queue subdirectories on
+         * @param path The path of this directory, relative to where the walk started
+         * @param recursive Whether to visit files in subdirectories too
+         * @param visitor The function to call for each file
+         * @param batchSize The number of files to visit in each task queued on the group, 0 to visit them all on the
+         * current task, which is quicker when visiting a file is cheap
+         */
+        template<typename Visitor>
+        void walkFilesTask(DvfsThreadPool::TaskGroup& group, const DatPath& path, bool recursive, const Visitor& visitor,
+                           size_t batchSize = 0) const {
+            if (batchSize == 0) {
+                for (const auto& [name, file]: files) {
+                    visitor(path, name, file);
+                }
+            } else {
+                // The tree can't change during a walk, so the iterators stay valid until the tasks run
+                for (auto it = files.begin(); it != files.end();) {
+                    const auto first = it;
+                    size_t count = 0;
+                    for (; it != files.end() && count < batchSize; ++it) ++count;
+
+                    group.run([first, count, path, &visitor]() {
+                        auto entry = first;
+                        for (size_t i = 0; i < count; ++i, ++entry) {
+                            const auto& [name, file] = *entry;
+                            visitor(path, name, file);
+                        }
+                    });
+                }
+            }
+
+            if (!recursive) return;
+
+            for (const auto& [name, directory]: directories) {
+                group.run([directory, subPath = path / name, &group, &visitor, batchSize]() {
+                    directory->walkFilesTask(group, subPath, true, visitor, batchSize);
+                });
+            }
+        }
+
+        /**
+         * Prune the subdirectories of this directory in parallel, then remove the ones left empty
+         * @param pool The pool to run on
+         * @param count The running total of directories deleted
+         */
+        void pruneTask(DvfsThreadPool& pool, std::atomic<int>& count);
+
     public:
         /**
          * Create a root node
@@ -171,21 +459,30 @@ namespace Dvfs {
         // Mounting
         /**
          * Mount a DvfsFile on the VFS
+         * <br>
+         * On success the VFS takes a reference to the file, and the file is deleted when the last reference held by any
+         * VFS is released. On failure no reference is taken, and the file is still owned by the caller.
          * @param path The path to mount the file at
          * @param dvfsFile The file to mount
          * @param createDirectories Whether to create parent directories as needed
+         * @param tag The tag to index the file under, empty for no tag. Tags are only recorded while indexing is enabled
          * @return true if successful
          */
-        bool mountFile(const DatPath& path, IDvfsFile* dvfsFile, bool createDirectories = false);
+        bool mountFile(const DatPath& path, IDvfsFile* dvfsFile, bool createDirectories = false, std::string_view tag = {});
 
         /**
          * Mount multiple files on the VFS using an inserter
+         * <br>
+         * Each file follows the same rules as mountFile, files that fail to mount are passed to the inserter's
+         * handleInsertFailure. Files are mounted as the inserter streams them, so the whole set is never held at once.
          * @param basePath The starting path to mount the files on
          * @param inserter A DvfsFileInserter defining what files to mount
          * @param createDirectories Whether to create parent directories for the basePath and any paths for files being mounted
-         * @return the number of files mounted
+         * @param tag The tag to index the files under, empty for no tag. Tags are only recorded while indexing is enabled
+         * @return The group the files were mounted in, which can be passed to unmountGroup, with the number of files
+         * mounted. The group is null if no files were mounted.
          */
-        int mountFiles(const DatPath& basePath, const IDvfsFileInserter& inserter, bool createDirectories = false);
+        DvfsMountGroup mountFiles(const DatPath& basePath, const IDvfsFileInserter& inserter, bool createDirectories = false, std::string_view tag = {});
 
         // Unmount
         /**
@@ -198,6 +495,41 @@ namespace Dvfs {
          */
         bool unmountFile(const DatPath& path, bool deleteDvfsFile = true);
 
+        /**
+         * Unmount every file mounted by a call to mountFiles that is still mounted where it was put
+         * <br>
+         * Only the group's own files are visited, so this doesn't depend on the size of the rest of the VFS. Files
+         * that were unmounted since are left alone, and reference counting works the same as unmountFile.
+         * @param group The group to unmount
+         * @param pruneDirectories Whether to remove directories left empty by unmounting the group, up to but not
+         * including this directory and the root
+         * @param deleteDvfsFiles Whether to delete each DvfsFile if this was its last reference
+         * @return The number of files unmounted
+         */
+        int unmountGroup(const DvfsMountGroup& group, bool pruneDirectories = false, bool deleteDvfsFiles = true);
+
+        /**
+         * Check if a group still has files mounted
+         * @param group The group to check
+         * @return True if any of the group's files are still mounted
+         */
+        [[nodiscard]] bool hasGroup(const DvfsMountGroup& group) const;
+
+        /**
+         * Take a reference to a file mounted in the VFS, keeping it alive once it's unmounted
+         * <br>
+         * The reference must be given back with releaseHeldFile rather than by deleting the file, so the VFS stops
+         * tracking the file only once nothing references it. The VFS must outlive the reference.
+         * @param file The file to hold
+         */
+        void holdFile(IDvfsFile* file) const;
+
+        /**
+         * Give back a reference taken with holdFile, deleting the file if nothing else references it
+         * @param file The file to release
+         */
+        void releaseHeldFile(IDvfsFile* file);
+
         /**
          * Remove a directory from the VFS, deleting it and all files and directories contained within
          * @param path The path to the directory to remove
@@ -208,11 +540,41 @@ namespace Dvfs {
         // File Access
         /**
          * Get a file inside the VFS
+         * <br>
+         * Lookups go through the calling thread's DvfsLookupCache, so paths looked up every frame only walk the tree
+         * again after the VFS changes
          * @param path The path to the file
          * @return A pointer to the file, or nullptr if the file doesn't exist
          */
         IDvfsFile* getFile(const DatPath& path) const;
 
+        /**
+         * Get a file inside the VFS without allocating
+         * @param path The path to the file
+         * @return A pointer to the file, or nullptr if the file doesn't exist
+         */
+        IDvfsFile* getFile(DatPathView path) const;
+
+        template<size_t Capacity>
+        IDvfsFile* getFile(const DatPathBuf<Capacity>& path) const {
+            // DatPathBuf converts to both DatPath and DatPathView, prefer the one that doesn't allocate
+            return getFile(DatPathView(path));
+        }
+
+        /**
+         * Get a file inside the VFS using a path literal's precomputed hashes
+         * @param path The path to the file
+         * @return A pointer to the file, or nullptr if the file doesn't exist
+         */
+        template<size_t N>
+        IDvfsFile* getFile(const DatPathLiteral<N>& path) const {
+            const DatVFS* directory = findParent(path);
+            if (directory == nullptr) return nullptr;
+
+            auto it = directory->files.find(path.getSection(path.sectionCount - 1, root->caseInsensitive));
+            return it != directory->files.end() ? it->second : nullptr;
+        }
+
         /**
          * Get a directory inside the VFS
          * @param path The path to the directory
@@ -220,6 +582,32 @@ namespace Dvfs {
          */
         DatVFS* getDirectory(const DatPath& path) const;
 
+        /**
+         * Get a directory inside the VFS without allocating
+         * @param path The path to the directory
+         * @return A pointer to the directory, or nullptr if the directory doesn't exist
+         */
+        DatVFS* getDirectory(DatPathView path) const;
+
+        template<size_t Capacity>
+        DatVFS* getDirectory(const DatPathBuf<Capacity>& path) const {
+            return getDirectory(DatPathView(path));
+        }
+
+        /**
+         * Get a directory inside the VFS using a path literal's precomputed hashes
+         * @param path The path to the directory
+         * @return A pointer to the directory, or nullptr if the directory doesn't exist
+         */
+        template<size_t N>
+        DatVFS* getDirectory(const DatPathLiteral<N>& path) const {
+            const DatVFS* directory = findParent(path);
+            if (directory == nullptr) return nullptr;
+
+            auto it = directory->directories.find(path.getSection(path.sectionCount - 1, root->caseInsensitive));
+            return it != directory->directories.end() ? it->second : nullptr;
+        }
+
         // Util
         /**
          * Check if a file or directory exists
@@ -228,6 +616,32 @@ namespace Dvfs {
          */
         int exists(const DatPath& path) const;
 
+        /**
+         * Check if a file or directory exists without allocating
+         * @param path The path to the file/directory
+         * @return positive if a file, negative if a directory, 0 for doesn't exist
+         */
+        int exists(DatPathView path) const;
+
+        template<size_t Capacity>
+        int exists(const DatPathBuf<Capacity>& path) const {
+            return exists(DatPathView(path));
+        }
+
+        /**
+         * Check if a file or directory exists using a path literal's precomputed hashes
+         * @param path The path to the file/directory
+         * @return positive if a file, negative if a directory, 0 for doesn't exist
+         */
+        template<size_t N>
+        int exists(const DatPathLiteral<N>& path) const {
+            const DatVFS* directory = findParent(path);
+            if (directory == nullptr) return 0;
+
+            const HashedName name = path.getSection(path.sectionCount - 1, root->caseInsensitive);
+            return directory->files.count(name) + (directory->directories.count(name) * -1);
+        }
+
         /**
          * Check if the given directory is empty
          * @param path The path to the directory
@@ -241,6 +655,37 @@ namespace Dvfs {
           */
          bool isRoot() const;
 
+        /**
+         * Set whether paths in the VFS are case-insensitive
+         * <br>
+         * Case-insensitive VFSs store and look up every name by its ASCII lowercase form, so listings return the folded
+         * names. This can only be changed while the VFS is empty.
+         * @param caseInsensitive Whether paths should be case-insensitive
+         * @return true if the setting was changed, false if the VFS isn't empty
+         */
+        bool setCaseInsensitive(bool caseInsensitive);
+
+        /**
+         * Check if paths in the VFS are case-insensitive
+         * @return true if paths are case-insensitive
+         */
+        [[nodiscard]] bool isCaseInsensitive() const;
+
+        /**
+         * Rebuild the tables of this directory and its subdirectories as minimal perfect hash tables
+         * <br>
+         * Frozen directories are faster to search and use less memory, and work exactly the same as before. A
+         * directory is thawed back into hash maps the next time it's changed, so freezing is best done once a tree
+         * has been fully mounted. Views returned by the index are invalidated.
+         */
+        void freeze();
+
+        /**
+         * Check if this directory is frozen
+         * @return true if this directory's tables are minimal perfect hash tables
+         */
+        [[nodiscard]] bool isFrozen() const;
+
         /**
          * List the files in a directory
          * @param path The path to the directory to list (empty for the current directory)
@@ -291,6 +736,342 @@ namespace Dvfs {
                        bool recursive = false,
                        const std::function<bool(const std::string&, DatVFS*)>& predicate = [](const std::string&, DatVFS*){return true;}) const;
 
+        // Indexing
+        /**
+         * Enable the secondary index of the VFS, indexing every file already mounted
+         * <br>
+         * While enabled, the index is updated on every mount and unmount, and answers extension and tag queries without
+         * walking the tree
+         */
+        void enableIndex();
+
+        /**
+         * Disable the secondary index of the VFS, discarding it and any tags
+         */
+        void disableIndex();
+
+        /**
+         * Get the secondary index of the VFS
+         * @return The index, or nullptr if indexing is disabled
+         */
+        [[nodiscard]] const DvfsFileIndex* getIndex() const;
+
+        /**
+         * Find all the files with the given extension in a directory and its subdirectories
+         * <br>
+         * When indexing is disabled this falls back to walking the tree
+         * @param extension The extension, without the leading '.'
+         * @param path The path to the directory to search, empty for the current directory
+         * @return The matching files, valid until the VFS is next modified
+         */
+        std::vector<DvfsFileIndex::Entry> findByExtension(std::string_view extension, const DatPath& path = DatPath()) const;
+
+        /**
+         * Find all the files mounted with the given tag in a directory and its subdirectories
+         * <br>
+         * Tags are only recorded while indexing is enabled, so this finds nothing when it is disabled
+         * @param tag The tag
+         * @param path The path to the directory to search, empty for the current directory
+         * @return The matching files, valid until the VFS is next modified
+         */
+        std::vector<DvfsFileIndex::Entry> findByTag(std::string_view tag, const DatPath& path = DatPath()) const;
+
+        // Deduplication
+        /**
+         * Enable content deduplication, sharing a single DvfsFile between all mounted files with identical content
+         * <br>
+         * Every file already mounted is hashed, and duplicates among them are merged. While enabled, each newly mounted
+         * file that isn't already referenced by a VFS is hashed, and if an identical file is already mounted then the
+         * new file is deleted and the existing one is mounted in its place.
+         * <br>
+         * <b>Warning, this means the pointer passed to mountFile may be deleted, use getFile to get the mounted file<b>
+         * @param maxFileSize The largest file that will be hashed
+         * @param verifyContent Whether to compare the full content of files with matching hashes before sharing them
+         */
+        void enableDeduplication(uint64_t maxFileSize = DvfsDeduplicator::defaultMaxFileSize, bool verifyContent = false);
+
+        /**
+         * Disable content deduplication, files that have already been shared stay shared
+         */
+        void disableDeduplication();
+
+        /**
+         * Get the content deduplicator of the VFS
+         * @return The deduplicator, or nullptr if deduplication is disabled
+         */
+        [[nodiscard]] const DvfsDeduplicator* getDeduplicator() const;
+
+        // Handles
+        /**
+         * Get a handle to a file, which can be resolved later without looking the path up again
+         * <br>
+         * The handle refers to the file rather than the path, so it stays valid while the file is mounted anywhere in
+         * the VFS, and stops resolving once it isn't
+         * <br>
+         * Handles can be requested and resolved from many threads at once, alongside other const lookups
+         * @param path The path to the file
+         * @return The handle, or the null handle if the file doesn't exist
+         */
+        DvfsFileHandle getFileHandle(const DatPath& path) const;
+
+        /**
+         * Read the whole of a file asynchronously, for use with co_await
+         * <br>
+         * The file is looked up straight away, and read on the executor when awaited. The awaiting coroutine resumes
+         * on the executor's thread.
+         * @param path The path to the file
+         * @param executor The executor to read on
+         * @return An awaitable giving the content of the file, empty if the file doesn't exist or couldn't be read
+         */
+        DvfsFileRead read(const DatPath& path, IDvfsExecutor& executor = DvfsPoolExecutor::getDefault()) const;
+
+        /**
+         * Get the pool of aligned buffers for reading files into
+         * <br>
+         * Files read directly with LooseDvfsFile::setDirectReadThreshold fill these buffers straight from the disk,
+         * where other buffers are filled through a copy
+         * @return The buffer pool
+         */
+        static DvfsAlignedBufferPool& getBufferPool();
+
+        /**
+         * Get the file a handle refers to
+         * @param handle The handle to resolve
+         * @return The file, or nullptr if the file is no longer mounted
+         */
+        [[nodiscard]] IDvfsFile* resolve(DvfsFileHandle handle) const;
+
+        /**
+         * Check if a handle still refers to a mounted file
+         * @param handle The handle to check
+         * @return true if the handle can be resolved
+         */
+        [[nodiscard]] bool isValid(DvfsFileHandle handle) const;
+
+        // Parallel
+        /**
+         * Count the number of files that match the filter in the given directory, splitting the work across a thread
+         * pool
+         * <br>
+         * The predicate is called concurrently from multiple threads, so it must be thread-safe
+         * @param path The path to the directory to start counting from, empty for the current directory
+         * @param recursive Whether to count files in subdirectories too
+         * @param predicate The filter that decides which files to count, called as predicate(const std::string&, IDvfsFile*)
+         * @param pool The pool to run on
+         * @return The number of files that match the predicate
+         */
+        template<typename Predicate>
+        int countFilesParallel(const DatPath& path,
+                               bool recursive,
+                               Predicate predicate,
+                               DvfsThreadPool& pool = DvfsThreadPool::getDefault()) const {
+            const DatVFS* directory = path.empty() ? this : getDirectory(path);
+            if (directory == nullptr) return 0;
+
+            std::atomic<int> count = 0;
+            DvfsThreadPool::TaskGroup group(pool);
+            directory->countFilesTask(group, count, recursive, predicate);
+            group.wait();
+            return count;
+        }
+
+        /**
+         * Count all the files in the given directory, splitting the work across a thread pool
+         * @param path The path to the directory to start counting from, empty for the current directory
+         * @param recursive Whether to count files in subdirectories too
+         * @return The number of files
+         */
+        int countFilesParallel(const DatPath& path = DatPath(), bool recursive = true) const {
+            return countFilesParallel(path, recursive, [](const std::string&, IDvfsFile*) {return true;});
+        }
+
+        /**
+         * Count the number of directories that match the filter in the given directory, splitting the work across a
+         * thread pool
+         * <br>
+         * The predicate is called concurrently from multiple threads, so it must be thread-safe
+         * <br>
+         * When recursive is true, the filter will not prevent searching inside directories that do not match
+         * @param path The path to the directory to start counting from, empty for the current directory
+         * @param recursive Whether to count directories in subdirectories too
+         * @param predicate The filter that decides which directories to count, called as predicate(const std::string&, DatVFS*)
+         * @param pool The pool to run on
+         * @return The number of directories that match the predicate
+         */
+        template<typename Predicate>
+        int countDirectoriesParallel(const DatPath& path,
+                                     bool recursive,
+                                     Predicate predicate,
+                                     DvfsThreadPool& pool = DvfsThreadPool::getDefault()) const {
+            const DatVFS* directory = path.empty() ? this : getDirectory(path);
+            if (directory == nullptr) return 0;
+
+            std::atomic<int> count = 0;
+            DvfsThreadPool::TaskGroup group(pool);
+            directory->countDirectoriesTask(group, count, recursive, predicate);
+            group.wait();
+            return count;
+        }
+
+        /**
+         * Count all the directories in the given directory, splitting the work across a thread pool
+         * @param path The path to the directory to start counting from, empty for the current directory
+         * @param recursive Whether to count directories in subdirectories too
+         * @return The number of directories
+         */
+        int countDirectoriesParallel(const DatPath& path = DatPath(), bool recursive = true) const {
+            return countDirectoriesParallel(path, recursive, [](const std::string&, DatVFS*) {return true;});
+        }
+
+        /**
+         * Call the visitor for every file in the given directory and its subdirectories, splitting the work across a
+         * thread pool
+         * <br>
+         * The visitor is called concurrently from multiple threads, so it must be thread-safe
+         * @param path The path to the directory to start walking from, empty for the current directory
+         * @param visitor The function to call for each file, called as
+         * visitor(const DatPath& directoryPath, const std::string& name, IDvfsFile* file) where directoryPath is
+         * relative to the given path
+         * @param pool The pool to run on
+         * @return false if the directory doesn't exist
+         */
+        template<typename Visitor>
+        bool walkFilesParallel(const DatPath& path, Visitor visitor, DvfsThreadPool& pool = DvfsThreadPool::getDefault()) const {
+            const DatVFS* directory = path.empty() ? this : getDirectory(path);
+            if (directory == nullptr) return false;
+
+            DvfsThreadPool::TaskGroup group(pool);
+            directory->walkFilesTask(group, DatPath(), true, visitor);
+            group.wait();
+            return true;
+        }
+
+        /**
+         * Hash the files that match the filter in the given directory into a manifest, splitting the work across a
+         * thread pool
+         * <br>
+         * The predicate is called concurrently from multiple threads, so it must be thread-safe
+         * @param path The path to the directory to start from, empty for the current directory, the manifest's paths
+         * are relative to it
+         * @param recursive Whether to include files in subdirectories too
+         * @param predicate The filter that decides which files to include, called as predicate(const std::string&, IDvfsFile*)
+         * @param pool The pool to run on
+         * @return The manifest, files that couldn't be read are left out
+         */
+        template<typename Predicate>
+        DvfsManifest createManifestParallel(const DatPath& path,
+                                            bool recursive,
+                                            Predicate predicate,
+                                            DvfsThreadPool& pool = DvfsThreadPool::getDefault()) const {
+            DvfsManifest manifest;
+            const DatVFS* directory = path.empty() ? this : getDirectory(path);
+            if (directory == nullptr) return manifest;
+
+            std::mutex mutex;
+            DvfsThreadPool::TaskGroup group(pool);
+            // The visitor must outlive the tasks that reference it, so it can't be a temporary
+            auto visitor = [&](const DatPath& directoryPath, const std::string& name, IDvfsFile* file) {
+                uint64_t hash;
+                if (!predicate(name, file) || !DvfsManifest::hashFile(*file, hash)) return;
+
+                std::string filePath(directoryPath);
+                if (!filePath.empty()) filePath += '/';
+                filePath += name;
+
+                const uint64_t size = file->fileSize();
+                std::lock_guard lock(mutex);
+                manifest.add(filePath, size, hash);
+            };
+            directory->walkFilesTask(group, DatPath(), recursive, visitor, hashBatchSize);
+            group.wait();
+            return manifest;
+        }
+
+        /**
+         * Hash all the files in the given directory into a manifest, splitting the work across a thread pool
+         * @param path The path to the directory to start from, empty for the current directory
+         * @param recursive Whether to include files in subdirectories too
+         * @return The manifest
+         */
+        DvfsManifest createManifestParallel(const DatPath& path = DatPath(), bool recursive = true) const {
+            return createManifestParallel(path, recursive, [](const std::string&, IDvfsFile*) {return true;});
+        }
+
+        /**
+         * Check the files that match the filter in the given directory against a manifest, splitting the work across
+         * a thread pool
+         * <br>
+         * Files are hashed in small batches spread across the pool, even within one directory, reading large files in
+         * pieces, so with enough files in flight the check is limited by how fast they can be read. Files whose size doesn't match aren't read at all. Files
+         * the predicate filters out are neither checked nor reported missing.
+         * <br>
+         * The predicate is called concurrently from multiple threads, so it must be thread-safe
+         * @param manifest The manifest to check against, with paths relative to the given directory
+         * @param path The path to the directory to start from, empty for the current directory
+         * @param recursive Whether to check files in subdirectories too
+         * @param predicate The filter that decides which files to check, called as predicate(const std::string&, IDvfsFile*)
+         * @param pool The pool to run on
+         * @return Every file that didn't match the manifest, every file in the manifest is missing if the directory
+         * doesn't exist
+         */
+        template<typename Predicate>
+        DvfsVerifyResult verifyParallel(const DvfsManifest& manifest,
+                                        const DatPath& path,
+                                        bool recursive,
+                                        Predicate predicate,
+                                        DvfsThreadPool& pool = DvfsThreadPool::getDefault()) const {
+            DvfsManifestVerifier verifier(manifest);
+            const DatVFS* directory = path.empty() ? this : getDirectory(path);
+            if (directory != nullptr) {
+                DvfsThreadPool::TaskGroup group(pool);
+                auto visitor = [&](const DatPath& directoryPath, const std::string& name, IDvfsFile* file) {
+                    verifier.check(directoryPath, name, *file, predicate(name, file));
+                };
+                directory->walkFilesTask(group, DatPath(), recursive, visitor, hashBatchSize);
+                group.wait();
+            }
+            return verifier.finish(recursive);
+        }
+
+        /**
+         * Check all the files in the given directory against a manifest, splitting the work across a thread pool
+         * @param manifest The manifest to check against, with paths relative to the given directory
+         * @param path The path to the directory to start from, empty for the current directory
+         * @param recursive Whether to check files in subdirectories too
+         * @return Every file that didn't match the manifest
+         */
+        DvfsVerifyResult verifyParallel(const DvfsManifest& manifest, const DatPath& path = DatPath(), bool recursive = true) const {
+            return verifyParallel(manifest, path, recursive, [](const std::string&, IDvfsFile*) {return true;});
+        }
+
+        /**
+         * Recursively remove empty directories from the given directory, splitting the work across a thread pool
+         * <br>
+         * No other operations may be performed on the pruned directory while this runs
+         * @param path The path to the directory start pruning from (empty for the current directory)
+         * @param pool The pool to run on
+         * @return The number of directories deleted
+         */
+        int pruneParallel(const DatPath& path = DatPath(), DvfsThreadPool& pool = DvfsThreadPool::getDefault());
+
+        /**
+         * Find all the files matching a glob pattern, streaming each one to the callback as it is found
+         * <br>
+         * Only directories that can match the pattern are searched, and segments without wildcards are looked up
+         * directly rather than compared against every entry
+         * @param pattern The compiled pattern to match, relative to this directory
+         * @param callback The function to call with the path of each matching file, return false to stop searching
+         * @return The number of files passed to the callback
+         */
+        int glob(const DatGlob& pattern, const std::function<bool(const DatPath&, IDvfsFile*)>& callback) const;
+
+        /**
+         * Find all the files matching a glob pattern
+         * @param pattern The compiled pattern to match, relative to this directory
+         * @return A vector containing the paths of all the matching files
+         */
+        std::vector<DatPath> glob(const DatGlob& pattern) const;
+
         /**
          * Generate a string displaying the structure of the VFS
          * @param prefix The current depth, used for calculating how to display the file/directory in the tree
@@ -0,0 +1,304 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "DatVfsFile.h"
+#include "DatVfsThreadPool.h"
+
+namespace Dvfs {
+    /**
+     * Runs the work behind awaited reads, implement this to run reads somewhere other than the bundled executors
+     */
+    class IDvfsExecutor {
+    public:
+        virtual ~IDvfsExecutor() = default;
+
+        /**
+         * Run some work, usually on another thread
+         * <br>
+         * Awaitables only ever pass work capturing a pointer or two, which std::function stores without allocating.
+         * Work may also run before execute() returns, in which case the awaiting coroutine carries on without suspending.
+         * @param work The work to run
+         */
+        virtual void execute(std::function<void()> work) = 0;
+    };
+
+    /**
+     * Runs awaited reads on a DvfsThreadPool, resuming the awaiting coroutine on the pool thread
+     */
+    class DvfsPoolExecutor : public IDvfsExecutor {
+        DvfsThreadPool& pool;
+
+    public:
+        /**
+         * Create an executor
+         * @param pool The pool to run reads on
+         */
+        explicit DvfsPoolExecutor(DvfsThreadPool& pool = DvfsThreadPool::getDefault()) : pool(pool) {}
+
+        /** @inherit */
+        void execute(std::function<void()> work) override;
+
+        /**
+         * Get the executor used when no executor is given, which runs on the default thread pool
+         * @return The default executor
+         */
+        static DvfsPoolExecutor& getDefault();
+    };
+
+    /**
+     * Runs awaited reads immediately on the awaiting thread, so awaiting blocks like a normal read
+     */
+    class DvfsInlineExecutor : public IDvfsExecutor {
+    public:
+        /** @inherit */
+        void execute(std::function<void()> work) override;
+    };
+
+    /**
+     * Where a DvfsTask keeps the value it returns
+     */
+    template<typename T>
+    struct DvfsTaskResult {
+        std::optional<T> value;
+
+        void return_value(T result) {
+            value.emplace(std::move(result));
+        }
+
+        T take() {
+            return std::move(*value);
+        }
+    };
+
+    template<>
+    struct DvfsTaskResult<void> {
+        void return_void() {}
+        void take() {}
+    };
+
+    /**
+     * An asynchronous operation written as a coroutine, which returns a T
+     * <br>
+     * Tasks are lazy, they don't start until they're awaited or waited on. Awaiting a task resumes the awaiting
+     * coroutine on whichever thread the task finishes on, without any allocation beyond the task's own frame.
+     * Exceptions thrown by the task are rethrown to whoever awaits it.
+     * @tparam T The type the task returns
+     */
+    template<typename T = void>
+    class DvfsTask {
+        /**
+         * Lets a thread block until a task finishes, owned by the waiting thread
+         */
+        struct Waiter {
+            std::mutex mutex;
+            std::condition_variable finished;
+            bool done = false;
+        };
+
+    public:
+        struct promise_type : DvfsTaskResult<T> {
+            std::exception_ptr exception;
+            /** The coroutine awaiting this task, resumed once it finishes */
+            std::coroutine_handle<> continuation;
+            /** The thread waiting for this task, when it was started by wait() */
+            Waiter* waiter = nullptr;
+
+            DvfsTask get_return_object() {
+                return DvfsTask(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            std::suspend_always initial_suspend() noexcept {
+                return {};
+            }
+
+            auto final_suspend() noexcept {
+                struct FinalAwaiter {
+                    bool await_ready() noexcept {
+                        return false;
+                    }
+
+                    std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+                        promise_type& promise = handle.promise();
+                        if (promise.continuation) return promise.continuation;
+
+                        // Signalled under the lock so the waiter can't return and destroy the task in between
+                        if (promise.waiter) {
+                            std::lock_guard lock(promise.waiter->mutex);
+                            promise.waiter->done = true;
+                            promise.waiter->finished.notify_one();
+                        }
+                        return std::noop_coroutine();
+                    }
+
+                    void await_resume() noexcept {}
+                };
+                return FinalAwaiter{};
+            }
+
+            void unhandled_exception() {
+                exception = std::current_exception();
+            }
+        };
+
+    private:
+        std::coroutine_handle<promise_type> handle;
+
+        explicit DvfsTask(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+        T result() {
+            if (handle.promise().exception) std::rethrow_exception(handle.promise().exception);
+            return handle.promise().take();
+        }
+
+    public:
+        DvfsTask(DvfsTask&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+
+        DvfsTask& operator=(DvfsTask&& other) noexcept {
+            if (this != &other) {
+                if (handle) handle.destroy();
+                handle = std::exchange(other.handle, nullptr);
+            }
+            return *this;
+        }
+
+        ~DvfsTask() {
+            if (handle) handle.destroy();
+        }
+
+        auto operator co_await() && noexcept {
+            struct Awaiter {
+                DvfsTask& task;
+
+                bool await_ready() noexcept {
+                    return task.handle.done();
+                }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept {
+                    task.handle.promise().continuation = continuation;
+                    return task.handle;
+                }
+
+                T await_resume() {
+                    return task.result();
+                }
+            };
+            return Awaiter{*this};
+        }
+
+        /**
+         * Run the task and block the calling thread until it finishes
+         * <br>
+         * This is for starting tasks from code that isn't a coroutine, coroutines should co_await instead
+         * @return The result of the task
+         */
+        T wait() {
+            Waiter waiter;
+            handle.promise().waiter = &waiter;
+            handle.resume();
+
+            std::unique_lock lock(waiter.mutex);
+            waiter.finished.wait(lock, [&waiter] {
+                return waiter.done;
+            });
+            return result();
+        }
+    };
+
+    /**
+     * Suspends an awaiting coroutine while some work runs on an executor
+     * <br>
+     * Whichever of the work and the suspending coroutine finishes second carries on. Work the executor runs before
+     * execute() returns therefore doesn't resume the coroutine itself, which would nest another stack frame for every
+     * await in a loop.
+     */
+    class DvfsExecutorAwaitable {
+        IDvfsExecutor& executor;
+        std::coroutine_handle<> awaiting;
+        std::atomic<bool> handedOver = false;
+
+    protected:
+        explicit DvfsExecutorAwaitable(IDvfsExecutor& executor) : executor(executor) {}
+
+        /**
+         * Run work on the executor, resuming the awaiting coroutine once it's done
+         * @param handle The awaiting coroutine
+         * @param work The work to run, capturing no more than a pointer
+         * @return False if the work has already finished and the coroutine should carry on without suspending
+         */
+        template<typename Work>
+        bool suspendFor(const std::coroutine_handle<> handle, Work work) {
+            awaiting = handle;
+            executor.execute([this, work] {
+                work();
+                if (handedOver.exchange(true, std::memory_order_acq_rel)) awaiting.resume();
+            });
+            return !handedOver.exchange(true, std::memory_order_acq_rel);
+        }
+    };
+
+    /**
+     * Reads part of a file on an executor when awaited, see IDvfsFile::readRange
+     */
+    class DvfsRangeRead : DvfsExecutorAwaitable {
+        const IDvfsFile& file;
+        char* buffer;
+        uint64_t offset;
+        uint64_t length;
+        bool success = false;
+
+    public:
+        DvfsRangeRead(const IDvfsFile& file, char* buffer, uint64_t offset, uint64_t length, IDvfsExecutor& executor)
+                : DvfsExecutorAwaitable(executor), file(file), buffer(buffer), offset(offset), length(length) {}
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle) {
+            return suspendFor(handle, [this] {
+                success = file.getContentRange(buffer, offset, length);
+            });
+        }
+
+        bool await_resume() const noexcept {
+            return success;
+        }
+    };
+
+    /**
+     * Reads the whole of a file on an executor when awaited, see DatVFS::read
+     */
+    class DvfsFileRead : DvfsExecutorAwaitable {
+        const IDvfsFile* file;
+        std::vector<char> content;
+
+    public:
+        DvfsFileRead(const IDvfsFile* file, IDvfsExecutor& executor) : DvfsExecutorAwaitable(executor), file(file) {}
+
+        bool await_ready() const noexcept {
+            // Missing files don't need to go anywhere
+            return file == nullptr;
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle) {
+            return suspendFor(handle, [this] {
+                content.resize(file->fileSize());
+                if (!file->getContent(content.data())) content.clear();
+            });
+        }
+
+        std::vector<char> await_resume() noexcept {
+            return std::move(content);
+        }
+    };
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace Dvfs {
+    /**
+     * Hands out buffers aligned for direct I/O, and keeps released buffers to hand out again
+     * <br>
+     * Buffers are rounded up to a power of two size so released buffers can be reused for similar requests. Released
+     * buffers are only kept while the total kept stays under a limit, anything over it is freed.
+     */
+    class DvfsAlignedBufferPool {
+    public:
+        /** The alignment of every buffer, and the smallest buffer size, which suits direct I/O on most devices */
+        static constexpr size_t alignment = 4096;
+
+        /** The default limit on the memory kept in released buffers */
+        static constexpr size_t defaultMaxCachedBytes = 64 * 1024 * 1024;
+
+        /**
+         * A buffer from a pool, which goes back to the pool when destroyed
+         */
+        class Buffer {
+            DvfsAlignedBufferPool* pool = nullptr;
+            char* memory = nullptr;
+            size_t capacity = 0;
+
+            friend class DvfsAlignedBufferPool;
+
+            Buffer(DvfsAlignedBufferPool* pool, char* memory, size_t capacity) : pool(pool), memory(memory), capacity(capacity) {}
+
+        public:
+            Buffer() = default;
+
+            Buffer(Buffer&& other) noexcept
+                    : pool(std::exchange(other.pool, nullptr)), memory(std::exchange(other.memory, nullptr)),
+                      capacity(std::exchange(other.capacity, 0)) {}
+
+            Buffer& operator=(Buffer&& other) noexcept;
+
+            ~Buffer();
+
+            /**
+             * Get the memory of the buffer
+             * @return The start of the buffer, aligned to DvfsAlignedBufferPool::alignment
+             */
+            [[nodiscard]] char* data() const {
+                return memory;
+            }
+
+            /**
+             * Get the usable size of the buffer, which may be larger than was asked for
+             * @return The size in bytes
+             */
+            [[nodiscard]] size_t size() const {
+                return capacity;
+            }
+
+            explicit operator bool() const {
+                return memory != nullptr;
+            }
+        };
+
+    private:
+        /** Released buffers of each power of two size */
+        std::vector<char*> freeLists[sizeof(size_t) * 8];
+        size_t cachedBytes = 0;
+        size_t maxCachedBytes;
+        mutable std::mutex mutex;
+
+        /**
+         * Take back a buffer, keeping it if there's room
+         * @param memory The buffer's memory
+         * @param capacity The buffer's size
+         */
+        void release(char* memory, size_t capacity);
+
+        static void free(char* memory);
+
+    public:
+        /**
+         * Create a pool
+         * @param maxCachedBytes The most memory to keep in released buffers
+         */
+        explicit DvfsAlignedBufferPool(size_t maxCachedBytes = defaultMaxCachedBytes) : maxCachedBytes(maxCachedBytes) {}
+
+        DvfsAlignedBufferPool(const DvfsAlignedBufferPool&) = delete;
+        DvfsAlignedBufferPool& operator=(const DvfsAlignedBufferPool&) = delete;
+
+        /**
+         * Frees the released buffers, every buffer handed out must have been released first
+         */
+        ~DvfsAlignedBufferPool();
+
+        /**
+         * Get a buffer of at least the given size
+         * @param size The number of bytes needed
+         * @return The buffer
+         */
+        Buffer acquire(size_t size);
+
+        /**
+         * Get the memory kept in released buffers
+         * @return The number of bytes kept
+         */
+        [[nodiscard]] size_t getCachedBytes() const;
+
+        /**
+         * Get the pool used for direct reads when no pool is given
+         * @return The default pool
+         */
+        static DvfsAlignedBufferPool& getDefault();
+    };
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+
+#include "DatVfsFile.h"
+
+namespace Dvfs {
+    /**
+     * Tracks the content hashes of files mounted in a DatVFS so that files with identical content can share a single
+     * DvfsFile
+     * <br>
+     * The deduplicator is owned and kept up to date by the DatVFS, it doesn't own any of the files it tracks
+     */
+    class DvfsDeduplicator {
+    public:
+        /** Files larger than this are not deduplicated by default, to avoid reading huge files at mount time */
+        static constexpr uint64_t defaultMaxFileSize = 64 * 1024 * 1024;
+
+    private:
+        /** Files that have been hashed, keyed by their content hash */
+        std::unordered_multimap<uint64_t, IDvfsFile*> files;
+        /** The content hash of each tracked file */
+        std::unordered_map<const IDvfsFile*, uint64_t> hashes;
+
+        uint64_t maxFileSize;
+        bool verifyContent;
+
+        uint64_t duplicates = 0;
+        uint64_t bytesSaved = 0;
+
+        /**
+         * Check if two files of the same size have the same content
+         * @param a The first file
+         * @param b The second file
+         * @return True if the content is identical
+         */
+        static bool contentEqual(const IDvfsFile& a, const IDvfsFile& b);
+
+    public:
+        /**
+         * Create a deduplicator
+         * @param maxFileSize The largest file that will be hashed
+         * @param verifyContent Whether to compare the full content of files with matching hashes before sharing them,
+         * rather than trusting the hash
+         */
+        explicit DvfsDeduplicator(uint64_t maxFileSize = defaultMaxFileSize, bool verifyContent = false);
+
+        /**
+         * Find a tracked file with the same content as the given one, tracking the given file if there isn't one
+         * <br>
+         * Invalid files, writable files, and files larger than the maximum file size, are never deduplicated
+         * @param file The file to deduplicate
+         * @return The tracked file with identical content, or the given file if there is none
+         */
+        IDvfsFile* deduplicate(IDvfsFile* file);
+
+        /**
+         * Stop tracking a file, usually because it is no longer mounted
+         * @param file The file to forget
+         */
+        void forget(const IDvfsFile* file);
+
+        /**
+         * Get the number of files currently tracked
+         * @return The number of tracked files
+         */
+        [[nodiscard]] size_t size() const;
+
+        /**
+         * Get the number of files that have been replaced by an identical file
+         * @return The number of duplicates found
+         */
+        [[nodiscard]] uint64_t getDuplicateCount() const;
+
+        /**
+         * Get the total size of the files that have been replaced by an identical file
+         * @return The number of bytes saved
+         */
+        [[nodiscard]] uint64_t getBytesSaved() const;
+
+        /**
+         * Calculate the content hash of a file
+         * @param file The file to hash
+         * @param hash Where to store the hash
+         * @return True if the content was read successfully
+         */
+        static bool hashFile(const IDvfsFile& file, uint64_t& hash);
+    };
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace Dvfs {
+    /**
+     * Keeps loose files open between reads, so files that are read over and over aren't opened and closed every time
+     * <br>
+     * Descriptors are kept per file object, up to a limit, closing the least recently used once it's reached. Every
+     * read still checks the path, so a file that's been deleted or replaced on disk is never read from a stale
+     * descriptor. Descriptors are read with positioned reads, so any number of threads can share one.
+     * <br>
+     * Set a cache with LooseDvfsFile::setDescriptorCache for loose files to use it.
+     */
+    class DvfsDescriptorCache {
+    public:
+        /** The default limit on the number of open files */
+        static constexpr size_t defaultMaxOpen = 64;
+
+        /**
+         * An open file, which is closed once the cache and every reader have let go of it
+         */
+        class Descriptor {
+            int fd;
+            uint64_t device;
+            uint64_t inode;
+
+        public:
+            Descriptor(int fd, uint64_t device, uint64_t inode) : fd(fd), device(device), inode(inode) {}
+
+            Descriptor(const Descriptor&) = delete;
+            Descriptor& operator=(const Descriptor&) = delete;
+
+            ~Descriptor();
+
+            /**
+             * Check if this is an open descriptor of the given file
+             * @param fileDevice The device the file is on
+             * @param fileInode The inode of the file
+             * @return True if it's the same file
+             */
+            [[nodiscard]] bool isFile(uint64_t fileDevice, uint64_t fileInode) const {
+                return device == fileDevice && inode == fileInode;
+            }
+
+            /**
+             * Read part of the file
+             * @param buffer The buffer to read into, which must be at least length bytes
+             * @param offset The position in the file to start reading from
+             * @param length The number of bytes to read
+             * @return True if every byte was read
+             */
+            bool read(char* buffer, uint64_t offset, uint64_t length) const;
+        };
+
+        /**
+         * How well the cache has been doing
+         */
+        struct Stats {
+            /** Reads that used a descriptor that was already open */
+            uint64_t hits = 0;
+            /** Reads that had to open the file */
+            uint64_t misses = 0;
+            /** Descriptors closed to stay under the limit */
+            uint64_t evictions = 0;
+            /** The number of descriptors currently kept */
+            size_t openCount = 0;
+
+            /**
+             * Get the share of reads that used an open descriptor
+             * @return The hit rate between 0 and 1, 0 if there haven't been any reads
+             */
+            [[nodiscard]] double getHitRate() const {
+                const uint64_t total = hits + misses;
+                return total == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(total);
+            }
+        };
+
+    private:
+        struct Entry {
+            const void* key;
+            std::shared_ptr<const Descriptor> descriptor;
+        };
+
+        /** The kept descriptors, most recently used first */
+        std::list<Entry> entries;
+        std::unordered_map<const void*, std::list<Entry>::iterator> lookup;
+        size_t maxOpen;
+
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+
+        mutable std::mutex mutex;
+
+        /**
+         * Stop keeping a descriptor
+         * <br>
+         * The mutex must be held when calling this
+         * @param key The file the descriptor belongs to
+         */
+        void remove(const void* key);
+
+    public:
+        /**
+         * Create a cache
+         * @param maxOpen The most files to keep open at once
+         */
+        explicit DvfsDescriptorCache(size_t maxOpen = defaultMaxOpen) : maxOpen(maxOpen == 0 ? 1 : maxOpen) {}
+
+        DvfsDescriptorCache(const DvfsDescriptorCache&) = delete;
+        DvfsDescriptorCache& operator=(const DvfsDescriptorCache&) = delete;
+
+        /**
+         * Get an open descriptor of a file, opening it if it isn't kept or the file at the path has changed
+         * @param key The file object the descriptor is kept for
+         * @param path The path to the file on disk
+         * @param size Set to the size of the file
+         * @return The descriptor, or nullptr if the file doesn't exist, is a directory or can't be opened
+         */
+        std::shared_ptr<const Descriptor> acquire(const void* key, const std::filesystem::path& path, uint64_t& size);
+
+        /**
+         * Stop keeping a file's descriptor, it's closed once any reads using it finish
+         * @param key The file object the descriptor is kept for
+         */
+        void evict(const void* key);
+
+        /**
+         * Stop keeping every descriptor
+         */
+        void clear();
+
+        /**
+         * Get how many reads have used open descriptors, and how many are open
+         * @return The stats
+         */
+        [[nodiscard]] Stats getStats() const;
+    };
+}
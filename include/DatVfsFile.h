@@ -1,9 +1,27 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <filesystem>
 
 namespace Dvfs {
+    class DvfsDescriptorCache;
+    class DvfsRangeRead;
+    class IDvfsExecutor;
+    class SlabLooseDvfsFile;
+
+    /**
+     * Where the content of a file is stored, so reads can be ordered to reduce seeking
+     */
+    struct DvfsFileLocation {
+        /** The device, archive or other store holding the content, 0 if unknown */
+        uint64_t volume = 0;
+        /** The position of the content in the volume, such as an archive offset or an inode number */
+        uint64_t offset = 0;
+
+        auto operator<=>(const DvfsFileLocation&) const = default;
+    };
+
     /**
      * An interface for files stored inside the VFS
      */
@@ -12,10 +30,16 @@ namespace Dvfs {
          * Reference counting for hard links
          * <br>
          * This value counts the number of times the DvfsFile is stored in a VFS. When it is 0, it means no VFS stores
-         * it and it can be removed (usually by the VFS that unmounted it).
+         * it and it can be removed (usually by the VFS that released the last reference). The count is atomic so the
+         * same file can be mounted in VFSs used from different threads.
          */
-        uint8_t references = 0;
+        std::atomic<uint32_t> references = 0;
     public:
+        IDvfsFile() = default;
+        // The reference count belongs to the file's place in VFSs, so it isn't copied with the content
+        IDvfsFile(const IDvfsFile&) : references(0) {}
+        IDvfsFile& operator=(const IDvfsFile&) { return *this; }
+
         virtual ~IDvfsFile() = default;
 
         /**
@@ -24,21 +48,25 @@ namespace Dvfs {
          * Warning, this function should only be used by the DatVFS, you probably shouldn't touch it
          * @return The new number of references that exist for this DvfsFile
          */
-        uint8_t incrementReferences();
+        uint32_t incrementReferences();
 
         /**
          * Decrement the number of references to this DvfsFile there are
          * <br>
          * Warning, this function should only be used by the DatVFS, you probably shouldn't touch it
-         * @return The new number of references that exist for this DvfsFile
+         * @return The new number of references that exist for this DvfsFile, when this is 0 the caller is responsible
+         * for the file
          */
-        uint8_t decrementReferences();
+        uint32_t decrementReferences();
 
         /**
          * Get the number of references to this DvfsFile there are
+         * <br>
+         * The count may be changed by other threads as soon as it's read, so it's only reliable while no other thread
+         * is mounting or unmounting the file
          * @return The current number of references that exist for this DvfsFile
          */
-        [[nodiscard]] uint8_t getReferenceCount() const;
+        [[nodiscard]] uint32_t getReferenceCount() const;
 
         /**
          * Get the size of the file
@@ -64,6 +92,58 @@ namespace Dvfs {
          * @return True if successful
          */
         virtual bool getContent(char* buffer) const = 0;
+
+        /**
+         * Get part of the content of the file and store it in the given buffer
+         * <br>
+         * The default implementation reads the whole file and copies the range out, files that can seek should
+         * override it
+         * @param buffer The buffer to store the range in, which must be at least length bytes
+         * @param offset The position in the file to start at
+         * @param length The number of bytes to get
+         * @return True if successful, false if the range goes past the end of the file
+         */
+        virtual bool getContentRange(char* buffer, uint64_t offset, uint64_t length) const;
+
+        /**
+         * Read part of the file asynchronously, for use with co_await
+         * <br>
+         * The read runs on the default executor, include DatVfsAsync.h to await it
+         * @param buffer The buffer to store the range in, which must be at least length bytes
+         * @param offset The position in the file to start at
+         * @param length The number of bytes to read
+         * @return An awaitable giving true if the read succeeded
+         */
+        DvfsRangeRead readRange(char* buffer, uint64_t offset, uint64_t length) const;
+
+        /**
+         * Read part of the file asynchronously on the given executor, for use with co_await
+         * @param buffer The buffer to store the range in, which must be at least length bytes
+         * @param offset The position in the file to start at
+         * @param length The number of bytes to read
+         * @param executor The executor to read on
+         * @return An awaitable giving true if the read succeeded
+         */
+        DvfsRangeRead readRange(char* buffer, uint64_t offset, uint64_t length, IDvfsExecutor& executor) const;
+
+        /**
+         * Hint that the content of the file will be needed soon, so it can be fetched ahead of time
+         * <br>
+         * This may block while the hint is issued, so it is usually called from a background thread. The default
+         * implementation does nothing.
+         */
+        virtual void prefetch() const {}
+
+        /**
+         * Get where the content of the file is stored, used to order queued reads so neighbouring files are read
+         * together
+         * <br>
+         * The default implementation returns an unknown location
+         * @return The location of the file's content
+         */
+        [[nodiscard]] virtual DvfsFileLocation getLocation() const {
+            return {};
+        }
     };
 
     /**
@@ -73,6 +153,73 @@ namespace Dvfs {
         /** The path to the file on disk */
         std::filesystem::path filePath;
 
+        /** Reads of at least this many bytes bypass the page cache, 0 to never bypass it */
+        static std::atomic<uint64_t> directReadThreshold;
+
+        /** The cache keeping loose files open between reads, nullptr to open them for every read */
+        static std::atomic<DvfsDescriptorCache*> descriptorCache;
+
+        /** The length to pass to readContent() to read to the end of the file */
+        static constexpr uint64_t wholeFile = UINT64_MAX;
+
+        // Slab files share the I/O below, without having to build a LooseDvfsFile for every call
+        friend class SlabLooseDvfsFile;
+
+        /**
+         * Get the size of a file on disk
+         * @param path The path to the file
+         * @return The size, or 0 if it isn't a valid file
+         */
+        [[nodiscard]] static uint64_t sizeAt(const std::filesystem::path& path);
+
+        /**
+         * Check there's a file that isn't a directory on disk
+         * @param path The path to the file
+         * @return True if the file exists
+         */
+        [[nodiscard]] static bool isValidAt(const std::filesystem::path& path);
+
+        /**
+         * Read part of a file on disk, through the descriptor cache or directly when they're enabled
+         * @param path The path to the file
+         * @param cacheKey The file object the descriptor cache keeps the file open for
+         * @param buffer The buffer to read into
+         * @param offset The position in the file to start reading from
+         * @param length The number of bytes to read, or wholeFile to read the whole file
+         * @return True if the read succeeded
+         */
+        static bool readAt(const std::filesystem::path& path, const void* cacheKey, char* buffer, uint64_t offset, uint64_t length);
+
+        /**
+         * Hint that a file on disk will be read soon
+         * @param path The path to the file
+         */
+        static void prefetchAt(const std::filesystem::path& path);
+
+        /**
+         * Get the device and inode of a file on disk
+         * @param path The path to the file
+         * @return The location of the file, or an unknown location if it can't be found
+         */
+        [[nodiscard]] static DvfsFileLocation locationAt(const std::filesystem::path& path);
+
+        /**
+         * Close the descriptor the descriptor cache keeps for a file object that's going away, rather than leaving it
+         * open until it's pushed out
+         * @param cacheKey The file object the descriptor cache keeps the file open for
+         */
+        static void forgetDescriptor(const void* cacheKey);
+
+        /**
+         * Read part of a file bypassing the page cache, through an aligned buffer when the destination isn't aligned
+         * @param path The path to the file
+         * @param buffer The buffer to read into
+         * @param offset The position in the file to start reading from
+         * @param length The number of bytes to read
+         * @return True if the read succeeded, false if it failed or the filesystem doesn't support direct reads
+         */
+        static bool readDirect(const std::filesystem::path& path, char* buffer, uint64_t offset, uint64_t length);
+
     public:
         /**
          * Create a LooseDvfsFile pointing to the file at the given path
@@ -80,6 +227,21 @@ namespace Dvfs {
          */
         LooseDvfsFile(std::filesystem::path  filePath) : filePath(std::move(filePath)) {} // NOLINT(google-explicit-constructor)
 
+        LooseDvfsFile(const LooseDvfsFile&) = default;
+
+        /**
+         * Closes the file's descriptor if the descriptor cache is keeping it open
+         */
+        ~LooseDvfsFile() override;
+
+        /**
+         * Get the path to the file on disk
+         * @return The path to the file
+         */
+        [[nodiscard]] const std::filesystem::path& getFilePath() const {
+            return filePath;
+        }
+
         /** @inherit */
         [[nodiscard]] uint64_t fileSize() const override;
 
@@ -88,5 +250,50 @@ namespace Dvfs {
 
         /** @inherit */
         bool getContent(char* buffer) const override;
+
+        /** @inherit */
+        bool getContentRange(char* buffer, uint64_t offset, uint64_t length) const override;
+
+        /** @inherit */
+        void prefetch() const override;
+
+        /**
+         * Get the device and inode of the file, which most filesystems allocate roughly in disk order
+         * @return The location of the file, or an unknown location if it can't be found
+         */
+        [[nodiscard]] DvfsFileLocation getLocation() const override;
+
+        /**
+         * Read files of at least the given size directly from the disk, bypassing the page cache
+         * <br>
+         * Large assets that are read once and then kept elsewhere only push more useful data out of the cache.
+         * Direct reads go straight into buffers from DvfsAlignedBufferPool, other buffers are filled through an
+         * aligned buffer from the default pool. Where the platform or filesystem doesn't support direct reads, files
+         * are read normally instead. This applies to every loose file in the process.
+         * @param bytes The smallest read to make directly, 0 to never read directly, which is the default
+         */
+        static void setDirectReadThreshold(uint64_t bytes);
+
+        /**
+         * Get the smallest read that bypasses the page cache
+         * @return The threshold in bytes, 0 if direct reads are off
+         */
+        [[nodiscard]] static uint64_t getDirectReadThreshold();
+
+        /**
+         * Keep loose files open between reads in the given cache
+         * <br>
+         * Both whole and ranged reads use the cache, except reads large enough to be read directly. This applies to
+         * every loose file in the process, and the cache must outlive any reads started while it's set. Loose files
+         * close their descriptors when they're destroyed, so the cache must be unset before it's destroyed.
+         * @param cache The cache to use, nullptr to open files for every read, which is the default
+         */
+        static void setDescriptorCache(DvfsDescriptorCache* cache);
+
+        /**
+         * Get the cache keeping loose files open between reads
+         * @return The cache, or nullptr if files are opened for every read
+         */
+        [[nodiscard]] static DvfsDescriptorCache* getDescriptorCache();
     };
 }
\ No newline at end of file
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <functional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "DatVfsFile.h"
+#include "DatVfsFileSlab.h"
 
 namespace Dvfs {
     /**
@@ -12,25 +15,61 @@ namespace Dvfs {
     struct IDvfsFileInserter {
         using pair = std::pair<std::string, IDvfsFile*>;
 
+        /**
+         * Called for each file an inserter yields, with the file's path relative to where it's being mounted
+         * <br>
+         * The path is only valid for the duration of the call. Return false to stop the inserter early.
+         */
+        using Visitor = std::function<bool(std::string_view path, IDvfsFile* idvfsFile)>;
+
+        virtual ~IDvfsFileInserter() = default;
+
         /**
          * Gets a vector containing all the Dvfs files, paired with their path, to insert into a VFS
+         * <br>
+         * The default implementation collects the files yielded by forEachFile. Inserters must override at least one
+         * of getAllFiles and forEachFile, one that overrides neither fails an assertion, or yields no files when
+         * assertions are disabled.
          * @return A vector of Dvfs files to be inserted into a VFS
          */
-        [[nodiscard]] virtual std::vector<pair> getAllFiles() const = 0;
+        [[nodiscard]] virtual std::vector<pair> getAllFiles() const;
+
+        /**
+         * Yield each Dvfs file to insert into a VFS, one at a time
+         * <br>
+         * This is what DatVFS::mountFiles uses, so inserters that override it can be mounted without holding every
+         * path and file in memory at once. The default implementation yields the files returned by getAllFiles.
+         * @param visitor The function to call with each file
+         */
+        virtual void forEachFile(const Visitor& visitor) const;
+
+        /**
+         * Get an estimate of how many files the inserter will yield, so space can be reserved ahead of time
+         * @return The estimated number of files, 0 if unknown
+         */
+        [[nodiscard]] virtual size_t getSizeHint() const;
 
         /**
          * Handle files that failed to be inserted into the VFS
+         * <br>
+         * No reference is taken on a file that fails to insert. By default the file is deleted if nothing else
+         * references it, and left alone if it is already mounted elsewhere.
          * @param path The path of the file
          * @param idvfsFile The file that failed to insert
          */
         virtual void handleInsertFailure(const std::string& path, IDvfsFile* idvfsFile) const;
     };
 
+    /**
+     * An inserter for every file in a directory on disk, and its subdirectories
+     * <br>
+     * The files are allocated together in a DvfsFileSlab, and only store their path relative to the directory
+     */
     struct DvfsLooseFileInserter : public IDvfsFileInserter {
         std::filesystem::path directory;
         DvfsLooseFileInserter(std::filesystem::path  directory) : directory(std::move(directory)) {}
 
         /** @inherit */
-        [[nodiscard]] std::vector<pair> getAllFiles() const override;
+        void forEachFile(const Visitor& visitor) const override;
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "DatVfsFile.h"
+
+namespace Dvfs {
+    class DvfsFileSlab;
+
+    /**
+     * A DvfsFile allocated from a DvfsFileSlab
+     * <br>
+     * Slab files are created with DvfsFileSlab::createFile, and are deleted like any other file. Deleting one only runs
+     * its destructor, the memory is given back when the slab is freed.
+     */
+    class SlabDvfsFile : public IDvfsFile {
+        /** The slab the file was allocated from */
+        DvfsFileSlab* slab;
+
+    protected:
+        explicit SlabDvfsFile(DvfsFileSlab& slab) : slab(&slab) {}
+
+    public:
+        /**
+         * Destroy the file and release it from its slab, instead of freeing the memory it lives in
+         */
+        void operator delete(SlabDvfsFile* file, std::destroying_delete_t);
+
+        /**
+         * Get the slab the file was allocated from
+         * @return The slab
+         */
+        [[nodiscard]] DvfsFileSlab& getSlab() const {
+            return *slab;
+        }
+    };
+
+    /**
+     * A bump allocator for the files of a single mount, freed in bulk rather than one file at a time
+     * <br>
+     * Inserters that create a lot of files can allocate them, and any strings they share, from a slab so each file
+     * costs a few tens of bytes instead of a separate heap allocation. The slab counts the files living in it, along
+     * with a reference for its creator, and frees itself once the creator has released it and every file is deleted.
+     * <br>
+     * Allocating from a slab isn't thread-safe, deleting its files is.
+     */
+    class DvfsFileSlab {
+        /** The size of each chunk, allocations larger than this get their own chunk */
+        size_t chunkSize;
+
+        std::vector<std::unique_ptr<std::byte[]>> chunks;
+        std::byte* current = nullptr;
+        size_t remaining = 0;
+        size_t memoryUsage = 0;
+
+        /** Twice the number of living files, plus one until the creator releases the slab */
+        std::atomic<size_t> references = 1;
+
+        explicit DvfsFileSlab(size_t chunkSize) : chunkSize(chunkSize) {}
+
+        /**
+         * Drop references to the slab, freeing it once there are none left
+         * @param count The amount to take off the reference count
+         */
+        void unreference(size_t count);
+
+        friend class SlabDvfsFile;
+
+    public:
+        DvfsFileSlab(const DvfsFileSlab&) = delete;
+        DvfsFileSlab& operator=(const DvfsFileSlab&) = delete;
+
+        /**
+         * Create an empty slab
+         * <br>
+         * The caller holds a reference to the slab until it calls release()
+         * @param chunkSize The number of bytes to reserve at a time
+         * @return The new slab
+         */
+        static DvfsFileSlab* create(size_t chunkSize = 64 * 1024);
+
+        /**
+         * Allocate raw memory from the slab, which lives until the slab is freed
+         * @param size The number of bytes to allocate
+         * @param alignment The alignment of the memory, must be a power of two
+         * @return The allocated memory
+         */
+        void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+        /**
+         * Copy a string into the slab, so files can share it without allocating their own copy
+         * @param string The string to copy
+         * @return A view of the copy, which lives until the slab is freed
+         */
+        std::string_view storeString(std::string_view string);
+
+        /**
+         * Create a file in the slab
+         * @tparam T The type of file, which takes the slab as its first constructor argument
+         * @param args The rest of the arguments to construct the file with
+         * @return The new file, which is deleted like any other file
+         */
+        template<std::derived_from<SlabDvfsFile> T, class... Args>
+        T* createFile(Args&&... args) {
+            void* memory = allocate(sizeof(T), alignof(T));
+            T* file = new(memory) T(*this, std::forward<Args>(args)...);
+            references.fetch_add(2, std::memory_order_relaxed);
+            return file;
+        }
+
+        /**
+         * Release the creator's reference to the slab, it is freed straight away if none of its files are alive
+         * <br>
+         * The slab can't be allocated from once it's released
+         */
+        void release();
+
+        /**
+         * Get the number of files in the slab that haven't been deleted
+         * @return The number of living files
+         */
+        [[nodiscard]] size_t getFileCount() const;
+
+        /**
+         * Get the number of bytes the slab has reserved from the heap
+         * @return The reserved size of the slab
+         */
+        [[nodiscard]] size_t getMemoryUsage() const;
+    };
+
+    /**
+     * A LooseDvfsFile allocated from a slab, which stores its path relative to a root shared by the whole mount
+     */
+    class SlabLooseDvfsFile : public SlabDvfsFile {
+        /** The directory the file was mounted from, stored once in the slab */
+        const std::string_view* root;
+        /** The path to the file from the root, stored in the slab */
+        std::string_view relativePath;
+
+    public:
+        /**
+         * Create a loose file in a slab
+         * @param slab The slab the file is allocated from
+         * @param root The directory the file is in, which must live in the slab
+         * @param relativePath The path from the root to the file, which is copied into the slab
+         */
+        SlabLooseDvfsFile(DvfsFileSlab& slab, const std::string_view* root, std::string_view relativePath)
+                : SlabDvfsFile(slab), root(root), relativePath(slab.storeString(relativePath)) {}
+
+        /**
+         * Closes the file's descriptor if the descriptor cache is keeping it open
+         */
+        ~SlabLooseDvfsFile() override;
+
+        /**
+         * Get the full path to the file on disk
+         * @return The root joined with the relative path
+         */
+        [[nodiscard]] std::filesystem::path getFilePath() const;
+
+        /** @inherit */
+        [[nodiscard]] uint64_t fileSize() const override;
+
+        /** @inherit */
+        [[nodiscard]] bool isValidFile() const override;
+
+        /** @inherit */
+        bool getContent(char* buffer) const override;
+
+        /** @inherit */
+        bool getContentRange(char* buffer, uint64_t offset, uint64_t length) const override;
+
+        /** @inherit */
+        void prefetch() const override;
+
+        /** @inherit */
+        [[nodiscard]] DvfsFileLocation getLocation() const override;
+    };
+}
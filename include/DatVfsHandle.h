@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "DatVfsFile.h"
+
+namespace Dvfs {
+    /**
+     * A compact reference to a file mounted in a DatVFS, that can be checked and resolved without a path lookup
+     * <br>
+     * A handle stops resolving once its file is no longer mounted anywhere in the VFS, even if the slot it pointed to
+     * has been reused, so handles can be cached safely
+     */
+    struct DvfsFileHandle {
+        /** The slot in the handle table */
+        uint32_t index = 0;
+        /** The generation of the slot the handle was created in, generation 0 is never used so is always invalid */
+        uint32_t generation = 0;
+
+        bool operator==(const DvfsFileHandle& rh) const = default;
+
+        /**
+         * Check if this is the null handle, which is returned when no file could be found
+         * @return True if the handle is null
+         */
+        [[nodiscard]] bool isNull() const {
+            return generation == 0;
+        }
+    };
+
+    /**
+     * The slots that file handles point into
+     * <br>
+     * The table is owned and kept up to date by the DatVFS, it doesn't own any of the files it references. Each file
+     * gets a single slot the first time a handle to it is requested, and the slot's generation is bumped when the
+     * file is released so existing handles stop resolving.
+     * <br>
+     * The table is thread-safe, handles are requested from const lookups that may run on many threads at once
+     */
+    class DvfsHandleTable {
+        struct Slot {
+            IDvfsFile* file = nullptr;
+            uint32_t generation = 1;
+            /** The next free slot, only used while this slot is free */
+            uint32_t nextFree = noSlot;
+        };
+
+        static constexpr uint32_t noSlot = UINT32_MAX;
+
+        mutable std::shared_mutex mutex;
+        std::vector<Slot> slots;
+        uint32_t freeHead = noSlot;
+
+        /** The slot of each file that has a handle */
+        std::unordered_map<const IDvfsFile*, uint32_t> fileSlots;
+
+    public:
+        /**
+         * Get a handle to a file, giving it a slot if it doesn't have one yet
+         * @param file The file to get a handle to
+         * @return The handle to the file
+         */
+        DvfsFileHandle acquire(IDvfsFile* file);
+
+        /**
+         * Invalidate every handle to a file, usually because it is no longer mounted
+         * @param file The file to release
+         */
+        void release(const IDvfsFile* file);
+
+        /**
+         * Get the file a handle refers to
+         * @param handle The handle to resolve
+         * @return The file, or nullptr if the handle is no longer valid
+         */
+        [[nodiscard]] IDvfsFile* resolve(DvfsFileHandle handle) const;
+
+        /**
+         * Get the number of files that currently have a slot
+         * @return The number of files with a slot
+         */
+        [[nodiscard]] size_t size() const;
+    };
+}
@@ -0,0 +1,261 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "DatPath.h"
+#include "DatVfsFile.h"
+
+namespace Dvfs {
+    class DatVFS;
+
+    /**
+     * A read-only snapshot of a DatVFS in a single flat buffer, which can be written to disk and mapped back in
+     * <br>
+     * The image only uses offsets, so it can be used straight from a memory mapping without being parsed. Each
+     * directory's entries are stored sorted by name and found with a binary search. Files are stored as a payload
+     * produced by an encoder when the image is built, and turned back into DvfsFiles by a decoder the first time
+     * they're looked up.
+     * <br>
+     * Lookups follow the same rules as the DatVFS the image was built from, including case-insensitivity.
+     */
+    class DvfsImage {
+    public:
+        /** Turn a file into the payload stored in the image */
+        using Encoder = std::function<std::string(const IDvfsFile& file)>;
+        /** Create a file from the payload stored in the image */
+        using Decoder = std::function<IDvfsFile*(std::string_view payload)>;
+
+        static constexpr uint32_t version = 1;
+
+    private:
+        struct Header {
+            char magic[8];
+            uint32_t version;
+            uint32_t caseInsensitive;
+            uint32_t directoryCount;
+            uint32_t directoryEntryCount;
+            uint32_t fileEntryCount;
+            uint32_t fileCount;
+            uint64_t directoriesOffset;
+            uint64_t directoryEntriesOffset;
+            uint64_t fileEntriesOffset;
+            uint64_t filesOffset;
+            uint64_t namesOffset;
+            uint64_t namesSize;
+            uint64_t payloadsOffset;
+            uint64_t payloadsSize;
+        };
+
+        /** The entries of a directory, which are stored next to each other */
+        struct Directory {
+            uint32_t firstDirectory;
+            uint32_t directoryCount;
+            uint32_t firstFile;
+            uint32_t fileCount;
+        };
+
+        /** A named entry in a directory, pointing to a directory or file record */
+        struct Entry {
+            uint32_t nameOffset;
+            uint32_t nameLength;
+            uint32_t target;
+        };
+
+        struct File {
+            uint64_t payloadOffset;
+            uint64_t payloadLength;
+        };
+
+        /** The image, when it isn't mapped */
+        std::vector<char> buffer;
+
+        /** The mapping of the image, when it is mapped */
+        void* mapping = nullptr;
+        size_t mappingSize = 0;
+
+        std::span<const char> image;
+        const Header* header = nullptr;
+        std::span<const Directory> directories;
+        std::span<const Entry> directoryEntries;
+        std::span<const Entry> fileEntries;
+        std::span<const File> files;
+        std::string_view names;
+        std::string_view payloads;
+
+        Decoder decoder;
+
+        /** The files decoded so far, created on first lookup */
+        std::unique_ptr<std::atomic<IDvfsFile*>[]> decoded;
+
+        DvfsImage() = default;
+
+        /**
+         * Check the image is well-formed, and set up the views into it
+         * @return True if the image can be used
+         */
+        bool attach(std::span<const char> data, Decoder imageDecoder);
+
+        /**
+         * Get the name of an entry
+         * @param entry The entry
+         * @return The name, empty if it doesn't fit in the image
+         */
+        [[nodiscard]] std::string_view getName(const Entry& entry) const;
+
+        /**
+         * Find an entry by name
+         * @param entries The sorted entries to search
+         * @param name The name to find
+         * @return The entry, or nullptr if there is none with the name
+         */
+        [[nodiscard]] const Entry* findEntry(std::span<const Entry> entries, std::string_view name) const;
+
+        /**
+         * Get the entries of a directory
+         * @param directory The directory
+         * @param fileEntries Whether to get the file entries instead of the directory entries
+         * @return The entries, empty if they don't fit in the image
+         */
+        [[nodiscard]] std::span<const Entry> getEntries(const Directory& directory, bool fileEntries) const;
+
+        /**
+         * Follow path sections from the root directory
+         * @param sections The sections of the path, which must all be directories
+         * @return The directory, or nullptr if it doesn't exist
+         */
+        [[nodiscard]] const Directory* findDirectory(std::span<const std::string_view> sections) const;
+
+        /**
+         * Split a path into the sections used to look it up
+         * @param path The path
+         * @return The sections of the path, or of the folded key if the image is case-insensitive
+         */
+        [[nodiscard]] std::vector<std::string_view> splitPath(const DatPath& path) const;
+
+        /**
+         * List the names of the entries in a directory
+         * @param path The path to the directory
+         * @param fileEntries Whether to list the files instead of the directories
+         * @return The names of the entries
+         */
+        [[nodiscard]] std::vector<std::string> list(const DatPath& path, bool fileEntries) const;
+
+    public:
+        DvfsImage(const DvfsImage&) = delete;
+        DvfsImage& operator=(const DvfsImage&) = delete;
+
+        ~DvfsImage();
+
+        /**
+         * Build an image of a VFS
+         * @param vfs The VFS to build an image of
+         * @param encoder Turns each file into the payload stored for it, files mounted at several paths are only
+         * encoded once
+         * @return The image, or an empty buffer if the VFS is too large to store in an image
+         */
+        static std::vector<char> build(const DatVFS& vfs, const Encoder& encoder = encodeLooseFile);
+
+        /**
+         * Build an image of a VFS and write it to disk
+         * @param vfs The VFS to build an image of
+         * @param path The path to write the image to
+         * @param encoder Turns each file into the payload stored for it
+         * @return True if the image was written
+         */
+        static bool write(const DatVFS& vfs, const std::filesystem::path& path, const Encoder& encoder = encodeLooseFile);
+
+        /**
+         * Map an image from disk
+         * <br>
+         * The file is memory mapped where the platform supports it, and read into memory otherwise
+         * @param path The path to the image
+         * @param decoder Creates the files stored in the image
+         * @return The image, or nullptr if it couldn't be read or isn't a valid image
+         */
+        static std::unique_ptr<DvfsImage> open(const std::filesystem::path& path, Decoder decoder = decodeLooseFile);
+
+        /**
+         * Use an image already in memory
+         * @param image The image, as created by build
+         * @param decoder Creates the files stored in the image
+         * @return The image, or nullptr if it isn't a valid image
+         */
+        static std::unique_ptr<DvfsImage> load(std::vector<char> image, Decoder decoder = decodeLooseFile);
+
+        /**
+         * Encode a loose file as its path on disk
+         * @param file The file, which must be a LooseDvfsFile or SlabLooseDvfsFile
+         * @return The path to the file, or an empty string for other kinds of file
+         */
+        static std::string encodeLooseFile(const IDvfsFile& file);
+
+        /**
+         * Decode a loose file from its path on disk
+         * @param payload The path to the file
+         * @return A new LooseDvfsFile
+         */
+        static IDvfsFile* decodeLooseFile(std::string_view payload);
+
+        /**
+         * Get a file in the image
+         * <br>
+         * The file is owned by the image, and is created the first time it's looked up
+         * @param path The path to the file
+         * @return A pointer to the file, or nullptr if the file doesn't exist
+         */
+        IDvfsFile* getFile(const DatPath& path) const;
+
+        /**
+         * Check if a file or directory exists
+         * @param path The path to the file or directory
+         * @return positive if a file, negative if a directory, 0 for doesn't exist
+         */
+        [[nodiscard]] int exists(const DatPath& path) const;
+
+        /**
+         * Get the names of all the files in a directory
+         * @param path The path to the directory to list (empty for the root)
+         * @return A vector containing the names of all the files at the path, sorted by name
+         */
+        [[nodiscard]] std::vector<std::string> listFiles(const DatPath& path = DatPath()) const;
+
+        /**
+         * Get the names of all the directories in a directory
+         * @param path The path to the directory to list (empty for the root)
+         * @return A vector containing the names of all the directories at the path, sorted by name
+         */
+        [[nodiscard]] std::vector<std::string> listDirectories(const DatPath& path = DatPath()) const;
+
+        /**
+         * Check if the image was built from a case-insensitive VFS
+         * @return True if lookups ignore ASCII case
+         */
+        [[nodiscard]] bool isCaseInsensitive() const;
+
+        /**
+         * Get the number of distinct files in the image, a file mounted at several paths is only counted once
+         * @return The number of files
+         */
+        [[nodiscard]] size_t getFileCount() const;
+
+        /**
+         * Get the number of directories in the image, including the root
+         * @return The number of directories
+         */
+        [[nodiscard]] size_t getDirectoryCount() const;
+
+        /**
+         * Check if the image is served from a memory mapping rather than a buffer
+         * @return True if the image is mapped
+         */
+        [[nodiscard]] bool isMapped() const;
+    };
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "DatVfsFile.h"
+
+namespace Dvfs {
+    class DatVFS;
+
+    /**
+     * A secondary index over the files mounted in a DatVFS, grouping them by file extension and by the tag they were
+     * mounted with
+     * <br>
+     * The index is kept up to date by the DatVFS that owns it, entries view the names stored in the VFS so they are
+     * only valid until the next modification of the VFS
+     */
+    class DvfsFileIndex {
+    public:
+        /**
+         * A file in the index
+         */
+        struct Entry {
+            /** The directory the file is mounted in */
+            const DatVFS* directory;
+            /** The name of the file inside the directory */
+            std::string_view name;
+            /** The mounted file */
+            IDvfsFile* file;
+        };
+
+    private:
+        struct StringHash {
+            using is_transparent = void;
+
+            size_t operator()(std::string_view string) const noexcept {
+                return std::hash<std::string_view>()(string);
+            }
+        };
+
+        using Bucket = std::vector<Entry>;
+        using BucketMap = std::unordered_map<std::string, Bucket, StringHash, std::equal_to<>>;
+
+        /**
+         * Where an entry is stored, so it can be removed without searching
+         */
+        struct Location {
+            Bucket* extensionBucket;
+            size_t extensionSlot;
+            /** nullptr if the file wasn't tagged */
+            Bucket* tagBucket;
+            size_t tagSlot;
+        };
+
+        BucketMap extensions;
+        BucketMap tags;
+
+        /** Entries keyed by the address of the name stored in the directory, which is unique for each mount */
+        std::unordered_map<const char*, Location> locations;
+
+        /**
+         * Remove the entry at the given slot of a bucket by swapping the last entry into its place
+         * @param bucket The bucket to remove from
+         * @param slot The slot to remove
+         * @param tagBucket Whether the bucket is a tag bucket rather than an extension bucket
+         */
+        void removeFromBucket(Bucket& bucket, size_t slot, bool tagBucket);
+
+        /**
+         * Find the entries stored in the bucket with the given key
+         * @param buckets The buckets to search
+         * @param key The key of the bucket
+         * @return A view of the entries, empty if there is no bucket
+         */
+        static std::span<const Entry> findBucket(const BucketMap& buckets, std::string_view key);
+
+    public:
+        /**
+         * Add a file to the index
+         * @param directory The directory the file is mounted in
+         * @param name The name of the file, this must be the name stored in the directory
+         * @param file The mounted file
+         * @param tag The tag the file was mounted with, empty for no tag
+         */
+        void insert(const DatVFS* directory, const std::string& name, IDvfsFile* file, std::string_view tag = {});
+
+        /**
+         * Remove a file from the index
+         * @param name The name of the file, this must be the name stored in the directory
+         * @return true if the file was in the index
+         */
+        bool erase(const std::string& name);
+
+        /**
+         * Change the file stored for an entry in the index
+         * @param name The name of the file, this must be the name stored in the directory
+         * @param file The file now mounted under the name
+         * @return true if the file was in the index
+         */
+        bool update(const std::string& name, IDvfsFile* file);
+
+        /**
+         * Point an entry at the name's new address, after the directory moved its names
+         * @param previous The address the name was stored at
+         * @param name The name, this must be the name now stored in the directory
+         * @return true if the file was in the index
+         */
+        bool rename(const char* previous, const std::string& name);
+
+        /**
+         * Remove every file from the index
+         */
+        void clear();
+
+        /**
+         * Reserve space for a number of files, so bulk mounts don't repeatedly grow the index
+         * @param count The total number of files to make space for
+         */
+        void reserve(size_t count);
+
+        /**
+         * Get the number of files in the index
+         * @return The number of files in the index
+         */
+        [[nodiscard]] size_t size() const;
+
+        /**
+         * Get all the files with the given extension
+         * @param extension The extension, without the leading '.'
+         * @return A view of the files, valid until the VFS is next modified
+         */
+        [[nodiscard]] std::span<const Entry> getByExtension(std::string_view extension) const;
+
+        /**
+         * Get all the files mounted with the given tag
+         * @param tag The tag
+         * @return A view of the files, valid until the VFS is next modified
+         */
+        [[nodiscard]] std::span<const Entry> getByTag(std::string_view tag) const;
+
+        /**
+         * Get the extension of a file name
+         * <br>
+         * Names with no '.', or where the only '.' is the first character, have no extension
+         * @param name The name of a file
+         * @return The extension, without the leading '.'
+         */
+        static std::string_view getExtension(std::string_view name);
+    };
+}
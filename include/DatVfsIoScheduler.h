@@ -0,0 +1,220 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "DatVfsFile.h"
+
+namespace Dvfs {
+    /**
+     * How urgently a read is needed, reads of a higher priority are always issued before those of a lower one
+     */
+    enum class DvfsIoPriority : uint8_t {
+        /** Reads that stall playback if they're late, such as streamed audio */
+        Critical,
+        /** Reads a caller is waiting on */
+        Normal,
+        /** Bulk loading that can happen whenever, which can be limited to a share of the bandwidth */
+        Background
+    };
+
+    /**
+     * Queues file reads and issues them on its own I/O threads in priority order
+     * <br>
+     * Queued reads of the same priority are issued in a sweep across their locations rather than the order they were
+     * queued in, so neighbouring files are read together. A read with a deadline jumps ahead of everything else,
+     * including the background bandwidth limit, once it has to start for it to finish by its deadline. How long a read
+     * takes is estimated from a fixed cost per read and a transfer rate, both measured from the reads issued so far.
+     * <br>
+     * Reads are issued with IDvfsFile::getContent, so files must stay alive and buffers must be at least
+     * IDvfsFile::fileSize() bytes until the read completes.
+     */
+    class DvfsIoScheduler {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        /**
+         * Called on an I/O thread once a read has finished
+         * <br>
+         * The parameter is whether the read succeeded. Reads still queued when the scheduler is destroyed are completed
+         * unsuccessfully on the destroying thread instead.
+         */
+        using Completion = std::function<void(bool)>;
+
+        /** The deadline of reads that don't have one */
+        static constexpr Clock::time_point noDeadline = Clock::time_point::max();
+
+    private:
+        static constexpr size_t priorityCount = 3;
+
+        struct Read {
+            const IDvfsFile* file;
+            char* buffer;
+            Completion completion;
+            DvfsIoPriority priority;
+            DvfsFileLocation location;
+            Clock::time_point deadline;
+            /** The time the read has to start by to meet its deadline */
+            Clock::time_point latestStart;
+            uint64_t size;
+        };
+
+        /** Queued reads by id, ids are handed out in order so they also break ties in queue order */
+        std::unordered_map<uint64_t, Read> reads;
+        /** The queued reads of each priority ordered by location */
+        std::set<std::pair<DvfsFileLocation, uint64_t>> sweeps[priorityCount];
+        /** The queued reads that have a deadline ordered by when they have to start */
+        std::set<std::pair<Clock::time_point, uint64_t>> deadlines;
+
+        /** Where each priority's sweep is up to */
+        DvfsFileLocation sweepPositions[priorityCount];
+
+        /** The bytes per second background reads are limited to, 0 for no limit */
+        uint64_t backgroundBandwidth = 0;
+        /** When the bandwidth used by the last background read has been paid back */
+        Clock::time_point backgroundReadyAt{};
+
+        /** Reads smaller than this measure the fixed cost of a read, larger ones measure the transfer rate */
+        static constexpr uint64_t rateSampleSize = 64 * 1024;
+        /** The estimated fixed cost of a read */
+        std::chrono::duration<double> readLatency{0};
+        /** The estimated time to transfer each byte */
+        double secondsPerByte = 0;
+
+        uint64_t nextId = 1;
+        size_t activeReads = 0;
+        bool paused = false;
+        bool stopping = false;
+
+        mutable std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable idle;
+        std::vector<std::thread> threads;
+
+        /**
+         * Take the next read to issue
+         * <br>
+         * The mutex must be held when calling this
+         * @param now The current time
+         * @param read Where to store the taken read
+         * @param retryAt Set to when a held back background read or a read with a deadline has to be issued
+         * @return True if a read was taken
+         */
+        bool take(Clock::time_point now, Read& read, Clock::time_point& retryAt);
+
+        /**
+         * Estimate how long a read will take
+         * <br>
+         * The mutex must be held when calling this
+         * @param size The size of the read
+         * @return The estimated time from issuing the read to it finishing
+         */
+        [[nodiscard]] Clock::duration estimateReadTime(uint64_t size) const;
+
+        /**
+         * Update the estimates with a read that has finished
+         * <br>
+         * The mutex must be held when calling this
+         * @param size The size of the read
+         * @param took How long the read took
+         */
+        void recordReadTime(uint64_t size, Clock::duration took);
+
+        /**
+         * Remove a queued read and return it
+         * <br>
+         * The mutex must be held when calling this
+         * @param id The id of the read
+         * @return The read
+         */
+        Read remove(uint64_t id);
+
+        /**
+         * The main loop of an I/O thread
+         */
+        void threadLoop();
+
+    public:
+        /**
+         * Create a scheduler
+         * @param threadCount The number of reads to have in flight at once, 1 keeps a spinning disk from seeking
+         * between reads
+         */
+        explicit DvfsIoScheduler(size_t threadCount = 1);
+
+        DvfsIoScheduler(const DvfsIoScheduler&) = delete;
+        DvfsIoScheduler& operator=(const DvfsIoScheduler&) = delete;
+
+        /**
+         * Waits for the reads in flight, and completes the queued reads unsuccessfully
+         */
+        ~DvfsIoScheduler();
+
+        /**
+         * Queue a read of a whole file
+         * @param file The file to read
+         * @param buffer The buffer to read into, which must be at least the size of the file
+         * @param completion Called on an I/O thread once the read has finished
+         * @param priority How urgently the read is needed
+         * @param deadline The time the read should be finished by. Once the estimated time to read the file no longer
+         * fits before it, the read is issued ahead of all others.
+         * @return The id of the read, which can be used to cancel it
+         */
+        uint64_t read(const IDvfsFile& file, char* buffer, Completion completion,
+                      DvfsIoPriority priority = DvfsIoPriority::Normal, Clock::time_point deadline = noDeadline);
+
+        /**
+         * Remove a read from the queue before it's issued, its completion isn't called
+         * @param id The id of the read
+         * @return True if the read was still queued
+         */
+        bool cancel(uint64_t id);
+
+        /**
+         * Limit how fast background reads are issued
+         * <br>
+         * Each background read holds back the next one by the time it would take to read at this rate, which keeps
+         * bulk loading from saturating the disk while more urgent reads are queued
+         * @param bytesPerSecond The limit, 0 for no limit
+         */
+        void setBackgroundBandwidth(uint64_t bytesPerSecond);
+
+        /**
+         * Set the estimates of how long reads take, which are otherwise only learned from the reads issued
+         * <br>
+         * Reads already queued keep the estimate they were queued with
+         * @param latency The fixed cost of each read
+         * @param bytesPerSecond The transfer rate, 0 to ignore the size of reads
+         */
+        void setReadTimeEstimate(Clock::duration latency, uint64_t bytesPerSecond);
+
+        /**
+         * Stop issuing reads, so reads can be queued up and issued in the scheduler's order
+         */
+        void pause();
+
+        /**
+         * Start issuing reads again after pause()
+         */
+        void resume();
+
+        /**
+         * Wait for every queued read to finish, the scheduler must not be paused
+         */
+        void waitForReads();
+
+        /**
+         * Get the number of reads waiting to be issued
+         * @return The number of queued reads
+         */
+        [[nodiscard]] size_t getQueuedCount() const;
+    };
+}
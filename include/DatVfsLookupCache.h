@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "DatVfsFile.h"
+
+namespace Dvfs {
+    class DatVFS;
+
+    /**
+     * A small cache of recently looked up paths, kept separately by every thread
+     * <br>
+     * Each thread has its own direct-mapped table, so lookups through the cache never contend with each other. Entries
+     * are stamped with the mutation epoch they were looked up in, and every change to any DatVFS bumps the epoch, so
+     * a change makes every thread's entries stale at once without tracking which of them it affected.
+     */
+    class DvfsLookupCache {
+        struct Entry {
+            const DatVFS* directory = nullptr;
+            /** The epoch the entry was looked up in, 0 is never current so is always stale */
+            uint64_t epoch = 0;
+            size_t hash = 0;
+            std::string path;
+            IDvfsFile* file = nullptr;
+        };
+
+        static std::atomic<uint64_t> epoch;
+
+        /**
+         * Hash a path a word at a time, entries are checked against the full path so this only has to be quick
+         */
+        static size_t hashPath(const std::string_view path) {
+            uint64_t hash = path.size() * 0x9e3779b97f4a7c15ull;
+            size_t i = 0;
+            for (; i + sizeof(uint64_t) <= path.size(); i += sizeof(uint64_t)) {
+                uint64_t word;
+                std::memcpy(&word, path.data() + i, sizeof(uint64_t));
+                hash = (hash ^ word) * 0xff51afd7ed558ccdull;
+                hash ^= hash >> 32;
+            }
+
+            uint64_t tail = 0;
+            std::memcpy(&tail, path.data() + i, path.size() - i);
+            hash = (hash ^ tail) * 0xff51afd7ed558ccdull;
+            return static_cast<size_t>(hash ^ (hash >> 32));
+        }
+
+        /**
+         * Get the entry of the calling thread's table that a hash maps to
+         */
+        static Entry& getEntry(size_t hash);
+
+    public:
+        /** The number of entries in each thread's table */
+        static constexpr size_t entryCount = 256;
+
+        /**
+         * Look up a path through the calling thread's cache
+         * <br>
+         * Misses are cached too, as they're just as likely to be repeated
+         * @param directory The directory the path is relative to
+         * @param path The normalised path
+         * @param resolve Looks up the path when it isn't cached, returning the file or nullptr
+         * @return The file at the path, or nullptr if there isn't one
+         */
+        template<typename F>
+        static IDvfsFile* lookup(const DatVFS* directory, const std::string_view path, F&& resolve) {
+            const uint64_t current = epoch.load(std::memory_order_acquire);
+            const size_t hash = hashPath(path);
+
+            Entry& entry = getEntry(hash);
+            if (entry.epoch == current && entry.hash == hash && entry.directory == directory && entry.path == path) {
+                return entry.file;
+            }
+
+            IDvfsFile* file = resolve();
+            entry.directory = directory;
+            entry.epoch = current;
+            entry.hash = hash;
+            entry.path.assign(path);
+            entry.file = file;
+            return file;
+        }
+
+        /**
+         * Make every thread's cached lookups stale, called whenever a DatVFS changes
+         */
+        static void invalidate() {
+            epoch.fetch_add(1, std::memory_order_release);
+        }
+
+        /**
+         * Get the current mutation epoch
+         * @return The epoch, which is bumped every time a DatVFS changes
+         */
+        static uint64_t getEpoch() {
+            return epoch.load(std::memory_order_acquire);
+        }
+    };
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "DatPath.h"
+#include "DatVfsFile.h"
+
+namespace Dvfs {
+    /**
+     * The expected size and content hash of every file in an install, to check the mounted files against
+     * <br>
+     * Paths are relative to the directory the manifest was created from or is verified against, and hashes are
+     * DvfsHasher hashes of the whole file. Manifests are stored as text, one file per line as the hash in hex, the
+     * size and the path separated by spaces.
+     */
+    class DvfsManifest {
+    public:
+        struct Entry {
+            std::string path;
+            uint64_t size;
+            uint64_t hash;
+        };
+
+    private:
+        std::vector<Entry> entries;
+        std::unordered_map<std::string, size_t> index;
+
+    public:
+        /**
+         * Add a file, replacing any file already at the path
+         * @param path The path to the file
+         * @param size The size of the file
+         * @param hash The hash of the file's content
+         */
+        void add(const std::string& path, uint64_t size, uint64_t hash);
+
+        /**
+         * Find a file
+         * @param path The path to the file
+         * @return The file, or nullptr if it isn't in the manifest
+         */
+        [[nodiscard]] const Entry* find(const std::string& path) const;
+
+        /**
+         * Get the number of files in the manifest
+         * @return The number of files
+         */
+        [[nodiscard]] size_t size() const {
+            return entries.size();
+        }
+
+        [[nodiscard]] std::vector<Entry>::const_iterator begin() const {
+            return entries.begin();
+        }
+
+        [[nodiscard]] std::vector<Entry>::const_iterator end() const {
+            return entries.end();
+        }
+
+        /**
+         * Write the manifest as text
+         * @param stream The stream to write to
+         * @return True if the manifest was written
+         */
+        bool write(std::ostream& stream) const;
+
+        /**
+         * Read a manifest written by write(), replacing the current files
+         * @param stream The stream to read from
+         * @return True if the manifest was read, false if the stream couldn't be read or a line is malformed
+         */
+        bool read(std::istream& stream);
+
+        /**
+         * Write the manifest to a file
+         * @param path The path to the file on disk
+         * @return True if the manifest was written
+         */
+        bool save(const std::filesystem::path& path) const;
+
+        /**
+         * Read a manifest from a file, replacing the current files
+         * @param path The path to the file on disk
+         * @return True if the manifest was read
+         */
+        bool load(const std::filesystem::path& path);
+
+        /**
+         * Hash the whole of a file
+         * <br>
+         * Large files are read in pieces with ranged reads into pooled buffers, so hashing never holds more than a
+         * piece of each file in memory
+         * @param file The file to hash
+         * @param hash Set to the hash of the file's content
+         * @return True if the file could be read
+         */
+        static bool hashFile(const IDvfsFile& file, uint64_t& hash);
+    };
+
+    /**
+     * A file that didn't match the manifest it was verified against
+     */
+    struct DvfsVerifyMismatch {
+        enum class Problem : uint8_t {
+            /** The manifest lists the file but it isn't mounted */
+            Missing,
+            /** The file is mounted but the manifest doesn't list it */
+            Unlisted,
+            /** The file's size differs from the manifest, its content isn't hashed */
+            SizeMismatch,
+            /** The file's content differs from the manifest */
+            HashMismatch,
+            /** The file couldn't be read */
+            ReadFailed
+        };
+
+        std::string path;
+        Problem problem;
+    };
+
+    /**
+     * The outcome of verifying files against a manifest
+     */
+    struct DvfsVerifyResult {
+        /** Every file that didn't match, sorted by path */
+        std::vector<DvfsVerifyMismatch> mismatches;
+        /** The number of mounted files checked against the manifest */
+        uint64_t filesChecked = 0;
+        /** The number of bytes read and hashed */
+        uint64_t bytesHashed = 0;
+
+        /**
+         * Check if every file matched
+         * @return True if there were no mismatches
+         */
+        [[nodiscard]] bool isValid() const {
+            return mismatches.empty();
+        }
+    };
+
+    /**
+     * Checks files against a manifest from many threads at once, used by DatVFS::verifyParallel
+     */
+    class DvfsManifestVerifier {
+        const DvfsManifest& manifest;
+        /** Whether a mounted file was found for each manifest entry, each is only written by the thread that found it */
+        std::vector<char> found;
+
+        std::vector<DvfsVerifyMismatch> mismatches;
+        std::mutex mismatchesMutex;
+
+        std::atomic<uint64_t> filesChecked = 0;
+        std::atomic<uint64_t> bytesHashed = 0;
+
+        void report(std::string path, DvfsVerifyMismatch::Problem problem);
+
+    public:
+        explicit DvfsManifestVerifier(const DvfsManifest& manifest) : manifest(manifest), found(manifest.size(), 0) {}
+
+        /**
+         * Check a mounted file against the manifest
+         * @param directory The path of the directory holding the file, relative to where verification started
+         * @param name The name of the file
+         * @param file The file
+         * @param selected Whether the file is being verified, files that aren't are only marked as found
+         */
+        void check(const DatPath& directory, const std::string& name, const IDvfsFile& file, bool selected);
+
+        /**
+         * Report the manifest's files that weren't found and collect the result
+         * @param recursive Whether subdirectories were checked, when they weren't, their files aren't reported missing
+         * @return The result
+         */
+        DvfsVerifyResult finish(bool recursive);
+    };
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace Dvfs {
+    class DatVFS;
+
+    /**
+     * The set of files mounted by a single call to DatVFS::mountFiles, which can be unmounted together
+     */
+    struct DvfsMountGroup {
+        /** The id of the group, 0 is never used so is always invalid */
+        uint32_t id = 0;
+        /** The number of files mounted into the group */
+        int fileCount = 0;
+
+        /**
+         * Check if this is the null group, which is returned when no files could be mounted
+         * @return True if the group is null
+         */
+        [[nodiscard]] bool isNull() const {
+            return id == 0;
+        }
+    };
+
+    /**
+     * The mount groups of a DatVFS, and which group each grouped file belongs to
+     * <br>
+     * The groups are owned and kept up to date by the DatVFS, entries are keyed by the address of the name stored in
+     * the directory like DvfsFileIndex. Each group threads a list through its entries, so a group can be gathered
+     * without searching the VFS and a single entry can be forgotten without searching its group.
+     */
+    class DvfsMountGroups {
+    public:
+        /**
+         * A file mounted in a group
+         */
+        struct Entry {
+            /** The directory the file is mounted in */
+            DatVFS* directory;
+            /** The name of the file inside the directory */
+            const std::string* name;
+        };
+
+    private:
+        struct Link {
+            DatVFS* directory;
+            const std::string* name;
+            uint32_t group;
+            /** The neighbouring entries of the group, nullptr at either end */
+            const char* previous;
+            const char* next;
+        };
+
+        std::unordered_map<const char*, Link> entries;
+
+        /** The first entry of each group with entries */
+        std::unordered_map<uint32_t, const char*> heads;
+
+        uint32_t nextId = 1;
+
+    public:
+        /**
+         * Get an id for a new group
+         * <br>
+         * Ids are never reused, so a stale id can't unmount another group's files. A group only exists once it has
+         * an entry.
+         * @return The id of the group
+         */
+        uint32_t create();
+
+        /**
+         * Add a file to a group
+         * @param group The id of the group
+         * @param directory The directory the file is mounted in
+         * @param name The name of the file, this must be the name stored in the directory
+         */
+        void add(uint32_t group, DatVFS* directory, const std::string& name);
+
+        /**
+         * Remove a file from whichever group it is in, usually because it is being unmounted
+         * @param name The name of the file, this must be the name stored in the directory
+         * @return true if the file was in a group
+         */
+        bool forget(const std::string& name);
+
+        /**
+         * Point an entry at the name's new address, after the directory moved its names
+         * @param previous The address the name was stored at
+         * @param name The name, this must be the name now stored in the directory
+         * @return true if the file was in a group
+         */
+        bool rename(const char* previous, const std::string& name);
+
+        /**
+         * Get the most recently added file still in a group
+         * @param group The id of the group
+         * @return The file, or an entry with no directory or name if the group doesn't exist
+         */
+        [[nodiscard]] Entry front(uint32_t group) const;
+
+        /**
+         * Check if a group still has files in it
+         * @param group The id of the group
+         * @return True if the group exists
+         */
+        [[nodiscard]] bool contains(uint32_t group) const;
+
+        /**
+         * Get the number of grouped files across all groups
+         * @return The number of grouped files
+         */
+        [[nodiscard]] size_t size() const;
+
+        /**
+         * Reserve space for a number of grouped files, so bulk mounts don't repeatedly grow the table
+         * @param count The total number of files to make space for
+         */
+        void reserve(size_t count);
+    };
+}
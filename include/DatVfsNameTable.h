@@ -0,0 +1,387 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "DatPathLiteral.h"
+
+namespace Dvfs {
+    /**
+     * Hashes names so tables can be searched by string_view without allocating a key, or by a HashedName without
+     * hashing at all
+     */
+    struct DvfsNameHash {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view name) const noexcept {
+            return HashedName::hashName(name);
+        }
+
+        size_t operator()(const HashedName& name) const noexcept {
+            return name.hash;
+        }
+    };
+
+    /**
+     * The names stored in a directory of a DatVFS, mapped to the files or directories they refer to
+     * <br>
+     * Tables start out as a hash map that can be changed freely. Once the contents of a table stop changing it can be
+     * frozen into a minimal perfect hash table, which stores the entries contiguously in a single array with no empty
+     * slots, alongside a one byte fingerprint of each name so most misses don't compare strings. Frozen tables must be
+     * thawed back into a hash map before they're changed.
+     * <br>
+     * Freezing and thawing move the names, so anything holding the address of a name has to be told where it moved
+     * to, which is what the callback passed to freeze and thaw is for.
+     * @tparam T The type of value stored for each name
+     */
+    template<typename T>
+    class DvfsNameTable {
+    public:
+        using Entry = std::pair<const std::string, T>;
+        using value_type = Entry;
+
+    private:
+        using Map = std::unordered_map<std::string, T, DvfsNameHash, std::equal_to<>>;
+
+        /** The entries while the table isn't frozen */
+        Map map;
+
+        /** The entries while the table is frozen, each in the slot its name hashes to */
+        std::vector<Entry> slots;
+        /** A byte of the hash of the name in each slot */
+        std::vector<uint8_t> fingerprints;
+        /** The seed that places each bucket of names into free slots */
+        std::vector<uint32_t> seeds;
+        bool frozen = false;
+
+        /** Buckets are small, so finding seeds for the last buckets doesn't take long */
+        static constexpr size_t namesPerBucket = 3;
+
+        /**
+         * Map a 32-bit value onto [0, range) without dividing
+         */
+        static uint32_t reduce(uint32_t value, size_t range) {
+            return static_cast<uint32_t>((static_cast<uint64_t>(value) * range) >> 32);
+        }
+
+        /**
+         * Spread a name's hash across all 64 bits, names that only differ at the end barely change the top bits of
+         * their hashes otherwise
+         */
+        static uint64_t mix(uint64_t hash) {
+            hash ^= hash >> 33;
+            hash *= 0xff51afd7ed558ccdull;
+            hash ^= hash >> 33;
+            hash *= 0xc4ceb9fe1a85ec53ull;
+            hash ^= hash >> 33;
+            return hash;
+        }
+
+        [[nodiscard]] uint32_t bucketOf(uint64_t hash) const {
+            return reduce(static_cast<uint32_t>(hash >> 32), seeds.size());
+        }
+
+        /**
+         * Get the slot a hash is placed in by a bucket's seed
+         */
+        static uint32_t slotOf(uint64_t hash, uint32_t seed, size_t slotCount) {
+            uint64_t mixed = hash ^ (seed * 0x9e3779b97f4a7c15ull);
+            mixed ^= mixed >> 33;
+            mixed *= 0xff51afd7ed558ccdull;
+            mixed ^= mixed >> 33;
+            return reduce(static_cast<uint32_t>(mixed), slotCount);
+        }
+
+        static uint8_t fingerprintOf(uint64_t hash) {
+            return static_cast<uint8_t>(hash);
+        }
+
+        static std::string_view nameOf(std::string_view name) {
+            return name;
+        }
+
+        static std::string_view nameOf(const HashedName& name) {
+            return name.name;
+        }
+
+        /**
+         * Find the slot of a name in a frozen table
+         * @return The slot, or the number of slots if the name isn't in the table
+         */
+        template<typename K>
+        [[nodiscard]] size_t findSlot(const K& key) const {
+            if (slots.empty()) return 0;
+
+            const uint64_t hash = mix(DvfsNameHash()(key));
+            const size_t slot = slotOf(hash, seeds[bucketOf(hash)], slots.size());
+            if (fingerprints[slot] != fingerprintOf(hash) || slots[slot].first != nameOf(key)) return slots.size();
+            return slot;
+        }
+
+        template<bool Const>
+        class Iterator {
+            using MapIterator = std::conditional_t<Const, typename Map::const_iterator, typename Map::iterator>;
+            using Slot = std::conditional_t<Const, const Entry*, Entry*>;
+
+            MapIterator mapIterator{};
+            Slot slot = nullptr;
+            bool frozen = false;
+
+            friend class DvfsNameTable;
+
+            template<bool>
+            friend class Iterator;
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = Entry;
+            using pointer = Slot;
+            using reference = std::conditional_t<Const, const Entry&, Entry&>;
+
+            Iterator() = default;
+            explicit Iterator(MapIterator mapIterator) : mapIterator(mapIterator) {}
+            explicit Iterator(Slot slot) : slot(slot), frozen(true) {}
+
+            // Iterators can always become const iterators
+            template<bool OtherConst> requires (Const && !OtherConst)
+            Iterator(const Iterator<OtherConst>& other) // NOLINT(google-explicit-constructor)
+                    : mapIterator(other.mapIterator), slot(other.slot), frozen(other.frozen) {}
+
+            reference operator*() const {
+                return frozen ? *slot : *mapIterator;
+            }
+
+            pointer operator->() const {
+                return &**this;
+            }
+
+            Iterator& operator++() {
+                if (frozen) ++slot;
+                else ++mapIterator;
+                return *this;
+            }
+
+            Iterator operator++(int) {
+                Iterator previous = *this;
+                ++*this;
+                return previous;
+            }
+
+            bool operator==(const Iterator& rh) const {
+                return frozen ? slot == rh.slot : mapIterator == rh.mapIterator;
+            }
+        };
+
+    public:
+        using iterator = Iterator<false>;
+        using const_iterator = Iterator<true>;
+
+        iterator begin() {
+            return frozen ? iterator(slots.data()) : iterator(map.begin());
+        }
+
+        iterator end() {
+            return frozen ? iterator(slots.data() + slots.size()) : iterator(map.end());
+        }
+
+        const_iterator begin() const {
+            return frozen ? const_iterator(slots.data()) : const_iterator(map.begin());
+        }
+
+        const_iterator end() const {
+            return frozen ? const_iterator(slots.data() + slots.size()) : const_iterator(map.end());
+        }
+
+        /**
+         * Find an entry
+         * @param key The name, or the name with its hash
+         * @return An iterator to the entry, or end() if there isn't one
+         */
+        template<typename K>
+        iterator find(const K& key) {
+            if (frozen) return iterator(slots.data() + findSlot(key));
+            return iterator(map.find(key));
+        }
+
+        template<typename K>
+        const_iterator find(const K& key) const {
+            if (frozen) return const_iterator(slots.data() + findSlot(key));
+            return const_iterator(map.find(key));
+        }
+
+        template<typename K>
+        [[nodiscard]] bool contains(const K& key) const {
+            return find(key) != end();
+        }
+
+        template<typename K>
+        [[nodiscard]] size_t count(const K& key) const {
+            return contains(key) ? 1 : 0;
+        }
+
+        [[nodiscard]] size_t size() const {
+            return frozen ? slots.size() : map.size();
+        }
+
+        [[nodiscard]] bool empty() const {
+            return size() == 0;
+        }
+
+        /**
+         * Add an entry, the table must not be frozen
+         * @return An iterator to the entry with the name, and whether it was added
+         */
+        template<typename K>
+        std::pair<iterator, bool> emplace(const K& key, T value) {
+            auto [it, inserted] = map.emplace(key, std::move(value));
+            return {iterator(it), inserted};
+        }
+
+        /**
+         * Remove an entry, the table must not be frozen
+         * @return An iterator to the entry after the removed one
+         */
+        iterator erase(iterator it) {
+            return iterator(map.erase(it.mapIterator));
+        }
+
+        /**
+         * Remove every entry, thawing the table if it's frozen
+         */
+        void clear() {
+            map.clear();
+            std::vector<Entry>().swap(slots);
+            std::vector<uint8_t>().swap(fingerprints);
+            std::vector<uint32_t>().swap(seeds);
+            frozen = false;
+        }
+
+        /**
+         * Check if the table is frozen
+         * @return True if the table is a minimal perfect hash table
+         */
+        [[nodiscard]] bool isFrozen() const {
+            return frozen;
+        }
+
+        /**
+         * Rebuild the table as a minimal perfect hash table
+         * <br>
+         * This gives up if two names have the same 64-bit hash, which leaves the table as it was
+         * @param moved Called with the previous address of each name and the entry it was moved to
+         * @return True if the table is frozen
+         */
+        template<typename F>
+        bool freeze(F&& moved) {
+            if (frozen) return true;
+
+            const size_t count = map.size();
+            std::vector<typename Map::iterator> entries;
+            std::vector<uint64_t> hashes;
+            entries.reserve(count);
+            hashes.reserve(count);
+            for (auto it = map.begin(); it != map.end(); ++it) {
+                entries.push_back(it);
+                hashes.push_back(mix(DvfsNameHash()(std::string_view(it->first))));
+            }
+
+            seeds.assign(std::max<size_t>(1, (count + namesPerBucket - 1) / namesPerBucket), 0);
+
+            // Sort the names by bucket, placing the biggest buckets first while the most slots are free
+            std::vector<uint32_t> bucketSizes(seeds.size());
+            for (const uint64_t hash: hashes) ++bucketSizes[bucketOf(hash)];
+
+            std::vector<uint32_t> order(count);
+            std::iota(order.begin(), order.end(), 0);
+            std::ranges::sort(order, [&](uint32_t lh, uint32_t rh) {
+                const uint32_t lhBucket = bucketOf(hashes[lh]), rhBucket = bucketOf(hashes[rh]);
+                if (bucketSizes[lhBucket] != bucketSizes[rhBucket]) return bucketSizes[lhBucket] > bucketSizes[rhBucket];
+                return lhBucket < rhBucket;
+            });
+
+            // The entry placed in each slot
+            std::vector<uint32_t> slotEntries(count, UINT32_MAX);
+            std::vector<uint32_t> bucketSlots;
+
+            for (size_t start = 0; start < count;) {
+                const uint32_t bucket = bucketOf(hashes[order[start]]);
+                const size_t end = start + bucketSizes[bucket];
+
+                // Names with the same hash can never be placed in different slots
+                for (size_t i = start; i < end; ++i) {
+                    for (size_t j = start; j < i; ++j) {
+                        if (hashes[order[i]] == hashes[order[j]]) {
+                            seeds.clear();
+                            return false;
+                        }
+                    }
+                }
+
+                for (uint32_t seed = 0;; ++seed) {
+                    bucketSlots.clear();
+                    bool placed = true;
+                    for (size_t i = start; i < end && placed; ++i) {
+                        const uint32_t slot = slotOf(hashes[order[i]], seed, count);
+                        placed = slotEntries[slot] == UINT32_MAX && std::ranges::find(bucketSlots, slot) == bucketSlots.end();
+                        bucketSlots.push_back(slot);
+                    }
+                    if (!placed) continue;
+
+                    for (size_t i = start; i < end; ++i) {
+                        slotEntries[bucketSlots[i - start]] = order[i];
+                    }
+                    seeds[bucket] = seed;
+                    break;
+                }
+
+                start = end;
+            }
+
+            slots.reserve(count);
+            fingerprints.resize(count);
+            for (size_t slot = 0; slot < count; ++slot) {
+                const uint32_t entry = slotEntries[slot];
+                auto node = map.extract(entries[entry]);
+
+                const char* previous = node.key().data();
+                slots.emplace_back(std::move(node.key()), std::move(node.mapped()));
+                fingerprints[slot] = fingerprintOf(hashes[entry]);
+                moved(previous, slots.back());
+            }
+
+            // Give back the buckets too
+            Map().swap(map);
+            frozen = true;
+            return true;
+        }
+
+        /**
+         * Rebuild the table as a hash map so it can be changed
+         * @param moved Called with the previous address of each name and the entry it was moved to
+         */
+        template<typename F>
+        void thaw(F&& moved) {
+            if (!frozen) return;
+
+            map.reserve(slots.size());
+            for (Entry& slot: slots) {
+                auto [it, inserted] = map.emplace(slot.first, std::move(slot.second));
+                moved(slot.first.data(), *it);
+            }
+
+            std::vector<Entry>().swap(slots);
+            std::vector<uint8_t>().swap(fingerprints);
+            std::vector<uint32_t>().swap(seeds);
+            frozen = false;
+        }
+    };
+}
@@ -0,0 +1,282 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "DatPath.h"
+#include "DatVfsFile.h"
+#include "DatVfsMountGroup.h"
+
+namespace Dvfs {
+    class DatVFS;
+
+    /**
+     * An incremental update to a set of files, carrying only the files that changed
+     * <br>
+     * Each file in a pack is either stored whole, stored as a binary delta against the file it replaces, or marked as
+     * removed. Mounting a pack only reads its index, and swaps the changed files into the VFS in place of the ones
+     * they replace. Whole files are read straight out of the pack, and deltas are applied the first time the file is
+     * read, then kept in memory.
+     * <br>
+     * Packs are built from two VFSs, the files before the update and after it, and are stored in one file with the
+     * index at the start.
+     */
+    class DvfsPatchPack {
+    public:
+        static constexpr uint32_t version = 2;
+
+        /**
+         * How a file is stored in a pack
+         */
+        enum class Kind : uint32_t {
+            /** The whole file is stored in the pack */
+            Full,
+            /** A delta against the file at the same path is stored in the pack */
+            Delta,
+            /** The file is removed by the update */
+            Removed
+        };
+
+        /**
+         * A file in a pack
+         */
+        struct Entry {
+            std::string path;
+            Kind kind;
+            /** Where the stored data starts, relative to the start of the pack */
+            uint64_t dataOffset;
+            uint64_t dataLength;
+            /** The size of the file after the update */
+            uint64_t size;
+            /** The DvfsHasher hash of the file after the update */
+            uint64_t hash;
+            /** The size of the file a delta was made against, zero for other kinds */
+            uint64_t baseSize;
+            /** The DvfsHasher hash of the file a delta was made against, zero for other kinds */
+            uint64_t baseHash;
+        };
+
+    private:
+        struct Header {
+            char magic[8];
+            uint32_t version;
+            uint32_t entryCount;
+            uint64_t entriesOffset;
+            uint64_t namesOffset;
+            uint64_t namesSize;
+            uint64_t dataOffset;
+            uint64_t dataSize;
+        };
+
+        struct StoredEntry {
+            uint32_t nameOffset;
+            uint32_t nameLength;
+            uint32_t kind;
+            uint32_t reserved;
+            uint64_t dataOffset;
+            uint64_t dataLength;
+            uint64_t size;
+            uint64_t hash;
+            uint64_t baseSize;
+            uint64_t baseHash;
+        };
+
+        /** Where the pack is read from, shared with the files mounted from it */
+        std::shared_ptr<const IDvfsFile> source;
+        std::vector<Entry> entries;
+
+        DvfsPatchPack() = default;
+
+        /**
+         * Read and check the index of a pack
+         * @param packSource Where the pack is read from
+         * @return The pack, or nullptr if it isn't a valid pack
+         */
+        static std::unique_ptr<DvfsPatchPack> attach(std::shared_ptr<const IDvfsFile> packSource);
+
+    public:
+        /**
+         * Build a pack that updates the files of one VFS to the files of another
+         * <br>
+         * Files that are the same in both are left out. Changed files are stored as a delta when that's smaller
+         * than the whole file.
+         * @param base The files before the update
+         * @param target The files after the update
+         * @return The pack
+         */
+        static std::vector<char> build(const DatVFS& base, const DatVFS& target);
+
+        /**
+         * Build a pack and write it to disk
+         * @param base The files before the update
+         * @param target The files after the update
+         * @param path The path to write the pack to
+         * @return True if the pack was written
+         */
+        static bool write(const DatVFS& base, const DatVFS& target, const std::filesystem::path& path);
+
+        /**
+         * Open a pack on disk, reading only its index
+         * @param path The path to the pack
+         * @return The pack, or nullptr if it couldn't be read or isn't a valid pack
+         */
+        static std::unique_ptr<DvfsPatchPack> open(const std::filesystem::path& path);
+
+        /**
+         * Use a pack already in memory
+         * @param pack The pack, as created by build
+         * @return The pack, or nullptr if it isn't a valid pack
+         */
+        static std::unique_ptr<DvfsPatchPack> load(std::vector<char> pack);
+
+        /**
+         * Get the files in the pack
+         * @return The files, sorted by path
+         */
+        [[nodiscard]] const std::vector<Entry>& getEntries() const {
+            return entries;
+        }
+
+        /**
+         * Apply the pack to the files mounted in a directory
+         * <br>
+         * Removed files are unmounted, and changed files replace the files at their paths. A delta keeps the file it
+         * replaces alive until the delta is deleted, so it can still be read from when the delta is applied. Deltas
+         * whose file isn't mounted, or isn't the size of the file they were made against, are skipped. The pack can be
+         * destroyed once it's mounted.
+         * <br>
+         * The pack is applied whole or not at all. If any of its files can't be mounted, the files it replaced are
+         * mounted again, though without the tag or group they were mounted with.
+         * @param vfs The VFS to apply the pack to
+         * @param path The directory the pack's paths are relative to, empty for the root
+         * @return The group of files mounted from the pack, which only holds the changed files, or an empty group if the
+         * pack couldn't be applied
+         */
+        DvfsMountGroup mount(DatVFS& vfs, const DatPath& path = DatPath()) const;
+
+        /**
+         * Create a delta that turns one buffer into another
+         * <br>
+         * The delta is a sequence of copies from the base and runs of new bytes. Matching runs are found by hashing
+         * blocks of the base, so content that moved is still copied rather than stored again.
+         * @param base The content before
+         * @param baseSize The size of the content before
+         * @param target The content after
+         * @param targetSize The size of the content after
+         * @return The delta
+         */
+        static std::vector<char> createDelta(const char* base, uint64_t baseSize, const char* target, uint64_t targetSize);
+
+        /**
+         * Apply a delta from createDelta
+         * @param base The content the delta was created against
+         * @param baseSize The size of the base
+         * @param delta The delta
+         * @param deltaSize The size of the delta
+         * @param output The buffer to write the result to
+         * @param outputSize The size of the result
+         * @return True if the delta was applied, false if it's malformed or doesn't fit the base or output
+         */
+        static bool applyDelta(const char* base, uint64_t baseSize, const char* delta, uint64_t deltaSize, char* output, uint64_t outputSize);
+    };
+
+    /**
+     * A file stored whole in a patch pack
+     */
+    class DvfsPatchFile : public IDvfsFile {
+        std::shared_ptr<const IDvfsFile> source;
+        uint64_t offset;
+        uint64_t size;
+
+    public:
+        /**
+         * Create a file stored in a pack
+         * @param source Where the pack is read from
+         * @param offset Where the file starts in the pack
+         * @param size The size of the file
+         */
+        DvfsPatchFile(std::shared_ptr<const IDvfsFile> source, uint64_t offset, uint64_t size)
+                : source(std::move(source)), offset(offset), size(size) {}
+
+        /** @inherit */
+        [[nodiscard]] uint64_t fileSize() const override;
+
+        /** @inherit */
+        [[nodiscard]] bool isValidFile() const override;
+
+        /** @inherit */
+        bool getContent(char* buffer) const override;
+
+        /** @inherit */
+        bool getContentRange(char* buffer, uint64_t offset, uint64_t length) const override;
+    };
+
+    /**
+     * A file stored as a delta in a patch pack, applied to the file it replaces the first time it's read
+     */
+    class DvfsPatchDeltaFile : public IDvfsFile {
+        std::shared_ptr<const IDvfsFile> source;
+        /** The VFS the base was mounted in, which the reference to the base is given back to */
+        DatVFS* vfs;
+        /** The file the delta is applied to, which this holds a reference to */
+        IDvfsFile* base;
+        uint64_t baseHash;
+        uint64_t offset;
+        uint64_t length;
+        uint64_t size;
+        uint64_t hash;
+
+        /** Whether the delta has been applied, a failed application is tried again on the next read */
+        mutable std::atomic<bool> applied = false;
+        mutable std::mutex mutex;
+        /** The content of the file once the delta has been applied */
+        mutable std::vector<char> patched;
+
+        /**
+         * Apply the delta if it hasn't been applied yet
+         * @return True if the patched content is available
+         */
+        bool apply() const;
+
+    public:
+        /**
+         * Create a delta file, taking a reference to the base
+         * @param source Where the pack is read from
+         * @param vfs The VFS the base is mounted in, which must outlive the delta file
+         * @param base The file the delta is applied to
+         * @param baseHash The hash of the file the delta was made against, to check the base is that file
+         * @param offset Where the delta starts in the pack
+         * @param length The size of the delta
+         * @param size The size of the file once the delta is applied
+         * @param hash The hash of the file once the delta is applied
+         */
+        DvfsPatchDeltaFile(std::shared_ptr<const IDvfsFile> source, DatVFS& vfs, IDvfsFile* base, uint64_t baseHash, uint64_t offset,
+                           uint64_t length, uint64_t size, uint64_t hash);
+
+        DvfsPatchDeltaFile(const DvfsPatchDeltaFile&) = delete;
+        DvfsPatchDeltaFile& operator=(const DvfsPatchDeltaFile&) = delete;
+
+        /**
+         * Releases the reference to the base through the VFS, deleting it if nothing else references it
+         */
+        ~DvfsPatchDeltaFile() override;
+
+        /** @inherit */
+        [[nodiscard]] uint64_t fileSize() const override;
+
+        /** @inherit */
+        [[nodiscard]] bool isValidFile() const override;
+
+        /** @inherit */
+        bool getContent(char* buffer) const override;
+
+        /** @inherit */
+        bool getContentRange(char* buffer, uint64_t offset, uint64_t length) const override;
+    };
+}
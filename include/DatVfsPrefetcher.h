@@ -0,0 +1,132 @@
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "DatPath.h"
+#include "DatVfsFile.h"
+#include "DatVfsThreadPool.h"
+
+namespace Dvfs {
+    class DatVFS;
+
+    /**
+     * Sits in front of file lookups on a DatVFS, recording the order files are accessed in and using the order recorded
+     * by a previous session to prefetch files before they are needed
+     * <br>
+     * Prefetches are issued on a thread pool using IDvfsFile::prefetch(). Files must not be unmounted from the VFS while
+     * prefetches for them may still be running, see waitForPrefetches().
+     */
+    class DvfsPrefetcher {
+        const DatVFS& vfs;
+        DvfsThreadPool::TaskGroup prefetches;
+
+        /** How many files ahead of the current position in the history to prefetch */
+        size_t lookahead;
+
+        mutable std::mutex mutex;
+
+        /** The access order recorded by a previous session */
+        std::vector<std::string> history;
+        /** The first position of each path in the history */
+        std::unordered_map<std::string, size_t> historyPositions;
+        /** The position in the history up to which prefetches have been issued */
+        size_t prefetchedUpTo = 0;
+
+        /** The access order of this session, each path is only recorded the first time it is accessed */
+        std::vector<std::string> session;
+        std::unordered_set<std::string> sessionPaths;
+
+        std::atomic<uint64_t> prefetchCount = 0;
+
+        /**
+         * Queue prefetches for the given positions in the history
+         * <br>
+         * The mutex must be held when calling this
+         * @param begin The first position to prefetch
+         * @param end The position after the last one to prefetch
+         */
+        void prefetchHistory(size_t begin, size_t end);
+
+        /**
+         * Queue a prefetch of a file on the thread pool
+         * @param file The file to prefetch
+         */
+        void queuePrefetch(const IDvfsFile* file);
+
+    public:
+        /** The identifier at the start of saved history files */
+        static constexpr const char* historyHeader = "dat-vfs-prefetch-history 1";
+
+        /**
+         * Create a prefetcher
+         * @param vfs The VFS to look files up in
+         * @param lookahead How many files ahead of the current position in the history to prefetch
+         * @param pool The pool to issue prefetches on
+         */
+        explicit DvfsPrefetcher(const DatVFS& vfs, size_t lookahead = 16, DvfsThreadPool& pool = DvfsThreadPool::getDefault());
+
+        DvfsPrefetcher(const DvfsPrefetcher&) = delete;
+        DvfsPrefetcher& operator=(const DvfsPrefetcher&) = delete;
+
+        /**
+         * Waits for any outstanding prefetches
+         */
+        ~DvfsPrefetcher();
+
+        /**
+         * Get a file from the VFS, recording the access and prefetching the files that followed it in the history
+         * @param path The path to the file
+         * @return A pointer to the file, or nullptr if the file doesn't exist
+         */
+        IDvfsFile* getFile(const DatPath& path);
+
+        /**
+         * Record an access to a file without looking it up, prefetching the files that followed it in the history
+         * @param path The path to the file
+         */
+        void recordAccess(const DatPath& path);
+
+        /**
+         * Prefetch the given files in the background
+         * @param paths The paths to the files to prefetch, paths that don't exist are ignored
+         */
+        void prefetch(const std::vector<DatPath>& paths);
+
+        /**
+         * Wait for every queued prefetch to finish
+         */
+        void waitForPrefetches();
+
+        /**
+         * Load the access order recorded by a previous session, and start prefetching the first files in it
+         * @param historyFile The file the history was saved to
+         * @return True if the history was loaded
+         */
+        bool loadHistory(const std::filesystem::path& historyFile);
+
+        /**
+         * Save the access order of this session, so the next session can prefetch in the same order
+         * @param historyFile The file to save the history to
+         * @return True if the history was saved
+         */
+        bool saveHistory(const std::filesystem::path& historyFile) const;
+
+        /**
+         * Get the access order recorded by this session
+         * @return The paths in the order they were first accessed
+         */
+        [[nodiscard]] std::vector<std::string> getSessionHistory() const;
+
+        /**
+         * Get the number of prefetches that have been issued
+         * @return The number of prefetches issued
+         */
+        [[nodiscard]] uint64_t getPrefetchCount() const;
+    };
+}
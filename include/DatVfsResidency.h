@@ -0,0 +1,221 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "DatPath.h"
+#include "DatVfsFile.h"
+#include "DatVfsHandle.h"
+
+namespace Dvfs {
+    class DatVFS;
+
+    /**
+     * Owns the loaded content of files, keeping the total under a memory budget
+     * <br>
+     * Each file is loaded under a tag, such as the level, UI or audio it belongs to, and a priority. When loading a file
+     * would go over the budget, the least recently used content of the lowest priority is unloaded to make room.
+     * Content is accounted by IDvfsFile::fileSize() until it's freed, and content a caller still holds is never unloaded
+     * to make room, so the memory in use never goes over the budget. A load that can't fit fails instead.
+     * <br>
+     * Files are tracked by their address, so a file loaded directly must be unloaded before it's deleted. Files loaded
+     * through a VFS also remember their handle, so once one is unmounted and deleted, a new file at the same address is
+     * read rather than served the old content. Every function is thread-safe, and a file being loaded by one thread is
+     * waited for by others rather than read twice.
+     */
+    class DvfsResidencyManager {
+    public:
+        /** The loaded content of a file, which stays in memory at least as long as it's held */
+        using Content = std::shared_ptr<const std::vector<char>>;
+
+        /**
+         * The memory used by the files loaded under one tag
+         */
+        struct TagResidency {
+            std::string tag;
+            uint64_t bytes = 0;
+            size_t fileCount = 0;
+        };
+
+        /**
+         * What's currently loaded, and how loading has gone
+         */
+        struct Residency {
+            uint64_t budget = 0;
+            /** The bytes of content in memory, including files still being read and unloaded content still held */
+            uint64_t usedBytes = 0;
+            /** The bytes of content that callers are holding, which can't be freed to make room */
+            uint64_t heldBytes = 0;
+            size_t fileCount = 0;
+            /** The memory used by each tag, sorted by tag */
+            std::vector<TagResidency> tags;
+
+            /** Loads of files that were already loaded */
+            uint64_t hits = 0;
+            /** Loads that read the file */
+            uint64_t misses = 0;
+            /** Files unloaded to make room */
+            uint64_t evictions = 0;
+            /** Loads that failed to read or couldn't fit in the budget */
+            uint64_t failures = 0;
+        };
+
+    private:
+        struct Entry {
+            Content content;
+            uint64_t size;
+            std::string tag;
+            int priority;
+            /** When the file was last loaded, used to unload the least recently used first */
+            uint64_t lastUsed;
+            /** The VFS the file was loaded through, if any, whose handle to it tells if it's still the same file */
+            const DatVFS* vfs;
+            DvfsFileHandle handle;
+        };
+
+        /** A loaded file's place in the unloading order, the lowest priority and least recently used first */
+        using EvictionKey = std::tuple<int, uint64_t, const IDvfsFile*>;
+
+        std::unordered_map<const IDvfsFile*, Entry> entries;
+        std::set<EvictionKey> evictionOrder;
+        std::map<std::string, TagResidency, std::less<>> tags;
+
+        uint64_t budget;
+        /**
+         * The bytes of content in memory, returned by the content's deleter once its last holder drops it
+         * <br>
+         * Shared with the deleters so content held past being unloaded, or past the manager, stays accounted
+         */
+        std::shared_ptr<std::atomic<uint64_t>> usedBytes = std::make_shared<std::atomic<uint64_t>>(0);
+        uint64_t clock = 0;
+
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        uint64_t failures = 0;
+
+        mutable std::mutex mutex;
+        /** Signalled whenever a file finishes loading */
+        std::condition_variable loaded;
+
+        /**
+         * Unload files until the given number of bytes fit in the budget
+         * <br>
+         * The mutex must be held when calling this
+         * @param bytes The bytes that need to fit
+         * @return True if they fit
+         */
+        bool makeRoom(uint64_t bytes);
+
+        /**
+         * Allocate content for a file, which hands the bytes accounted for it back to usedBytes once it's freed
+         * @param size The size of the content, which must already be added to usedBytes, and is taken back off if
+         * allocating throws
+         * @return The content
+         */
+        [[nodiscard]] std::shared_ptr<std::vector<char>> allocate(uint64_t size) const;
+
+        /**
+         * Stop tracking a file
+         * <br>
+         * The mutex must be held when calling this
+         * @param it The file's entry
+         */
+        void remove(std::unordered_map<const IDvfsFile*, Entry>::iterator it);
+
+        /**
+         * Get the content of a file, loading it if it isn't already loaded
+         * @param file The file to load
+         * @param tag The group to account the file under
+         * @param priority How important keeping the file loaded is, lower priorities are unloaded first
+         * @param vfs The VFS the file was found in, or nullptr if it was given directly
+         * @param handle The VFS's handle to the file
+         * @return The content, or nullptr if the file couldn't be read or doesn't fit in the budget
+         */
+        Content load(const IDvfsFile& file, std::string_view tag, int priority, const DatVFS* vfs, DvfsFileHandle handle);
+
+    public:
+        /**
+         * Create a residency manager
+         * @param budget The most bytes of content to keep loaded
+         */
+        explicit DvfsResidencyManager(uint64_t budget) : budget(budget) {}
+
+        DvfsResidencyManager(const DvfsResidencyManager&) = delete;
+        DvfsResidencyManager& operator=(const DvfsResidencyManager&) = delete;
+
+        /**
+         * Get the content of a file, loading it if it isn't already loaded
+         * <br>
+         * A file that's already loaded keeps the tag and priority it was first loaded with
+         * @param file The file to load
+         * @param tag The group to account the file under
+         * @param priority How important keeping the file loaded is, lower priorities are unloaded first
+         * @return The content, or nullptr if the file couldn't be read or doesn't fit in the budget
+         */
+        Content load(const IDvfsFile& file, std::string_view tag = {}, int priority = 0);
+
+        /**
+         * Get the content of a file in a VFS, loading it if it isn't already loaded
+         * @param vfs The VFS to find the file in
+         * @param path The path to the file
+         * @param tag The group to account the file under
+         * @param priority How important keeping the file loaded is, lower priorities are unloaded first
+         * @return The content, or nullptr if the file doesn't exist, couldn't be read or doesn't fit in the budget
+         */
+        Content load(const DatVFS& vfs, const DatPath& path, std::string_view tag = {}, int priority = 0);
+
+        /**
+         * Get the content of a file only if it's already loaded, without loading it
+         * @param file The file
+         * @return The content, or nullptr if it isn't loaded
+         */
+        Content find(const IDvfsFile& file);
+
+        /**
+         * Check if a file is loaded
+         * @param file The file
+         * @return True if the file is loaded
+         */
+        [[nodiscard]] bool isResident(const IDvfsFile& file) const;
+
+        /**
+         * Stop keeping a file's content loaded, it's freed once no caller holds it and counts against the budget until then
+         * @param file The file
+         * @return True if the file was loaded
+         */
+        bool unload(const IDvfsFile& file);
+
+        /**
+         * Stop keeping the content of every file loaded under a tag, each is freed once no caller holds it
+         * @param tag The tag
+         * @return The number of files unloaded
+         */
+        size_t unloadTag(std::string_view tag);
+
+        /**
+         * Change the budget, unloading files until the loaded content fits
+         * <br>
+         * Content callers are holding can keep the memory in use over a lowered budget until it's released
+         * @param bytes The new budget
+         * @return True if the loaded content fits in the new budget
+         */
+        bool setBudget(uint64_t bytes);
+
+        /**
+         * Get what's loaded and how much memory it uses
+         * @return The current residency
+         */
+        [[nodiscard]] Residency getResidency() const;
+    };
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Dvfs {
+    /**
+     * A work-stealing thread pool used to split recursive operations across cores
+     * <br>
+     * Each worker owns a queue that it pushes to and pops from the back of, idle workers steal from the front of the
+     * other queues. Work submitted from threads outside the pool goes into a shared queue that every worker drains.
+     */
+    class DvfsThreadPool {
+        struct WorkQueue {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        /** One queue per worker, followed by the shared queue for external threads */
+        std::vector<std::unique_ptr<WorkQueue>> queues;
+        std::vector<std::thread> workers;
+
+        /** The number of tasks waiting in any queue */
+        std::atomic<size_t> queuedTasks = 0;
+        std::mutex sleepMutex;
+        std::condition_variable wake;
+        bool stopping = false;
+
+        /**
+         * Get the index of the queue owned by the calling thread
+         * @return The worker's queue, or the shared queue if the calling thread isn't a worker of this pool
+         */
+        [[nodiscard]] size_t localQueue() const;
+
+        /**
+         * Queue a task on the calling thread's queue
+         * @param task The task to queue
+         */
+        void push(std::function<void()> task);
+
+        /**
+         * Take a task, preferring the given queue before stealing from the others
+         * @param preferred The index of the queue to check first
+         * @param task Where to store the taken task
+         * @return True if a task was taken
+         */
+        bool take(size_t preferred, std::function<void()>& task);
+
+        /**
+         * The main loop of a worker thread
+         * @param index The index of the worker's queue
+         */
+        void workerLoop(size_t index);
+
+    public:
+        /**
+         * A set of tasks that can be waited on together
+         * <br>
+         * Tasks may add more tasks to the group they are running in, wait() returns once every task, including those
+         * added while waiting, has finished.
+         */
+        class TaskGroup {
+            DvfsThreadPool& pool;
+            std::atomic<size_t> pending = 0;
+
+            std::mutex exceptionMutex;
+            /** The first exception thrown by a task, rethrown by wait() */
+            std::exception_ptr exception;
+
+            /**
+             * Run queued tasks until every task in the group has finished
+             */
+            void drain();
+
+        public:
+            /**
+             * Create a task group that submits to the given pool
+             * @param pool The pool to run tasks on
+             */
+            explicit TaskGroup(DvfsThreadPool& pool) : pool(pool) {}
+
+            TaskGroup(const TaskGroup&) = delete;
+            TaskGroup& operator=(const TaskGroup&) = delete;
+
+            ~TaskGroup();
+
+            /**
+             * Submit a task to the pool as part of this group
+             * <br>
+             * An exception thrown by the task doesn't stop the rest of the group, it's rethrown by wait()
+             * @param task The task to run
+             */
+            void run(std::function<void()> task);
+
+            /**
+             * Wait for every task in the group to finish
+             * <br>
+             * The calling thread runs queued tasks while it waits, so it is safe to wait from inside another task. If any
+             * task threw, the first exception is rethrown once every task has finished.
+             */
+            void wait();
+        };
+
+        /**
+         * Create a thread pool
+         * @param threadCount The number of worker threads, defaults to the number of hardware threads
+         */
+        explicit DvfsThreadPool(unsigned int threadCount = std::thread::hardware_concurrency());
+
+        DvfsThreadPool(const DvfsThreadPool&) = delete;
+        DvfsThreadPool& operator=(const DvfsThreadPool&) = delete;
+
+        ~DvfsThreadPool();
+
+        /**
+         * Get the pool shared by DatVFS operations when no pool is given
+         * @return The default thread pool
+         */
+        static DvfsThreadPool& getDefault();
+
+        /**
+         * Get the number of worker threads in the pool
+         * @return The number of worker threads
+         */
+        [[nodiscard]] size_t size() const;
+
+        /**
+         * Queue a task that nothing waits on
+         * <br>
+         * Use a TaskGroup to wait for tasks. Detached tasks still run before the pool is destroyed.
+         * @param task The task to run
+         */
+        void submit(std::function<void()> task);
+
+        /**
+         * Run a single queued task on the calling thread, if there is one
+         * @return True if a task was run
+         */
+        bool runPendingTask();
+    };
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <filesystem>
+#include <set>
+#include <string>
+
+#include "DatPath.h"
+#include "DatVfsWritableFile.h"
+
+namespace Dvfs {
+    class DatVFS;
+
+    /**
+     * A writable directory in the user's filesystem, overlaid on top of a DatVFS at a mount point
+     * <br>
+     * Files opened through the directory are mounted in the VFS in place of whatever was mounted at the same path, so
+     * reads and writes of those paths both go through the VFS. The file underneath is kept as a lower layer, read
+     * until something is committed over it and copied up when it's first written to.
+     */
+    class DvfsLooseWritableDirectory {
+        DatVFS& vfs;
+        DatPath mountPoint;
+        std::filesystem::path directory;
+        size_t bufferCapacity;
+
+        /** The paths of files mounted by this directory, relative to the mount point */
+        std::set<std::string> mountedPaths;
+
+        /**
+         * Find a file mounted by this directory
+         * @param path The path to the file, relative to the mount point
+         * @return The file, or nullptr if the path isn't mounted by this directory
+         */
+        [[nodiscard]] LooseDvfsWritableFile* findFile(const DatPath& path) const;
+
+        /**
+         * Mount a writable file on the VFS, layered over any file already mounted at the path
+         * @param path The path to the file, relative to the mount point
+         * @return The mounted file, or nullptr if it couldn't be mounted
+         */
+        LooseDvfsWritableFile* mountFile(const DatPath& path);
+
+    public:
+        /** The extension of the staging files used for uncommitted writes */
+        static constexpr const char* stagingExtension = ".dvfs-staging";
+
+        /**
+         * Create a writable directory overlay
+         * @param vfs The VFS to mount files on
+         * @param mountPoint The path in the VFS to mount files under
+         * @param directory The directory on disk to store files in
+         * @param bufferCapacity The size of the write buffer for each file
+         */
+        DvfsLooseWritableDirectory(DatVFS& vfs,
+                                   DatPath mountPoint,
+                                   std::filesystem::path directory,
+                                   size_t bufferCapacity = LooseDvfsWritableFile::defaultBufferCapacity);
+
+        /**
+         * Mount every file already in the directory, layered over any files mounted at the same paths
+         * @return The number of files mounted
+         */
+        int mountExisting();
+
+        /**
+         * Open a file for writing, creating and mounting it if needed
+         * @param path The path to the file, relative to the mount point
+         * @return The file, or nullptr if a directory exists at the path
+         */
+        IDvfsWritableFile* openFile(const DatPath& path);
+
+        /**
+         * Commit every file with uncommitted writes
+         * <br>
+         * All the files are synced first, then published, then each containing directory is synced once, rather than
+         * syncing every file and directory in turn
+         * @return True if every file was committed
+         */
+        bool commitAll();
+
+        /**
+         * Throw away the uncommitted writes of every file
+         */
+        void discardAll();
+
+        /**
+         * Get the directory on disk that files are stored in
+         * @return The directory on disk
+         */
+        [[nodiscard]] const std::filesystem::path& getDirectory() const;
+    };
+}
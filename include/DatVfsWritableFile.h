@@ -0,0 +1,226 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "DatVfsFile.h"
+
+namespace Dvfs {
+    class DatVFS;
+
+    /**
+     * An interface for files stored inside the VFS that can be written to
+     * <br>
+     * Writes are staged, they are not visible through getContent() until they have been committed
+     */
+    class IDvfsWritableFile : public IDvfsFile {
+    public:
+        /**
+         * Write data into the file, growing it if needed
+         * @param data The data to write
+         * @param size The number of bytes to write
+         * @param offset The position in the file to write at
+         * @return True if successful
+         */
+        virtual bool write(const char* data, uint64_t size, uint64_t offset) = 0;
+
+        /**
+         * Write data to the end of the file
+         * @param data The data to write
+         * @param size The number of bytes to write
+         * @return True if successful
+         */
+        virtual bool append(const char* data, uint64_t size) = 0;
+
+        /**
+         * Change the size of the file, discarding anything past the new size or padding it with zeros
+         * @param size The new size of the file
+         * @return True if successful
+         */
+        virtual bool truncate(uint64_t size) = 0;
+
+        /**
+         * Pass any buffered writes on to the backing storage
+         * <br>
+         * This does not make the writes durable or visible, see commit()
+         * @return True if successful
+         */
+        virtual bool flush() = 0;
+
+        /**
+         * Durably store every staged write, then atomically replace the file's content with it
+         * @return True if successful
+         */
+        virtual bool commit() = 0;
+
+        /**
+         * Throw away every write made since the last commit
+         */
+        virtual void discard() = 0;
+
+        /**
+         * Check if there are writes that haven't been committed
+         * @return True if there are uncommitted writes
+         */
+        [[nodiscard]] virtual bool hasPendingChanges() const = 0;
+    };
+
+    /**
+     * A writable DvfsFile representing a file in the user's filesystem
+     * <br>
+     * Writes go to a staging file next to the real one, through a buffer that coalesces sequential writes. Committing
+     * syncs the staging file to disk and renames it over the real file, so readers only ever see complete versions.
+     * <br>
+     * The file can be layered over a file mounted in a VFS, which is read until the first commit and copied up into
+     * the staging file when it's first written to.
+     */
+    class LooseDvfsWritableFile : public IDvfsWritableFile {
+        /** The committed file, used for reads */
+        LooseDvfsFile committed;
+        std::filesystem::path filePath;
+        std::filesystem::path stagingPath;
+
+        /** The VFS the lower file is mounted in, or nullptr without a lower file */
+        DatVFS* vfs = nullptr;
+        /** The file underneath this one, which this holds a reference to */
+        IDvfsFile* lower = nullptr;
+        /** Whether reads go to the lower file, until something is committed over it */
+        std::atomic<bool> lowerVisible = false;
+
+        /** The descriptor of the staging file, or -1 when nothing is staged */
+        int stagingFd = -1;
+        /** The size of the staged file, including anything still buffered */
+        uint64_t stagedSize = 0;
+
+        /** Buffered writes, covering a contiguous range starting at bufferOffset */
+        std::vector<char> buffer;
+        uint64_t bufferOffset = 0;
+        size_t bufferCapacity;
+
+        /**
+         * Get the file reads currently go to
+         * @return The lower file until something is committed over it, then the committed file
+         */
+        [[nodiscard]] const IDvfsFile& visible() const;
+
+        /**
+         * Create the staging file if it doesn't already exist
+         * @param copyExisting Whether to start the staging file with the visible content
+         * @return True if the staging file is ready for writing
+         */
+        bool stage(bool copyExisting);
+
+        /**
+         * Write the buffer to the staging file
+         * @return True if successful
+         */
+        bool flushBuffer();
+
+        /**
+         * Write data directly to the staging file
+         * @param data The data to write
+         * @param size The number of bytes to write
+         * @param offset The position in the file to write at
+         * @return True if successful
+         */
+        bool writeFully(const char* data, uint64_t size, uint64_t offset) const;
+
+    public:
+        /** The default size of the write buffer */
+        static constexpr size_t defaultBufferCapacity = 64 * 1024;
+
+        /**
+         * Create a LooseDvfsWritableFile for the file at the given path, the file doesn't need to exist yet
+         * @param filePath The path to the file on disk
+         * @param bufferCapacity The size of the write buffer
+         */
+        explicit LooseDvfsWritableFile(std::filesystem::path filePath, size_t bufferCapacity = defaultBufferCapacity);
+
+        /**
+         * Create a LooseDvfsWritableFile layered over a file mounted in a VFS
+         * <br>
+         * If the file doesn't exist on disk yet, reads go to the lower file until something is committed
+         * @param filePath The path to the file on disk
+         * @param vfs The VFS the lower file is mounted in, which must outlive this file
+         * @param lower The file underneath, this holds a reference to it until it's destroyed
+         * @param bufferCapacity The size of the write buffer
+         */
+        LooseDvfsWritableFile(std::filesystem::path filePath, DatVFS& vfs, IDvfsFile* lower, size_t bufferCapacity = defaultBufferCapacity);
+
+        LooseDvfsWritableFile(const LooseDvfsWritableFile&) = delete;
+        LooseDvfsWritableFile& operator=(const LooseDvfsWritableFile&) = delete;
+
+        /**
+         * Discards any uncommitted writes and releases the lower file
+         */
+        ~LooseDvfsWritableFile() override;
+
+        /** @inherit */
+        [[nodiscard]] uint64_t fileSize() const override;
+
+        /** @inherit */
+        [[nodiscard]] bool isValidFile() const override;
+
+        /** @inherit */
+        bool getContent(char* buffer) const override;
+
+        /** @inherit */
+        bool getContentRange(char* buffer, uint64_t offset, uint64_t length) const override;
+
+        /** @inherit */
+        void prefetch() const override;
+
+        /** @inherit */
+        bool write(const char* data, uint64_t size, uint64_t offset) override;
+
+        /** @inherit */
+        bool append(const char* data, uint64_t size) override;
+
+        /** @inherit */
+        bool truncate(uint64_t size) override;
+
+        /** @inherit */
+        bool flush() override;
+
+        /** @inherit */
+        bool commit() override;
+
+        /** @inherit */
+        void discard() override;
+
+        /** @inherit */
+        [[nodiscard]] bool hasPendingChanges() const override;
+
+        /**
+         * Flush and durably store the staging file, without making it visible
+         * <br>
+         * This is the first half of commit(), allowing many files to be synced before any of them are published
+         * @return True if successful
+         */
+        bool sync();
+
+        /**
+         * Atomically replace the committed file with the staging file
+         * <br>
+         * This is the second half of commit(), the directory containing the file must be synced afterwards for the
+         * rename to be durable. If the rename fails the staged writes are kept, so the commit can be tried again.
+         * @return True if successful
+         */
+        bool publish();
+
+        /**
+         * Get the path to the file on disk
+         * @return The path to the file
+         */
+        [[nodiscard]] const std::filesystem::path& getFilePath() const;
+
+        /**
+         * Durably store the entries of a directory, making renames inside it durable
+         * @param directory The path to the directory
+         * @return True if successful
+         */
+        static bool syncDirectory(const std::filesystem::path& directory);
+    };
+}
@@ -0,0 +1,244 @@
+#include "../include/DatGlob.h"
+
+#include <span>
+
+namespace {
+    constexpr size_t npos = std::string_view::npos;
+
+    /**
+     * Match a character against the character set starting at the given index of the pattern
+     * @param pattern The pattern containing the set
+     * @param index The index of the '[' that opens the set
+     * @param c The character to match
+     * @param matched Set to whether the character is in the set
+     * @return The index after the closing ']', or npos if the set isn't terminated
+     */
+    size_t matchSet(std::string_view pattern, size_t index, char c, bool& matched) {
+        size_t i = index + 1;
+
+        bool negate = false;
+        if (i < pattern.size() && (pattern[i] == '!' || pattern[i] == '^')) {
+            negate = true;
+            ++i;
+        }
+
+        bool found = false;
+        // A ']' straight after the opening is part of the set rather than closing it
+        bool first = true;
+        while (i < pattern.size() && (first || pattern[i] != ']')) {
+            first = false;
+
+            char low = pattern[i];
+            char high = low;
+            if (i + 2 < pattern.size() && pattern[i + 1] == '-' && pattern[i + 2] != ']') {
+                high = pattern[i + 2];
+                i += 3;
+            } else {
+                ++i;
+            }
+
+            if (low <= c && c <= high) found = true;
+        }
+
+        if (i >= pattern.size()) return npos;
+
+        matched = found != negate;
+        return i + 1;
+    }
+
+    /**
+     * Compile a single segment of a glob pattern
+     * @param pattern The segment's pattern
+     * @param valid Set to false if the segment is malformed
+     * @return The compiled segment
+     */
+    Dvfs::DatGlob::Segment compileSegment(std::string_view pattern, bool& valid) {
+        using Segment = Dvfs::DatGlob::Segment;
+
+        Segment segment{Segment::Type::Literal, std::string(pattern)};
+        if (pattern == "**") {
+            segment.type = Segment::Type::Recursive;
+            return segment;
+        }
+
+        bool seenWildcard = false;
+        size_t i = 0;
+        while (i < pattern.size()) {
+            const char c = pattern[i];
+            if (c == '*') {
+                segment.hasStar = true;
+                seenWildcard = true;
+                segment.suffixLength = 0;
+                ++i;
+                continue;
+            }
+
+            if (c == '?' || c == '[') {
+                if (c == '[') {
+                    bool matched;
+                    size_t next = matchSet(pattern, i, '\0', matched);
+                    if (next == npos) {
+                        valid = false;
+                        return segment;
+                    }
+                    i = next;
+                } else {
+                    ++i;
+                }
+
+                seenWildcard = true;
+                segment.suffixLength = 0;
+                ++segment.minLength;
+                continue;
+            }
+
+            if (!seenWildcard) ++segment.prefixLength;
+            ++segment.suffixLength;
+            ++segment.minLength;
+            ++i;
+        }
+
+        if (seenWildcard) segment.type = Segment::Type::Wildcard;
+        return segment;
+    }
+
+    /**
+     * Match path components against compiled segments
+     * @param segments The remaining segments of the pattern
+     * @param names The remaining components of the path
+     * @return true if the components match the segments
+     */
+    bool matchComponents(std::span<const Dvfs::DatGlob::Segment> segments, std::span<const std::string_view> names) {
+        if (segments.empty()) return names.empty();
+
+        if (segments[0].type == Dvfs::DatGlob::Segment::Type::Recursive) {
+            for (size_t skip = 0; skip <= names.size(); ++skip) {
+                if (matchComponents(segments.subspan(1), names.subspan(skip))) return true;
+            }
+            return false;
+        }
+
+        if (names.empty()) return false;
+        return segments[0].matches(names[0]) && matchComponents(segments.subspan(1), names.subspan(1));
+    }
+}
+
+bool Dvfs::DatGlob::Segment::matches(std::string_view name) const {
+    switch (type) {
+        case Type::Literal:
+            return name == pattern;
+        case Type::Recursive:
+            return true;
+        case Type::Wildcard:
+            break;
+    }
+
+    // Reject on length and the literal ends before doing any wildcard matching
+    if (name.size() < minLength) return false;
+    if (!hasStar && name.size() != minLength) return false;
+    if (name.compare(0, prefixLength, pattern, 0, prefixLength) != 0) return false;
+    if (name.compare(name.size() - suffixLength, suffixLength, pattern, pattern.size() - suffixLength, suffixLength) != 0) return false;
+
+    const std::string_view patternView(pattern);
+    return wildcardMatch(patternView.substr(prefixLength, pattern.size() - prefixLength - suffixLength),
+                         name.substr(prefixLength, name.size() - prefixLength - suffixLength));
+}
+
+Dvfs::DatGlob::DatGlob(std::string_view pattern) {
+    size_t start = 0;
+    while (start <= pattern.size()) {
+        size_t end = pattern.find('/', start);
+        if (end == npos) end = pattern.size();
+
+        if (end != start) {
+            Segment segment = compileSegment(pattern.substr(start, end - start), valid);
+
+            // "**/**" matches the same as "**"
+            if (segment.type != Segment::Type::Recursive
+                || segments.empty()
+                || segments.back().type != Segment::Type::Recursive) {
+                segments.push_back(std::move(segment));
+            }
+        }
+
+        start = end + 1;
+    }
+
+    // A trailing "**" matches every file below it, the same as "**/*"
+    if (!segments.empty() && segments.back().type == Segment::Type::Recursive) {
+        segments.push_back(compileSegment("*", valid));
+    }
+}
+
+const std::vector<Dvfs::DatGlob::Segment>& Dvfs::DatGlob::getSegments() const {
+    return segments;
+}
+
+Dvfs::DatGlob Dvfs::DatGlob::foldCase() const {
+    // Folding keeps every character in place, so the precomputed lengths are still correct
+    DatGlob folded = *this;
+    for (Segment& segment: folded.segments) {
+        segment.pattern = DatPath::foldCase(segment.pattern);
+    }
+    return folded;
+}
+
+bool Dvfs::DatGlob::isValid() const {
+    return valid;
+}
+
+bool Dvfs::DatGlob::matches(const DatPath& path) const {
+    if (!valid || segments.empty()) return false;
+
+    std::vector<std::string_view> names = path.split();
+    return matchComponents(segments, names);
+}
+
+bool Dvfs::DatGlob::wildcardMatch(std::string_view pattern, std::string_view name) {
+    size_t p = 0;
+    size_t n = 0;
+
+    // Where to resume after the last '*' if the current attempt fails
+    size_t starPattern = npos;
+    size_t starName = 0;
+
+    while (n < name.size()) {
+        if (p < pattern.size()) {
+            const char pc = pattern[p];
+            if (pc == '*') {
+                starPattern = ++p;
+                starName = n;
+                continue;
+            }
+
+            if (pc == '?') {
+                ++p;
+                ++n;
+                continue;
+            }
+
+            if (pc == '[') {
+                bool matched = false;
+                size_t next = matchSet(pattern, p, name[n], matched);
+                if (next == npos) return false;
+                if (matched) {
+                    p = next;
+                    ++n;
+                    continue;
+                }
+            } else if (pc == name[n]) {
+                ++p;
+                ++n;
+                continue;
+            }
+        }
+
+        // Let the last '*' swallow one more character and try again
+        if (starPattern == npos) return false;
+        p = starPattern;
+        n = ++starName;
+    }
+
+    while (p < pattern.size() && pattern[p] == '*') ++p;
+    return p == pattern.size();
+}
@@ -0,0 +1,138 @@
+#include "../include/DatHash.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace {
+    constexpr uint64_t prime1 = 0x9E3779B185EBCA87ULL;
+    constexpr uint64_t prime2 = 0xC2B2AE3D27D4EB4FULL;
+    constexpr uint64_t prime3 = 0x165667B19E3779F9ULL;
+    constexpr uint64_t prime4 = 0x85EBCA77C2B2AE63ULL;
+    constexpr uint64_t prime5 = 0x27D4EB2F165667C5ULL;
+
+    template<typename T>
+    T readLittleEndian(const unsigned char* data) {
+        T value;
+        std::memcpy(&value, data, sizeof(T));
+
+        if constexpr (std::endian::native == std::endian::big) {
+            T swapped = 0;
+            for (size_t i = 0; i < sizeof(T); ++i) {
+                swapped = (swapped << 8) | (value & 0xFF);
+                value >>= 8;
+            }
+            return swapped;
+        }
+
+        return value;
+    }
+
+    uint64_t round(uint64_t accumulator, const uint64_t input) {
+        accumulator += input * prime2;
+        accumulator = std::rotl(accumulator, 31);
+        return accumulator * prime1;
+    }
+
+    uint64_t mergeRound(uint64_t accumulator, const uint64_t value) {
+        accumulator ^= round(0, value);
+        return accumulator * prime1 + prime4;
+    }
+
+    /**
+     * Consume a single 32 byte stripe
+     */
+    void consumeStripe(uint64_t (&accumulators)[4], const unsigned char* stripe) {
+        for (size_t i = 0; i < 4; ++i) {
+            accumulators[i] = round(accumulators[i], readLittleEndian<uint64_t>(stripe + i * 8));
+        }
+    }
+}
+
+Dvfs::DvfsHasher::DvfsHasher(const uint64_t seed) :
+        accumulators{seed + prime1 + prime2, seed + prime2, seed, seed - prime1},
+        seed(seed),
+        buffer{} {}
+
+void Dvfs::DvfsHasher::update(const void* data, size_t length) {
+    auto input = static_cast<const unsigned char*>(data);
+    totalLength += length;
+
+    // Top up a partially filled stripe first
+    if (bufferedLength != 0) {
+        const size_t toCopy = std::min(length, sizeof(buffer) - bufferedLength);
+        std::memcpy(buffer + bufferedLength, input, toCopy);
+        bufferedLength += toCopy;
+        input += toCopy;
+        length -= toCopy;
+
+        if (bufferedLength < sizeof(buffer)) return;
+
+        consumeStripe(accumulators, buffer);
+        bufferedLength = 0;
+    }
+
+    while (length >= sizeof(buffer)) {
+        consumeStripe(accumulators, input);
+        input += sizeof(buffer);
+        length -= sizeof(buffer);
+    }
+
+    std::memcpy(buffer, input, length);
+    bufferedLength = length;
+}
+
+uint64_t Dvfs::DvfsHasher::digest() const {
+    uint64_t hash;
+    if (totalLength >= sizeof(buffer)) {
+        hash = std::rotl(accumulators[0], 1)
+               + std::rotl(accumulators[1], 7)
+               + std::rotl(accumulators[2], 12)
+               + std::rotl(accumulators[3], 18);
+        for (const uint64_t accumulator: accumulators) {
+            hash = mergeRound(hash, accumulator);
+        }
+    } else {
+        hash = seed + prime5;
+    }
+
+    hash += totalLength;
+
+    // Mix in whatever didn't make up a whole stripe
+    const unsigned char* remaining = buffer;
+    size_t length = bufferedLength;
+    while (length >= 8) {
+        hash ^= round(0, readLittleEndian<uint64_t>(remaining));
+        hash = std::rotl(hash, 27) * prime1 + prime4;
+        remaining += 8;
+        length -= 8;
+    }
+
+    if (length >= 4) {
+        hash ^= static_cast<uint64_t>(readLittleEndian<uint32_t>(remaining)) * prime1;
+        hash = std::rotl(hash, 23) * prime2 + prime3;
+        remaining += 4;
+        length -= 4;
+    }
+
+    while (length > 0) {
+        hash ^= *remaining * prime5;
+        hash = std::rotl(hash, 11) * prime1;
+        ++remaining;
+        --length;
+    }
+
+    // Avalanche
+    hash ^= hash >> 33;
+    hash *= prime2;
+    hash ^= hash >> 29;
+    hash *= prime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+uint64_t Dvfs::DvfsHasher::hash(const void* data, const size_t length, const uint64_t seed) {
+    DvfsHasher hasher(seed);
+    hasher.update(data, length);
+    return hasher.digest();
+}
@@ -1,47 +1,93 @@
 #include "../include/DatPath.h"
 
-#include <algorithm>
-#include <cassert>
-#include <iostream>
-#include <ranges>
+#include <span>
+#include <stdexcept>
 #include <vector>
 
-std::string Dvfs::DatPath::sanitisePath(std::string path) {
+#include "../include/DatPathScan.h"
+
+Dvfs::DatPath::DatPath(std::string path) {
+    bool hasUppercase;
+    this->path = sanitisePath(std::move(path), hasUppercase);
+    if (hasUppercase) folded = foldCase(this->path);
+}
+
+Dvfs::DatPath::DatPath(const DatPathView path) : path(path.str()) {
+    // Views are already normalised, so only the folded key is needed
+    if (DatPathScan::scan(this->path).hasUppercase) folded = foldCase(this->path);
+}
+
+std::string Dvfs::DatPath::sanitisePath(std::string path, bool& hasUppercase) {
+    hasUppercase = false;
     if (path.empty()) {
-        return std::move(path);
+        return path;
     }
 
+    const DatPathScan scan = DatPathScan::scan(path);
+    hasUppercase = scan.hasUppercase;
+
     // Ensure backslashes aren't used
-    assert(path.find('\\') == std::string::npos);
+    if (scan.hasBackslash) {
+        throw std::invalid_argument("DatPath cannot contain backslashes: " + path);
+    }
+
+    // Most paths are already clean, so avoid rebuilding them
+    if (!scan.hasRepeatedSeparator && !scan.hasDotSection && path.front() != '/' && path.back() != '/') {
+        return path;
+    }
+
+    // Rebuilding from the sections trims the ends and collapses repeated separators at once
+    std::vector<std::string_view> parts;
+    parts.reserve(scan.separators + 1);
+    DatPathScan::split(path, parts);
+
+    // Resolve "." and ".." in place, ".." at the start of the path has nothing to go up to so is dropped
+    size_t kept = 0;
+    for (std::string_view part: parts) {
+        if (part == ".") continue;
+        if (part == "..") {
+            if (kept > 0) --kept;
+            continue;
+        }
+        parts[kept++] = part;
+    }
+
+    std::string result;
+    result.reserve(path.size());
+    for (std::string_view part: std::span(parts).first(kept)) {
+        if (!result.empty()) result += '/';
+        result += part;
+    }
 
-    std::string::size_type startIndex = path.find_first_not_of('/');
-    std::string::size_type endIndex = path.find_last_not_of('/');
+    return result;
+}
 
-    return path.substr(startIndex,
-                             endIndex != std::string::npos
-                             ? endIndex + 1 - startIndex
-                             : std::string::npos);
+std::string Dvfs::DatPath::foldCase(std::string_view text) {
+    std::string result(text);
+    for (char& c: result) {
+        if (c >= 'A' && c <= 'Z') c += 'a' - 'A';
+    }
+    return result;
 }
 
 Dvfs::DatPath::operator std::string() const {
     return path;
 }
 
+Dvfs::DatPath::operator DatPathView() const {
+    return DatPathView(path);
+}
+
 bool Dvfs::DatPath::operator==(const DatPath& rh) const {
     return path == rh.path;
 }
 
 Dvfs::DatPath Dvfs::DatPath::operator/(const std::string& subPath) const {
-    // Avoid sanitising twice by creating an empty DatPath and setting its path manually, we have to sanitise once this
-    // way as we don't sanitise the middle of the path, only the ends
-    DatPath newPath;
-    // If this path/sub-path is empty then we have to make sure we don't append a "/" at the beginning/end
-    newPath.path = empty()
-            ? sanitisePath(subPath)
-            : subPath.empty()
-                    ? path
-                    : path + "/" + sanitisePath(subPath);
-    return newPath;
+    if (empty()) return {subPath};
+    if (subPath.empty()) return *this;
+
+    // The sub-path may contain ".." sections that have to be resolved against this path, so sanitise them together
+    return {path + "/" + subPath};
 }
 
 Dvfs::DatPath Dvfs::DatPath::operator/(const char* subPath) const {
@@ -49,15 +95,17 @@ Dvfs::DatPath Dvfs::DatPath::operator/(const char* subPath) const {
 }
 
 Dvfs::DatPath Dvfs::DatPath::operator/(const Dvfs::DatPath& subPath) const {
-    // By using two DatPaths we can guarantee that both sides are sanitised, so avoid extra sanitise by creating
-    // an empty DatPath and setting its path manually
-    DatPath newPath;
     // If this path/sub-path is empty then we have to make sure we don't append a "/" at the beginning/end
-    newPath.path = empty()
-            ? subPath.path
-            : subPath.empty()
-                    ? path
-                    : (path + "/" + subPath.path);
+    if (empty()) return subPath;
+    if (subPath.empty()) return *this;
+
+    // By using two DatPaths we can guarantee that both sides are already normalised, so avoid sanitising again by
+    // creating an empty DatPath and setting its path manually
+    DatPath newPath;
+    newPath.path = path + "/" + subPath.path;
+    if (!folded.empty() || !subPath.folded.empty()) {
+        newPath.folded = getFoldedKey() + "/" + subPath.getFoldedKey();
+    }
     return newPath;
 }
 
@@ -68,20 +116,21 @@ Dvfs::DatPath Dvfs::DatPath::getRoot() const {
 
 size_t Dvfs::DatPath::depth() const {
     if (path.empty()) return 0;
-    return std::count(path.begin(), path.end(), '/') + 1;
+    // Sanitised paths have no repeated or trailing separators, so each one starts a new section
+    return DatPathScan::scan(path).separators + 1;
 }
 
 bool Dvfs::DatPath::empty() const {
     return path.empty();
 }
 
-std::vector<std::string_view> Dvfs::DatPath::split() const {
-    auto parts = path | std::views::split('/')
-            | std::views::filter([](auto rng) {
-                return !rng.empty();
-            })
-            | std::views::transform([](auto rng) {
-                  return std::string_view(rng.data(), rng.size());
-            });
-     return {parts.begin(), parts.end()};
+const std::string& Dvfs::DatPath::getFoldedKey() const {
+    // Paths without uppercase letters are their own folded key
+    return folded.empty() ? path : folded;
+}
+
+std::vector<std::string_view> Dvfs::DatPath::split(const bool folded) const {
+    std::vector<std::string_view> parts;
+    DatPathScan::split(folded ? getFoldedKey() : path, parts);
+    return parts;
 }
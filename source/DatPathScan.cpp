@@ -0,0 +1,193 @@
+#include "../include/DatPathScan.h"
+
+#include <bit>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace {
+#if defined(__AVX2__)
+    constexpr size_t blockSize = 32;
+    constexpr const char* implementation = "avx2";
+    using Block = __m256i;
+
+    Block loadBlock(const char* data) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+    }
+
+    /**
+     * Find the bytes in a block equal to the given character
+     * @return A mask with bit n set if byte n of the block matched
+     */
+    uint32_t matchBlock(Block block, char c) {
+        return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(c))));
+    }
+
+    /**
+     * Find the bytes in a block within the given range of ASCII characters
+     * @return A mask with bit n set if byte n of the block matched
+     */
+    uint32_t matchBlockRange(Block block, char low, char high) {
+        const __m256i aboveLow = _mm256_cmpgt_epi8(block, _mm256_set1_epi8(static_cast<char>(low - 1)));
+        const __m256i belowHigh = _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(high + 1)), block);
+        return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(aboveLow, belowHigh)));
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    constexpr size_t blockSize = 16;
+    constexpr const char* implementation = "sse2";
+    using Block = __m128i;
+
+    Block loadBlock(const char* data) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    }
+
+    uint32_t matchBlock(Block block, char c) {
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(c))));
+    }
+
+    uint32_t matchBlockRange(Block block, char low, char high) {
+        const __m128i aboveLow = _mm_cmpgt_epi8(block, _mm_set1_epi8(static_cast<char>(low - 1)));
+        const __m128i belowHigh = _mm_cmplt_epi8(block, _mm_set1_epi8(static_cast<char>(high + 1)));
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(aboveLow, belowHigh)));
+    }
+#else
+    constexpr size_t blockSize = 0;
+    constexpr const char* implementation = "scalar";
+    using Block = const char*;
+
+    Block loadBlock(const char* data) {
+        return data;
+    }
+
+    uint32_t matchBlock(Block, char) {
+        return 0;
+    }
+
+    uint32_t matchBlockRange(Block, char, char) {
+        return 0;
+    }
+#endif
+
+    /**
+     * Scan part of a path one character at a time
+     * @param path The whole path
+     * @param start The index to start scanning from
+     * @param result The scan to add to
+     */
+    void scanTail(std::string_view path, size_t start, Dvfs::DatPathScan& result) {
+        // The start of the path counts as a separator for finding dot sections
+        bool previousSeparator = start == 0 || path[start - 1] == '/';
+        for (size_t i = start; i < path.size(); ++i) {
+            const char c = path[i];
+            const bool separator = c == '/';
+
+            result.separators += separator;
+            result.hasBackslash |= c == '\\';
+            result.hasRepeatedSeparator |= separator && previousSeparator && i > 0;
+            result.hasDotSection |= c == '.' && previousSeparator;
+            result.hasUppercase |= c >= 'A' && c <= 'Z';
+            previousSeparator = separator;
+        }
+    }
+
+    /**
+     * Split part of a path one character at a time
+     * @param path The whole path
+     * @param index The index to start splitting from
+     * @param start The index the current section started at
+     * @param parts The vector to add sections to
+     */
+    void splitTail(std::string_view path, size_t index, size_t start, std::vector<std::string_view>& parts) {
+        for (; index < path.size(); ++index) {
+            if (path[index] != '/') continue;
+
+            if (index > start) parts.push_back(path.substr(start, index - start));
+            start = index + 1;
+        }
+
+        if (path.size() > start) parts.push_back(path.substr(start));
+    }
+}
+
+Dvfs::DatPathScan Dvfs::DatPathScan::scan(std::string_view path) {
+    DatPathScan result;
+    if constexpr (blockSize == 0) {
+        scanTail(path, 0, result);
+        return result;
+    }
+
+    const char* data = path.data();
+    size_t i = 0;
+    // Whether the last byte of the previous block was a separator, the start of the path counts as one for dot sections
+    uint32_t carry = 0;
+    uint32_t backslashes = 0;
+    uint32_t repeated = 0;
+    uint32_t dotSections = 0;
+    uint32_t uppercase = 0;
+
+    for (; i + blockSize <= path.size(); i += blockSize) {
+        const Block block = loadBlock(data + i);
+        const uint32_t separators = matchBlock(block, '/');
+        backslashes |= matchBlock(block, '\\');
+        uppercase |= matchBlockRange(block, 'A', 'Z');
+
+        result.separators += std::popcount(separators);
+        // A separator or dot whose previous byte was a separator
+        const uint32_t afterSeparator = (separators << 1) | carry;
+        repeated |= separators & afterSeparator;
+        dotSections |= matchBlock(block, '.') & (afterSeparator | (i == 0));
+        carry = (separators >> (blockSize - 1)) & 1;
+    }
+
+    result.hasBackslash = backslashes != 0;
+    result.hasRepeatedSeparator = repeated != 0;
+    result.hasDotSection = dotSections != 0;
+    result.hasUppercase = uppercase != 0;
+
+    scanTail(path, i, result);
+    return result;
+}
+
+Dvfs::DatPathScan Dvfs::DatPathScan::scanScalar(std::string_view path) {
+    DatPathScan result;
+    scanTail(path, 0, result);
+    return result;
+}
+
+void Dvfs::DatPathScan::split(std::string_view path, std::vector<std::string_view>& parts) {
+    if constexpr (blockSize == 0) {
+        splitTail(path, 0, 0, parts);
+        return;
+    }
+
+    const char* data = path.data();
+    size_t i = 0;
+    size_t start = 0;
+
+    for (; i + blockSize <= path.size(); i += blockSize) {
+        uint32_t separators = matchBlock(loadBlock(data + i), '/');
+
+        // Visit each separator in the block, lowest first
+        while (separators != 0) {
+            const size_t index = i + std::countr_zero(separators);
+            if (index > start) parts.push_back(path.substr(start, index - start));
+            start = index + 1;
+
+            separators &= separators - 1;
+        }
+    }
+
+    splitTail(path, i, start, parts);
+}
+
+void Dvfs::DatPathScan::splitScalar(std::string_view path, std::vector<std::string_view>& parts) {
+    splitTail(path, 0, 0, parts);
+}
+
+const char* Dvfs::DatPathScan::getImplementation() {
+    return implementation;
+}
@@ -3,28 +3,30 @@
 #include <algorithm>
 #include <numeric>
 #include <ranges>
+#include <unordered_set>
 #include <oneapi/tbb/detail/_range_common.h>
 
-Dvfs::DatVFS::DatVFS() {
-    directories["."] = this;
-    // Lacking a parent, set the parent to itself
-    directories[".."] = this;
-}
+Dvfs::DatVFS::DatVFS() : root(this), parent(nullptr), handles(std::make_unique<DvfsHandleTable>()) {}
 
-Dvfs::DatVFS::DatVFS(Dvfs::DatVFS* parent) {
-    directories["."] = this;
-    directories[".."] = parent;
-}
+Dvfs::DatVFS::DatVFS(Dvfs::DatVFS* parent) : root(parent->root), parent(parent) {}
 
 Dvfs::DatVFS::~DatVFS() {
-    for (auto& directory: directories) {
-        delete directory.second;
+    // Another directory could be created at the same address, so cached lookups through this one must not be used
+    DvfsLookupCache::invalidate();
+
+    // The whole VFS is going, so there's no point keeping the groups up to date
+    if (root == this) groups.reset();
+
+    for (auto& [name, directory]: directories) {
+        delete directory;
     }
     directories.clear();
 
     for (auto& file: files) {
+        if (root->groups) root->groups->forget(file.first);
+
         // Only delete if we know this is the only reference to the file
-        if (file.second->decrementReferences() <= 0) delete file.second;
+        releaseFile(file.second);
     }
     files.clear();
 }
@@ -47,18 +49,23 @@ Dvfs::DatVFS* Dvfs::DatVFS::createDirectory(const std::span<std::string_view> pa
 
     if (exists(path)) return nullptr;
 
+    thaw();
     DatVFS* directory = new DatVFS(this);
-    directories.emplace(path[0], directory);
+    auto [it, inserted] = directories.emplace(path[0], directory);
+    directory->name = it->first;
     return directory;
 }
 
 Dvfs::DatVFS* Dvfs::DatVFS::createDirectory(const DatPath& path, const bool recursive) {
-    std::vector<std::string_view> paths = path.split();
+    std::vector<std::string_view> paths = splitPath(path);
     return createDirectory(std::span(paths), recursive);
 }
 
 
-bool Dvfs::DatVFS::mountFile(const std::span<std::string_view> path, IDvfsFile* dvfsFile, bool createDirectories) {
+bool Dvfs::DatVFS::mountFile(const std::span<std::string_view> path, IDvfsFile* dvfsFile, bool createDirectories, std::string_view tag) {
+    // Paths like ".." normalise to nothing
+    if (path.empty()) return false;
+
     if (path.size() > 1) {
         DatVFS* directory = getDirectory(path.subspan(0, 1));
         if (directory == nullptr) {
@@ -69,54 +76,114 @@ bool Dvfs::DatVFS::mountFile(const std::span<std::string_view> path, IDvfsFile*
             if (directory == nullptr) return false;
         }
 
-        return directory->mountFile(path.subspan(1, path.size() - 1), dvfsFile, createDirectories);
+        return directory->mountFile(path.subspan(1, path.size() - 1), dvfsFile, createDirectories, tag);
     }
 
-    if (exists(path)) return false;
+    return mountLeaf(path[0], dvfsFile, tag) != nullptr;
+}
+
+const std::string* Dvfs::DatVFS::mountLeaf(const std::string_view name, IDvfsFile* dvfsFile, std::string_view tag) {
+    if (files.contains(name) || directories.contains(name)) return nullptr;
+    thaw();
 
-    files.emplace(path[0], dvfsFile);
+    // Files already referenced by a VFS may be held elsewhere, so only fresh files are replaced
+    if (root->deduplicator && dvfsFile->getReferenceCount() == 0) {
+        IDvfsFile* existing = root->deduplicator->deduplicate(dvfsFile);
+        if (existing != dvfsFile) {
+            delete dvfsFile;
+            dvfsFile = existing;
+        }
+    }
+
+    auto [it, inserted] = files.emplace(name, dvfsFile);
     dvfsFile->incrementReferences();
-    return true;
+    DvfsLookupCache::invalidate();
+
+    if (root->fileIndex) root->fileIndex->insert(this, it->first, dvfsFile, tag);
+    return &it->first;
 }
 
 
-bool Dvfs::DatVFS::mountFile(const DatPath& path, IDvfsFile* dvfsFile, bool createDirectories) {
-    std::vector<std::string_view> paths = path.split();
-    return mountFile(std::span(paths), dvfsFile, createDirectories);
+bool Dvfs::DatVFS::mountFile(const DatPath& path, IDvfsFile* dvfsFile, bool createDirectories, std::string_view tag) {
+    std::vector<std::string_view> paths = splitPath(path);
+    return mountFile(std::span(paths), dvfsFile, createDirectories, tag);
 }
 
-int Dvfs::DatVFS::mountFiles(const std::span<std::string_view> path, const IDvfsFileInserter& inserter, bool createDirectories) {
+Dvfs::DvfsMountGroup Dvfs::DatVFS::mountFiles(const std::span<std::string_view> path, const IDvfsFileInserter& inserter, bool createDirectories, std::string_view tag) {
     if (!path.empty()) {
         DatVFS* directory = getDirectory(path.subspan(0, 1));
         if (directory == nullptr) {
-            if (!createDirectories) return 0;
+            if (!createDirectories) return {};
 
             // Call create directory for the validation
             directory = createDirectory(path.subspan(0, 1));
-            if (directory == nullptr) return 0;
+            if (directory == nullptr) return {};
         }
 
-        return directory->mountFiles(path.subspan(1, path.size() - 1), inserter, createDirectories);
+        return directory->mountFiles(path.subspan(1, path.size() - 1), inserter, createDirectories, tag);
     }
 
-    int count = 0;
-    for (const auto& [path, iDvfsFile]: inserter.getAllFiles()) {
-        if (mountFile(path, iDvfsFile, createDirectories)) ++count;
-        else {
-            inserter.handleInsertFailure(path, iDvfsFile);
+    if (root->fileIndex) root->fileIndex->reserve(root->fileIndex->size() + inserter.getSizeHint());
+
+    if (!root->groups) root->groups = std::make_unique<DvfsMountGroups>();
+    root->groups->reserve(root->groups->size() + inserter.getSizeHint());
+    DvfsMountGroup group{root->groups->create()};
+
+    DatPathBuf<> entry;
+    // Inserters usually yield a directory's files together, so remember the last parent rather than walking to it
+    // for every file
+    DatPathBuf<> parentPath;
+    DatVFS* parent = this;
+
+    inserter.forEachFile([&](const std::string_view entryPath, IDvfsFile* iDvfsFile) {
+        entry.clear();
+        try {
+            entry /= entryPath;
+        } catch (const std::invalid_argument&) {
+            inserter.handleInsertFailure(std::string(entryPath), iDvfsFile);
+            return true;
         }
-    }
+        if (root->caseInsensitive) entry.foldCase();
 
-    return count;
+        const std::string_view key = entry.str();
+        const size_t separator = key.rfind('/');
+        const std::string_view parentKey = separator == std::string_view::npos ? std::string_view() : key.substr(0, separator);
+
+        if (parentKey != parentPath.str()) {
+            parentPath.clear();
+            parentPath /= parentKey;
+
+            parent = parentKey.empty() ? this : getDirectory(DatPathView(parentPath));
+            if (parent == nullptr && createDirectories) parent = createDirectory(DatPath(parentPath), true);
+        }
+
+        const std::string* name = !key.empty() && parent != nullptr
+                ? parent->mountLeaf(key.substr(separator + 1), iDvfsFile, tag)
+                : nullptr;
+
+        if (name != nullptr) {
+            root->groups->add(group.id, parent, *name);
+            ++group.fileCount;
+        } else {
+            inserter.handleInsertFailure(std::string(entryPath), iDvfsFile);
+        }
+        return true;
+    });
+
+    // Nothing was mounted, so there's no group to unmount
+    if (group.fileCount == 0) return {};
+    return group;
 }
 
 
-int Dvfs::DatVFS::mountFiles(const DatPath& basePath, const IDvfsFileInserter& inserter, bool createDirectories) {
-    std::vector<std::string_view> paths = basePath.split();
-    return mountFiles(std::span(paths), inserter, createDirectories);
+Dvfs::DvfsMountGroup Dvfs::DatVFS::mountFiles(const DatPath& basePath, const IDvfsFileInserter& inserter, bool createDirectories, std::string_view tag) {
+    std::vector<std::string_view> paths = splitPath(basePath);
+    return mountFiles(std::span(paths), inserter, createDirectories, tag);
 }
 
 bool Dvfs::DatVFS::unmountFile(const std::span<std::string_view> path, const bool deleteDvfsFile) {
+    if (path.empty()) return false;
+
     if (path.size() > 1) {
         DatVFS* directory = getDirectory(path.subspan(0, 1));
         if (directory == nullptr) return false;
@@ -124,32 +191,94 @@ bool Dvfs::DatVFS::unmountFile(const std::span<std::string_view> path, const boo
         return directory->unmountFile(path.subspan(1, path.size() - 1), deleteDvfsFile);
     }
 
-    IDvfsFile* iDvfsFile = getFile(path);
+    if (!files.contains(path[0])) return false;
 
-    if (iDvfsFile == nullptr) return false;
+    thaw();
+    unmountEntry(files.find(path[0]), deleteDvfsFile);
+    return true;
+}
 
-    files.erase(static_cast<std::string>(path[0]));
+void Dvfs::DatVFS::unmountEntry(const DvfsNameTable<IDvfsFile*>::iterator it, const bool deleteDvfsFile) {
+    IDvfsFile* iDvfsFile = it->second;
 
-    // Only delete if we know this is the only reference in the Dvfs
-    if (iDvfsFile->decrementReferences() <= 0 && deleteDvfsFile) delete iDvfsFile;
+    if (root->fileIndex) root->fileIndex->erase(it->first);
+    if (root->groups) root->groups->forget(it->first);
+    files.erase(it);
+    DvfsLookupCache::invalidate();
 
-    return true;
+    // Only delete if we know this is the only reference in the Dvfs
+    releaseFile(iDvfsFile, deleteDvfsFile);
 }
 
 
 bool Dvfs::DatVFS::unmountFile(const DatPath& path, const bool deleteDvfsFile) {
-    std::vector<std::string_view> paths = path.split();
+    std::vector<std::string_view> paths = splitPath(path);
     return unmountFile(std::span(paths), deleteDvfsFile);}
 
+int Dvfs::DatVFS::unmountGroup(const DvfsMountGroup& group, const bool pruneDirectories, const bool deleteDvfsFiles) {
+    if (!root->groups) return 0;
+
+    int count = 0;
+    std::unordered_set<DatVFS*> touched;
+    // Unmounting a file removes it from the group, so this works through the group one file at a time
+    while (root->groups->contains(group.id)) {
+        DatVFS* directory = root->groups->front(group.id).directory;
+        // Thawing moves the names, so the entry is looked up again afterwards
+        directory->thaw();
+
+        directory->unmountEntry(directory->files.find(*root->groups->front(group.id).name), deleteDvfsFiles);
+        if (pruneDirectories) touched.insert(directory);
+        ++count;
+    }
+
+    while (!touched.empty()) {
+        DatVFS* directory = *touched.begin();
+        touched.erase(touched.begin());
+
+        // Removing a directory can leave its parent empty too
+        while (directory != this && directory->parent != nullptr && directory->files.empty() && directory->directories.empty()) {
+            DatVFS* parentDirectory = directory->parent;
+            parentDirectory->thaw();
+            parentDirectory->directories.erase(parentDirectory->directories.find(directory->name));
+            touched.erase(directory);
+            delete directory;
+            directory = parentDirectory;
+        }
+    }
+
+    return count;
+}
+
+bool Dvfs::DatVFS::hasGroup(const DvfsMountGroup& group) const {
+    return root->groups && root->groups->contains(group.id);
+}
+
+void Dvfs::DatVFS::holdFile(IDvfsFile* file) const {
+    file->incrementReferences();
+}
+
+void Dvfs::DatVFS::releaseHeldFile(IDvfsFile* file) {
+    releaseFile(file);
+}
+
 bool Dvfs::DatVFS::removeDirectory(const std::span<std::string_view> path) {
-    DatVFS* directory = getDirectory(path);
-    if (directory == nullptr) return false;
+    if (path.empty()) return false;
 
     if (path.size() > 1) {
+        DatVFS* directory = getDirectory(path.subspan(0, 1));
+        if (directory == nullptr) return false;
+
         return directory->removeDirectory(path.subspan(1, path.size() - 1));
     }
 
-    directories.erase(static_cast<std::string>(path[0]));
+    if (!directories.contains(path[0])) return false;
+
+    thaw();
+    auto it = directories.find(path[0]);
+    DatVFS* directory = it->second;
+    directories.erase(it);
+
+    if (root->fileIndex) directory->unindexTree(*root->fileIndex);
 
     // File and subdirectory deletion is handled by the destructor
     delete directory;
@@ -157,12 +286,14 @@ bool Dvfs::DatVFS::removeDirectory(const std::span<std::string_view> path) {
 }
 
 bool Dvfs::DatVFS::removeDirectory(const DatPath& path) {
-    std::vector<std::string_view> paths = path.split();
+    std::vector<std::string_view> paths = splitPath(path);
     return removeDirectory(std::span(paths));
 }
 
 
 Dvfs::IDvfsFile* Dvfs::DatVFS::getFile(const std::span<std::string_view> path) const {
+    if (path.empty()) return nullptr;
+
     if (path.size() > 1) {
         DatVFS* directory = getDirectory(path.subspan(0, 1));
         if (directory == nullptr) return nullptr;
@@ -170,17 +301,33 @@ Dvfs::IDvfsFile* Dvfs::DatVFS::getFile(const std::span<std::string_view> path) c
         return directory->getFile(path.subspan(1, path.size() - 1));
     }
 
-    auto it = files.find(static_cast<std::string>(path[0]));
+    auto it = files.find(path[0]);
     return it != files.end() ? it->second : nullptr;
 }
 
 Dvfs::IDvfsFile* Dvfs::DatVFS::getFile(const DatPath& path) const {
-    std::vector<std::string_view> paths = path.split();
-    return getFile(std::span(paths));
+    // Paths looked up again before anything changes skip splitting and walking the tree
+    return DvfsLookupCache::lookup(this, DatPathView(path).str(), [&] {
+        std::vector<std::string_view> paths = splitPath(path);
+        return getFile(std::span(paths));
+    });
+}
+
+Dvfs::IDvfsFile* Dvfs::DatVFS::getFile(const DatPathView path) const {
+    if (path.empty()) return nullptr;
 
+    DatPathBuf<> buffer;
+    std::string_view name;
+    const DatVFS* directory = findParent(getLookupKey(path, buffer), name);
+    if (directory == nullptr) return nullptr;
+
+    auto it = directory->files.find(name);
+    return it != directory->files.end() ? it->second : nullptr;
 }
 
 Dvfs::DatVFS* Dvfs::DatVFS::getDirectory(const std::span<std::string_view> path) const {
+    if (path.empty()) return nullptr;
+
     if (path.size() > 1) {
         DatVFS* directory = getDirectory(path.subspan(0, 1));
         if (directory == nullptr) return nullptr;
@@ -188,16 +335,30 @@ Dvfs::DatVFS* Dvfs::DatVFS::getDirectory(const std::span<std::string_view> path)
         return directory->getDirectory(path.subspan(1, path.size() - 1));
     }
 
-    auto it = directories.find(static_cast<std::string>(path[0]));
+    auto it = directories.find(path[0]);
     return it != directories.end() ? it->second : nullptr;
 }
 
 Dvfs::DatVFS* Dvfs::DatVFS::getDirectory(const DatPath& path) const {
-    std::vector<std::string_view> paths = path.split();
+    std::vector<std::string_view> paths = splitPath(path);
     return getDirectory(std::span(paths));
 }
 
+Dvfs::DatVFS* Dvfs::DatVFS::getDirectory(const DatPathView path) const {
+    if (path.empty()) return nullptr;
+
+    DatPathBuf<> buffer;
+    std::string_view name;
+    const DatVFS* directory = findParent(getLookupKey(path, buffer), name);
+    if (directory == nullptr) return nullptr;
+
+    auto it = directory->directories.find(name);
+    return it != directory->directories.end() ? it->second : nullptr;
+}
+
 int Dvfs::DatVFS::exists(const std::span<std::string_view> path) const {
+    if (path.empty()) return 0;
+
     if (path.size() > 1) {
         DatVFS* directory = getDirectory(path.subspan(0, 1));
         if (directory == nullptr) return false;
@@ -205,14 +366,25 @@ int Dvfs::DatVFS::exists(const std::span<std::string_view> path) const {
     }
 
     // Avoids branching, assumes that there will never be a directory and a file with the same name
-    return files.count(static_cast<std::string>(path[0])) + (directories.count(static_cast<std::string>(path[0])) * -1);
+    return files.count(path[0]) + (directories.count(path[0]) * -1);
 }
 
 int Dvfs::DatVFS::exists(const DatPath& path) const {
-    std::vector<std::string_view> paths = path.split();
+    std::vector<std::string_view> paths = splitPath(path);
     return exists(std::span(paths));
 }
 
+int Dvfs::DatVFS::exists(const DatPathView path) const {
+    if (path.empty()) return 0;
+
+    DatPathBuf<> buffer;
+    std::string_view name;
+    const DatVFS* directory = findParent(getLookupKey(path, buffer), name);
+    if (directory == nullptr) return 0;
+
+    return directory->files.count(name) + (directory->directories.count(name) * -1);
+}
+
 bool Dvfs::DatVFS::empty(const std::span<std::string_view> path) const {
     if (!path.empty()) {
         const DatVFS* directory = getDirectory(path.subspan(0, 1));
@@ -220,18 +392,55 @@ bool Dvfs::DatVFS::empty(const std::span<std::string_view> path) const {
         return directory->empty(path.subspan(1, path.size() - 1));
     }
 
-    // There's always "." and ".."
-    return directories.size() <= 2 && files.empty();
+    return directories.empty() && files.empty();
 }
 
 
 bool Dvfs::DatVFS::empty(const DatPath& path) const {
-    std::vector<std::string_view> paths = path.split();
+    std::vector<std::string_view> paths = splitPath(path);
     return empty(std::span(paths));
 }
 
 bool Dvfs::DatVFS::isRoot() const {
-    return getDirectory("..") == this;
+    return parent == nullptr;
+}
+
+bool Dvfs::DatVFS::setCaseInsensitive(const bool caseInsensitive) {
+    if (!root->empty()) return false;
+
+    root->caseInsensitive = caseInsensitive;
+    return true;
+}
+
+bool Dvfs::DatVFS::isCaseInsensitive() const {
+    return root->caseInsensitive;
+}
+
+std::vector<std::string_view> Dvfs::DatVFS::splitPath(const DatPath& path) const {
+    return path.split(root->caseInsensitive);
+}
+
+Dvfs::DatPathView Dvfs::DatVFS::getLookupKey(const DatPathView path, DatPathBuf<>& buffer) const {
+    if (!root->caseInsensitive) return path;
+
+    buffer = path;
+    buffer.foldCase();
+    return buffer;
+}
+
+const Dvfs::DatVFS* Dvfs::DatVFS::findParent(const DatPathView path, std::string_view& name) const {
+    const DatVFS* directory = this;
+    name = path.front();
+
+    for (DatPathView rest = path.next(); !rest.empty(); rest = rest.next()) {
+        auto it = directory->directories.find(name);
+        if (it == directory->directories.end()) return nullptr;
+
+        directory = it->second;
+        name = rest.front();
+    }
+
+    return directory;
 }
 
 std::vector<std::string> Dvfs::DatVFS::listFiles(const std::span<std::string_view> path) const {
@@ -249,7 +458,7 @@ std::vector<std::string> Dvfs::DatVFS::listFiles(const std::span<std::string_vie
 }
 
 std::vector<std::string> Dvfs::DatVFS::listFiles(const DatPath& path) const {
-    std::vector<std::string_view> paths = path.split();
+    std::vector<std::string_view> paths = splitPath(path);
     return listFiles(std::span(paths));
 
 }
@@ -258,7 +467,7 @@ std::vector<std::string> Dvfs::DatVFS::listDirectories(const std::span<std::stri
     if (!path.empty()) {
         const DatVFS* directory = getDirectory(path.subspan(0, 1));
         if (directory == nullptr) return {};
-        return directory->listFiles(path.subspan(1, path.size() - 1));
+        return directory->listDirectories(path.subspan(1, path.size() - 1));
     }
 
     std::vector<std::string> directoryNames;
@@ -269,7 +478,7 @@ std::vector<std::string> Dvfs::DatVFS::listDirectories(const std::span<std::stri
 }
 
 std::vector<std::string> Dvfs::DatVFS::listDirectories(const DatPath& path) const {
-    std::vector<std::string_view> paths = path.split();
+    std::vector<std::string_view> paths = splitPath(path);
     return listDirectories(std::span(paths));
 }
 
@@ -281,24 +490,26 @@ int Dvfs::DatVFS::prune(const std::span<std::string_view> path, const bool recur
     }
 
     int count = 0;
-    auto it = directories.begin();
-    while (it != directories.end()) {
-        // Skip Infinite recursion
-        if (std::string name = it->first; name == "." || name == "..") {
-            ++it;
-            continue;
-        }
-
-        DatVFS* directory = it->second;
-
-        // Do recursive first, so we can prune a directory that becomes empty after pruning
-        if (recursive) {
+    // Do recursive first, so we can prune a directory that becomes empty after pruning
+    if (recursive) {
+        for (const auto& [name, directory]: directories) {
             count += directory->prune(path, recursive);
         }
+    }
+
+    // Leave the directory frozen if there's nothing to prune
+    if (std::ranges::none_of(directories, [](const auto& pair) { return pair.second->empty(); })) return count;
 
+    thawDirectories();
+    auto it = directories.begin();
+    while (it != directories.end()) {
+        DatVFS* directory = it->second;
         if (directory->empty()) {
-            directories.erase(it++);
+            it = directories.erase(it);
+            delete directory;
             ++count;
+        } else {
+            ++it;
         }
     }
 
@@ -306,16 +517,54 @@ int Dvfs::DatVFS::prune(const std::span<std::string_view> path, const bool recur
 }
 
 int Dvfs::DatVFS::prune(const DatPath& path, const bool recursive) {
-    std::vector<std::string_view> paths = path.split();
+    std::vector<std::string_view> paths = splitPath(path);
     return prune(std::span(paths), recursive);
 }
 
+int Dvfs::DatVFS::pruneParallel(const DatPath& path, DvfsThreadPool& pool) {
+    DatVFS* directory = path.empty() ? this : getDirectory(path);
+    if (directory == nullptr) return 0;
+
+    std::atomic<int> count = 0;
+    directory->pruneTask(pool, count);
+    return count;
+}
+
+void Dvfs::DatVFS::pruneTask(DvfsThreadPool& pool, std::atomic<int>& count) {
+    // Each task only modifies its own directory, so subtrees can be pruned independently before checking emptiness
+    {
+        DvfsThreadPool::TaskGroup group(pool);
+        for (const auto& [name, directory]: directories) {
+            group.run([directory, &pool, &count]() {
+                directory->pruneTask(pool, count);
+            });
+        }
+        group.wait();
+    }
+
+    if (std::ranges::none_of(directories, [](const auto& pair) { return pair.second->empty(); })) return;
+
+    // Sibling tasks run at the same time, so only the subdirectories are thawed, the files stay put
+    thawDirectories();
+    auto it = directories.begin();
+    while (it != directories.end()) {
+        DatVFS* directory = it->second;
+        if (directory->empty()) {
+            it = directories.erase(it);
+            delete directory;
+            count.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            ++it;
+        }
+    }
+}
+
 int Dvfs::DatVFS::countFiles(const std::span<std::string_view> path, bool recursive,
                              const std::function<bool(const std::string&, IDvfsFile*)>& predicate) const {
     if (!path.empty()) {
         DatVFS* directory = getDirectory(path.subspan(0, 1));
         if (directory == nullptr) return {};
-        return directory->countFiles(path.subspan(0, path.size() - 1), recursive, predicate);
+        return directory->countFiles(path.subspan(1, path.size() - 1), recursive, predicate);
     }
 
     int count = std::accumulate(files.begin(), files.end(), 0, [&predicate](int acc, const auto& pair){
@@ -324,8 +573,6 @@ int Dvfs::DatVFS::countFiles(const std::span<std::string_view> path, bool recurs
 
     if (recursive) {
         count += std::accumulate(directories.begin(), directories.end(), 0, [&predicate, &path](int acc, const auto& pair) {
-            // Skip Infinite recursion
-            if (pair.first == "." || pair.first == "..") return acc;
             return acc + pair.second->countFiles(path, true, predicate);
         });
     };
@@ -335,7 +582,7 @@ int Dvfs::DatVFS::countFiles(const std::span<std::string_view> path, bool recurs
 
 int Dvfs::DatVFS::countFiles(const DatPath& path, bool recursive,
                              const std::function<bool(const std::string&, IDvfsFile*)>& predicate) const {
-    std::vector<std::string_view> paths = path.split();
+    std::vector<std::string_view> paths = splitPath(path);
     return countFiles(std::span(paths), recursive, predicate);
 }
 
@@ -348,8 +595,6 @@ int Dvfs::DatVFS::countDirectories(const std::span<std::string_view> path, bool
     }
 
     int count = std::accumulate(directories.begin(), directories.end(), 0, [&path, recursive, &predicate](int acc, const auto& pair){
-        // Skip Infinite recursion
-        if (pair.first == "." || pair.first == "..") return acc;
         if (recursive) {
             acc += pair.second->countDirectories(path, recursive, predicate);
         }
@@ -361,10 +606,279 @@ int Dvfs::DatVFS::countDirectories(const std::span<std::string_view> path, bool
 
 int Dvfs::DatVFS::countDirectories(const DatPath& path, const bool recursive,
                                const std::function<bool(const std::string&, DatVFS*)>& predicate) const {
-    std::vector<std::string_view> paths = path.split();
+    std::vector<std::string_view> paths = splitPath(path);
     return countDirectories(std::span(paths), recursive, predicate);
 }
 
+void Dvfs::DatVFS::releaseFile(IDvfsFile* file, const bool deleteFile) {
+    if (file->decrementReferences() > 0) return;
+
+    if (root->deduplicator) root->deduplicator->forget(file);
+    root->handles->release(file);
+    if (deleteFile) delete file;
+}
+
+void Dvfs::DatVFS::fileMoved(const char* previous, const std::string& name) const {
+    if (root->fileIndex) root->fileIndex->rename(previous, name);
+    if (root->groups) root->groups->rename(previous, name);
+}
+
+void Dvfs::DatVFS::thaw() {
+    if (!files.isFrozen() && !directories.isFrozen()) return;
+
+    files.thaw([this](const char* previous, const auto& entry) { fileMoved(previous, entry.first); });
+    directories.thaw([](const char*, const auto& entry) { entry.second->name = entry.first; });
+}
+
+void Dvfs::DatVFS::thawDirectories() {
+    directories.thaw([](const char*, const auto& entry) { entry.second->name = entry.first; });
+}
+
+void Dvfs::DatVFS::freeze() {
+    files.freeze([this](const char* previous, const auto& entry) { fileMoved(previous, entry.first); });
+    directories.freeze([](const char*, const auto& entry) { entry.second->name = entry.first; });
+
+    for (const auto& [name, directory]: directories) {
+        directory->freeze();
+    }
+}
+
+bool Dvfs::DatVFS::isFrozen() const {
+    return files.isFrozen() && directories.isFrozen();
+}
+
+void Dvfs::DatVFS::deduplicateTree(DvfsDeduplicator& deduplicator) {
+    for (auto& [name, file]: files) {
+        IDvfsFile* existing = deduplicator.deduplicate(file);
+        if (existing == file) continue;
+
+        existing->incrementReferences();
+        if (root->fileIndex) root->fileIndex->update(name, existing);
+
+        // The duplicate is only deleted once every path it is mounted at has been replaced
+        releaseFile(file);
+        file = existing;
+        DvfsLookupCache::invalidate();
+    }
+
+    for (const auto& [name, directory]: directories) {
+        directory->deduplicateTree(deduplicator);
+    }
+}
+
+void Dvfs::DatVFS::indexTree(DvfsFileIndex& index) const {
+    for (const auto& [name, file]: files) {
+        index.insert(this, name, file);
+    }
+
+    for (const auto& [name, directory]: directories) {
+        directory->indexTree(index);
+    }
+}
+
+void Dvfs::DatVFS::unindexTree(DvfsFileIndex& index) const {
+    for (const auto& [name, file]: files) {
+        index.erase(name);
+    }
+
+    for (const auto& [name, directory]: directories) {
+        directory->unindexTree(index);
+    }
+}
+
+bool Dvfs::DatVFS::isWithin(const DatVFS* directory) const {
+    const DatVFS* current = this;
+    while (current != directory) {
+        current = current->parent;
+        // Reached the root without finding the directory
+        if (current == nullptr) return false;
+    }
+    return true;
+}
+
+void Dvfs::DatVFS::findByExtension(std::string_view extension, std::vector<DvfsFileIndex::Entry>& entries) const {
+    for (const auto& [name, file]: files) {
+        if (DvfsFileIndex::getExtension(name) == extension) entries.push_back({this, name, file});
+    }
+
+    for (const auto& [name, directory]: directories) {
+        directory->findByExtension(extension, entries);
+    }
+}
+
+void Dvfs::DatVFS::enableIndex() {
+    if (root->fileIndex) return;
+
+    root->fileIndex = std::make_unique<DvfsFileIndex>();
+    root->indexTree(*root->fileIndex);
+}
+
+void Dvfs::DatVFS::enableDeduplication(const uint64_t maxFileSize, const bool verifyContent) {
+    if (root->deduplicator) return;
+
+    root->deduplicator = std::make_unique<DvfsDeduplicator>(maxFileSize, verifyContent);
+    root->deduplicateTree(*root->deduplicator);
+}
+
+void Dvfs::DatVFS::disableDeduplication() {
+    root->deduplicator.reset();
+}
+
+const Dvfs::DvfsDeduplicator* Dvfs::DatVFS::getDeduplicator() const {
+    return root->deduplicator.get();
+}
+
+Dvfs::DvfsFileRead Dvfs::DatVFS::read(const DatPath& path, IDvfsExecutor& executor) const {
+    return {getFile(path), executor};
+}
+
+Dvfs::DvfsAlignedBufferPool& Dvfs::DatVFS::getBufferPool() {
+    return DvfsAlignedBufferPool::getDefault();
+}
+
+Dvfs::DvfsFileHandle Dvfs::DatVFS::getFileHandle(const DatPath& path) const {
+    IDvfsFile* file = getFile(path);
+    if (file == nullptr) return {};
+
+    return root->handles->acquire(file);
+}
+
+Dvfs::IDvfsFile* Dvfs::DatVFS::resolve(const DvfsFileHandle handle) const {
+    return root->handles->resolve(handle);
+}
+
+bool Dvfs::DatVFS::isValid(const DvfsFileHandle handle) const {
+    return resolve(handle) != nullptr;
+}
+
+void Dvfs::DatVFS::disableIndex() {
+    root->fileIndex.reset();
+}
+
+const Dvfs::DvfsFileIndex* Dvfs::DatVFS::getIndex() const {
+    return root->fileIndex.get();
+}
+
+std::vector<Dvfs::DvfsFileIndex::Entry> Dvfs::DatVFS::findByExtension(std::string_view extension, const DatPath& path) const {
+    // Names in case-insensitive VFSs are stored folded, so the extension has to be too
+    const std::string folded = root->caseInsensitive ? DatPath::foldCase(extension) : std::string();
+    if (root->caseInsensitive) extension = folded;
+
+    const DatVFS* directory = path.empty() ? this : getDirectory(path);
+    if (directory == nullptr) return {};
+
+    std::vector<DvfsFileIndex::Entry> entries;
+    if (!root->fileIndex) {
+        directory->findByExtension(extension, entries);
+        return entries;
+    }
+
+    std::span<const DvfsFileIndex::Entry> indexed = root->fileIndex->getByExtension(extension);
+    if (directory == root) return {indexed.begin(), indexed.end()};
+
+    std::ranges::copy_if(indexed, std::back_inserter(entries), [directory](const DvfsFileIndex::Entry& entry) {
+        return entry.directory->isWithin(directory);
+    });
+    return entries;
+}
+
+std::vector<Dvfs::DvfsFileIndex::Entry> Dvfs::DatVFS::findByTag(std::string_view tag, const DatPath& path) const {
+    if (!root->fileIndex) return {};
+
+    const DatVFS* directory = path.empty() ? this : getDirectory(path);
+    if (directory == nullptr) return {};
+
+    std::span<const DvfsFileIndex::Entry> indexed = root->fileIndex->getByTag(tag);
+    if (directory == root) return {indexed.begin(), indexed.end()};
+
+    std::vector<DvfsFileIndex::Entry> entries;
+    std::ranges::copy_if(indexed, std::back_inserter(entries), [directory](const DvfsFileIndex::Entry& entry) {
+        return entry.directory->isWithin(directory);
+    });
+    return entries;
+}
+
+bool Dvfs::DatVFS::glob(const std::span<const DatGlob::Segment> segments, const DatPath& path,
+                        const std::function<bool(const DatPath&, IDvfsFile*)>& callback, int& count,
+                        std::set<std::pair<const DatVFS*, size_t>>* visited) const {
+    using Segment = DatGlob::Segment;
+
+    // With more than one **, the same directory can be reached with the same segments left in several ways, and
+    // searching it again would report its files again
+    if (visited != nullptr && !visited->emplace(this, segments.size()).second) return true;
+
+    const Segment& segment = segments.front();
+    const bool last = segments.size() == 1;
+
+    if (segment.type == Segment::Type::Recursive) {
+        // Match zero directories, then try again one level down
+        if (!glob(segments.subspan(1), path, callback, count, visited)) return false;
+
+        for (const auto& [name, directory]: directories) {
+            if (!directory->glob(segments, path / name, callback, count, visited)) return false;
+        }
+        return true;
+    }
+
+    if (segment.type == Segment::Type::Literal) {
+        if (last) {
+            auto it = files.find(segment.pattern);
+            if (it == files.end()) return true;
+
+            ++count;
+            return callback(path / it->first, it->second);
+        }
+
+        auto it = directories.find(segment.pattern);
+        if (it == directories.end()) return true;
+        return it->second->glob(segments.subspan(1), path / it->first, callback, count, visited);
+    }
+
+    if (last) {
+        for (const auto& [name, file]: files) {
+            if (!segment.matches(name)) continue;
+
+            ++count;
+            if (!callback(path / name, file)) return false;
+        }
+        return true;
+    }
+
+    for (const auto& [name, directory]: directories) {
+        if (!segment.matches(name)) continue;
+        if (!directory->glob(segments.subspan(1), path / name, callback, count, visited)) return false;
+    }
+    return true;
+}
+
+int Dvfs::DatVFS::glob(const DatGlob& pattern, const std::function<bool(const DatPath&, IDvfsFile*)>& callback) const {
+    if (!pattern.isValid() || pattern.getSegments().empty()) return 0;
+
+    const auto recursive = std::ranges::count_if(pattern.getSegments(), [](const DatGlob::Segment& segment) {
+        return segment.type == DatGlob::Segment::Type::Recursive;
+    });
+    std::set<std::pair<const DatVFS*, size_t>> visitedSet;
+    std::set<std::pair<const DatVFS*, size_t>>* visited = recursive > 1 ? &visitedSet : nullptr;
+
+    int count = 0;
+    if (root->caseInsensitive) {
+        const DatGlob folded = pattern.foldCase();
+        glob(std::span(folded.getSegments()), DatPath(), callback, count, visited);
+    } else {
+        glob(std::span(pattern.getSegments()), DatPath(), callback, count, visited);
+    }
+    return count;
+}
+
+std::vector<Dvfs::DatPath> Dvfs::DatVFS::glob(const DatGlob& pattern) const {
+    std::vector<DatPath> paths;
+    glob(pattern, [&paths](const DatPath& path, IDvfsFile*) {
+        paths.push_back(path);
+        return true;
+    });
+    return paths;
+}
+
 std::string Dvfs::DatVFS::tree(const std::string& prefix) const {
     std::stringstream stream;
 
@@ -377,13 +891,6 @@ std::string Dvfs::DatVFS::tree(const std::string& prefix) const {
             bool end = std::next(it) == directories.end() && noFiles;
 
             stream << prefix << (end ? "└── " : "├── ") << name << std::endl;
-
-            // Skip infinite recursion
-            if (name == "." || name == "..") {
-                ++it;
-                continue;
-            }
-
             stream << directory->tree(prefix + (end ? "    " : "│   "));
             ++it;
         }
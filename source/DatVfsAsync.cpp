@@ -0,0 +1,22 @@
+#include "../include/DatVfsAsync.h"
+
+void Dvfs::DvfsPoolExecutor::execute(std::function<void()> work) {
+    pool.submit(std::move(work));
+}
+
+Dvfs::DvfsPoolExecutor& Dvfs::DvfsPoolExecutor::getDefault() {
+    static DvfsPoolExecutor executor;
+    return executor;
+}
+
+void Dvfs::DvfsInlineExecutor::execute(const std::function<void()> work) {
+    work();
+}
+
+Dvfs::DvfsRangeRead Dvfs::IDvfsFile::readRange(char* buffer, const uint64_t offset, const uint64_t length) const {
+    return readRange(buffer, offset, length, DvfsPoolExecutor::getDefault());
+}
+
+Dvfs::DvfsRangeRead Dvfs::IDvfsFile::readRange(char* buffer, const uint64_t offset, const uint64_t length, IDvfsExecutor& executor) const {
+    return {*this, buffer, offset, length, executor};
+}
@@ -0,0 +1,70 @@
+#include "../include/DatVfsBufferPool.h"
+
+#include <bit>
+#include <new>
+
+Dvfs::DvfsAlignedBufferPool::Buffer& Dvfs::DvfsAlignedBufferPool::Buffer::operator=(Buffer&& other) noexcept {
+    if (this != &other) {
+        if (memory) pool->release(memory, capacity);
+        pool = std::exchange(other.pool, nullptr);
+        memory = std::exchange(other.memory, nullptr);
+        capacity = std::exchange(other.capacity, 0);
+    }
+    return *this;
+}
+
+Dvfs::DvfsAlignedBufferPool::Buffer::~Buffer() {
+    if (memory) pool->release(memory, capacity);
+}
+
+Dvfs::DvfsAlignedBufferPool::~DvfsAlignedBufferPool() {
+    for (auto& freeList: freeLists) {
+        for (char* memory: freeList) {
+            free(memory);
+        }
+    }
+}
+
+Dvfs::DvfsAlignedBufferPool::Buffer Dvfs::DvfsAlignedBufferPool::acquire(const size_t size) {
+    const size_t capacity = std::bit_ceil(std::max(size, alignment));
+    auto& freeList = freeLists[std::countr_zero(capacity)];
+
+    {
+        std::lock_guard lock(mutex);
+        if (!freeList.empty()) {
+            char* memory = freeList.back();
+            freeList.pop_back();
+            cachedBytes -= capacity;
+            return {this, memory, capacity};
+        }
+    }
+
+    return {this, static_cast<char*>(::operator new(capacity, std::align_val_t(alignment))), capacity};
+}
+
+void Dvfs::DvfsAlignedBufferPool::release(char* memory, const size_t capacity) {
+    {
+        std::lock_guard lock(mutex);
+        if (cachedBytes + capacity <= maxCachedBytes) {
+            freeLists[std::countr_zero(capacity)].push_back(memory);
+            cachedBytes += capacity;
+            return;
+        }
+    }
+
+    free(memory);
+}
+
+void Dvfs::DvfsAlignedBufferPool::free(char* memory) {
+    ::operator delete(memory, std::align_val_t(alignment));
+}
+
+size_t Dvfs::DvfsAlignedBufferPool::getCachedBytes() const {
+    std::lock_guard lock(mutex);
+    return cachedBytes;
+}
+
+Dvfs::DvfsAlignedBufferPool& Dvfs::DvfsAlignedBufferPool::getDefault() {
+    static DvfsAlignedBufferPool pool;
+    return pool;
+}
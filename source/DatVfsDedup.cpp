@@ -0,0 +1,83 @@
+#include "../include/DatVfsDedup.h"
+
+#include <cstring>
+#include <memory>
+
+#include "../include/DatHash.h"
+#include "../include/DatVfsWritableFile.h"
+
+Dvfs::DvfsDeduplicator::DvfsDeduplicator(const uint64_t maxFileSize, const bool verifyContent) :
+        maxFileSize(maxFileSize),
+        verifyContent(verifyContent) {}
+
+bool Dvfs::DvfsDeduplicator::contentEqual(const IDvfsFile& a, const IDvfsFile& b) {
+    const uint64_t size = a.fileSize();
+    std::unique_ptr<char[]> aContent(new char[size]);
+    std::unique_ptr<char[]> bContent(new char[size]);
+
+    if (!a.getContent(aContent.get()) || !b.getContent(bContent.get())) return false;
+    return std::memcmp(aContent.get(), bContent.get(), size) == 0;
+}
+
+Dvfs::IDvfsFile* Dvfs::DvfsDeduplicator::deduplicate(IDvfsFile* file) {
+    if (hashes.contains(file) || !file->isValidFile()) return file;
+    // The content of a writable file changes, so it can't be shared or stand in for another file
+    if (dynamic_cast<const IDvfsWritableFile*>(file) != nullptr) return file;
+
+    const uint64_t size = file->fileSize();
+    if (size > maxFileSize) return file;
+
+    uint64_t hash;
+    if (!hashFile(*file, hash)) return file;
+
+    auto [begin, end] = files.equal_range(hash);
+    for (auto it = begin; it != end; ++it) {
+        IDvfsFile* candidate = it->second;
+        if (candidate->fileSize() != size) continue;
+        if (verifyContent && !contentEqual(*candidate, *file)) continue;
+
+        ++duplicates;
+        bytesSaved += size;
+        return candidate;
+    }
+
+    files.emplace(hash, file);
+    hashes.emplace(file, hash);
+    return file;
+}
+
+void Dvfs::DvfsDeduplicator::forget(const IDvfsFile* file) {
+    auto hashIt = hashes.find(file);
+    if (hashIt == hashes.end()) return;
+
+    auto [begin, end] = files.equal_range(hashIt->second);
+    for (auto it = begin; it != end; ++it) {
+        if (it->second == file) {
+            files.erase(it);
+            break;
+        }
+    }
+
+    hashes.erase(hashIt);
+}
+
+size_t Dvfs::DvfsDeduplicator::size() const {
+    return hashes.size();
+}
+
+uint64_t Dvfs::DvfsDeduplicator::getDuplicateCount() const {
+    return duplicates;
+}
+
+uint64_t Dvfs::DvfsDeduplicator::getBytesSaved() const {
+    return bytesSaved;
+}
+
+bool Dvfs::DvfsDeduplicator::hashFile(const IDvfsFile& file, uint64_t& hash) {
+    const uint64_t size = file.fileSize();
+    std::unique_ptr<char[]> content(new char[size]);
+    if (!file.getContent(content.get())) return false;
+
+    hash = DvfsHasher::hash(content.get(), size);
+    return true;
+}
@@ -0,0 +1,107 @@
+#include "../include/DatVfsDescriptorCache.h"
+
+#if __has_include(<fcntl.h>) && __has_include(<unistd.h>) && __has_include(<sys/stat.h>)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define DATVFS_DESCRIPTOR_CACHE
+#endif
+
+Dvfs::DvfsDescriptorCache::Descriptor::~Descriptor() {
+#ifdef DATVFS_DESCRIPTOR_CACHE
+    close(fd);
+#endif
+}
+
+bool Dvfs::DvfsDescriptorCache::Descriptor::read(char* buffer, const uint64_t offset, const uint64_t length) const {
+#ifdef DATVFS_DESCRIPTOR_CACHE
+    uint64_t done = 0;
+    while (done < length) {
+        const ssize_t count = pread(fd, buffer + done, length - done, static_cast<off_t>(offset + done));
+        if (count <= 0) return false;
+        done += static_cast<uint64_t>(count);
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::shared_ptr<const Dvfs::DvfsDescriptorCache::Descriptor> Dvfs::DvfsDescriptorCache::acquire(const void* key, const std::filesystem::path& path, uint64_t& size) {
+#ifdef DATVFS_DESCRIPTOR_CACHE
+    // Checking the path on every read is what keeps a deleted or replaced file from being read through its old descriptor
+    struct stat status{};
+    if (stat(path.c_str(), &status) != 0 || S_ISDIR(status.st_mode)) {
+        evict(key);
+        return nullptr;
+    }
+
+    {
+        std::lock_guard lock(mutex);
+        auto it = lookup.find(key);
+        if (it != lookup.end()) {
+            const std::shared_ptr<const Descriptor>& descriptor = it->second->descriptor;
+            if (descriptor->isFile(status.st_dev, status.st_ino)) {
+                ++hits;
+                entries.splice(entries.begin(), entries, it->second);
+                size = static_cast<uint64_t>(status.st_size);
+                return descriptor;
+            }
+
+            remove(key);
+        }
+        ++misses;
+    }
+
+    // Opening happens outside the lock, the file is checked through the descriptor in case it changed since the stat
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return nullptr;
+
+    if (fstat(fd, &status) != 0 || S_ISDIR(status.st_mode)) {
+        close(fd);
+        return nullptr;
+    }
+
+    auto descriptor = std::make_shared<const Descriptor>(fd, status.st_dev, status.st_ino);
+    size = static_cast<uint64_t>(status.st_size);
+
+    std::lock_guard lock(mutex);
+    // Another thread may have opened the same file in the meantime
+    remove(key);
+    entries.push_front({key, descriptor});
+    lookup.emplace(key, entries.begin());
+
+    while (entries.size() > maxOpen) {
+        lookup.erase(entries.back().key);
+        entries.pop_back();
+        ++evictions;
+    }
+    return descriptor;
+#else
+    return nullptr;
+#endif
+}
+
+void Dvfs::DvfsDescriptorCache::remove(const void* key) {
+    auto it = lookup.find(key);
+    if (it == lookup.end()) return;
+
+    entries.erase(it->second);
+    lookup.erase(it);
+}
+
+void Dvfs::DvfsDescriptorCache::evict(const void* key) {
+    std::lock_guard lock(mutex);
+    remove(key);
+}
+
+void Dvfs::DvfsDescriptorCache::clear() {
+    std::lock_guard lock(mutex);
+    lookup.clear();
+    entries.clear();
+}
+
+Dvfs::DvfsDescriptorCache::Stats Dvfs::DvfsDescriptorCache::getStats() const {
+    std::lock_guard lock(mutex);
+    return {hits, misses, evictions, entries.size()};
+}
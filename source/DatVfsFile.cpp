@@ -1,34 +1,216 @@
 #include "../include/DatVfsFile.h"
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <vector>
 
-uint8_t Dvfs::IDvfsFile::incrementReferences() {
-    return ++references;
+#include "../include/DatVfsBufferPool.h"
+#include "../include/DatVfsDescriptorCache.h"
+
+#if __has_include(<fcntl.h>) && __has_include(<unistd.h>)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if __has_include(<sys/stat.h>)
+#include <sys/stat.h>
+#endif
+
+uint32_t Dvfs::IDvfsFile::incrementReferences() {
+    // Taking a reference needs no ordering, the caller already has access to the file
+    return references.fetch_add(1, std::memory_order_relaxed) + 1;
 }
 
-uint8_t Dvfs::IDvfsFile::decrementReferences() {
-    return --references;
+uint32_t Dvfs::IDvfsFile::decrementReferences() {
+    // Releasing has to be ordered so whoever drops the last reference sees every other thread's use of the file
+    return references.fetch_sub(1, std::memory_order_acq_rel) - 1;
 }
 
-uint8_t Dvfs::IDvfsFile::getReferenceCount() const {
-    return references;
+uint32_t Dvfs::IDvfsFile::getReferenceCount() const {
+    return references.load(std::memory_order_relaxed);
+}
+
+bool Dvfs::IDvfsFile::getContentRange(char* buffer, const uint64_t offset, const uint64_t length) const {
+    const uint64_t size = fileSize();
+    if (offset > size || length > size - offset) return false;
+
+    std::vector<char> content(size);
+    if (!getContent(content.data())) return false;
+
+    std::memcpy(buffer, content.data() + offset, length);
+    return true;
+}
+
+Dvfs::LooseDvfsFile::~LooseDvfsFile() {
+    forgetDescriptor(this);
 }
 
 uint64_t Dvfs::LooseDvfsFile::fileSize() const {
-    return isValidFile() ? file_size(filePath) : 0;
+    return sizeAt(filePath);
 }
 
 bool Dvfs::LooseDvfsFile::isValidFile() const {
-    return !filePath.empty() && exists(filePath) && !is_directory(filePath);
+    return isValidAt(filePath);
 }
 
+std::atomic<uint64_t> Dvfs::LooseDvfsFile::directReadThreshold = 0;
+std::atomic<Dvfs::DvfsDescriptorCache*> Dvfs::LooseDvfsFile::descriptorCache = nullptr;
+
 bool Dvfs::LooseDvfsFile::getContent(char* buffer) const {
-    if (!isValidFile()) return false;
+    return readAt(filePath, this, buffer, 0, wholeFile);
+}
+
+bool Dvfs::LooseDvfsFile::getContentRange(char* buffer, const uint64_t offset, const uint64_t length) const {
+    return readAt(filePath, this, buffer, offset, length);
+}
+
+void Dvfs::LooseDvfsFile::prefetch() const {
+    prefetchAt(filePath);
+}
+
+Dvfs::DvfsFileLocation Dvfs::LooseDvfsFile::getLocation() const {
+    return locationAt(filePath);
+}
+
+uint64_t Dvfs::LooseDvfsFile::sizeAt(const std::filesystem::path& path) {
+    return isValidAt(path) ? file_size(path) : 0;
+}
+
+bool Dvfs::LooseDvfsFile::isValidAt(const std::filesystem::path& path) {
+    return !path.empty() && exists(path) && !is_directory(path);
+}
+
+bool Dvfs::LooseDvfsFile::readAt(const std::filesystem::path& path, const void* cacheKey, char* buffer, const uint64_t offset, uint64_t length) {
+    std::shared_ptr<const DvfsDescriptorCache::Descriptor> descriptor;
+    uint64_t size = 0;
+
+    DvfsDescriptorCache* cache = descriptorCache.load(std::memory_order_acquire);
+    if (cache != nullptr) descriptor = cache->acquire(cacheKey, path, size);
+
+    // Without a descriptor the file is read by path, which also covers platforms the cache doesn't support
+    if (!descriptor) {
+        if (!isValidAt(path)) return false;
+        size = file_size(path);
+    }
+
+    if (length == wholeFile) length = size;
+    if (offset > size || length > size - offset) return false;
+
+    const uint64_t threshold = directReadThreshold.load(std::memory_order_relaxed);
+    if (threshold != 0 && length >= threshold && readDirect(path, buffer, offset, length)) return true;
+
+    if (descriptor) return descriptor->read(buffer, offset, length);
+
+    std::ifstream fileStream(path, std::ios::in | std::ios::binary);
+    fileStream.seekg(static_cast<std::streamoff>(offset));
+
+    return fileStream.read(buffer, static_cast<std::streamsize>(length)).good();
+}
+
+void Dvfs::LooseDvfsFile::prefetchAt(const std::filesystem::path& path) {
+#ifdef POSIX_FADV_WILLNEED
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+
+    // Asks the kernel to start reading the file into the page cache without waiting for it
+    posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+    close(fd);
+#else
+    // Without readahead hints, warm the OS cache by reading the file through
+    std::ifstream fileStream(path, std::ios::in | std::ios::binary);
+    char buffer[64 * 1024];
+    while (fileStream.read(buffer, sizeof(buffer)) || fileStream.gcount() > 0) {}
+#endif
+}
+
+Dvfs::DvfsFileLocation Dvfs::LooseDvfsFile::locationAt(const std::filesystem::path& path) {
+#if __has_include(<sys/stat.h>)
+    struct stat status{};
+    if (stat(path.c_str(), &status) != 0) return {};
+
+    return {static_cast<uint64_t>(status.st_dev), static_cast<uint64_t>(status.st_ino)};
+#else
+    return {};
+#endif
+}
+
+void Dvfs::LooseDvfsFile::forgetDescriptor(const void* cacheKey) {
+    // Another file could be created at the same address, which must not be handed this file's descriptor
+    DvfsDescriptorCache* cache = descriptorCache.load(std::memory_order_acquire);
+    if (cache != nullptr) cache->evict(cacheKey);
+}
+
+void Dvfs::LooseDvfsFile::setDirectReadThreshold(const uint64_t bytes) {
+    directReadThreshold.store(bytes, std::memory_order_relaxed);
+}
+
+uint64_t Dvfs::LooseDvfsFile::getDirectReadThreshold() {
+    return directReadThreshold.load(std::memory_order_relaxed);
+}
+
+void Dvfs::LooseDvfsFile::setDescriptorCache(DvfsDescriptorCache* cache) {
+    descriptorCache.store(cache, std::memory_order_release);
+}
+
+Dvfs::DvfsDescriptorCache* Dvfs::LooseDvfsFile::getDescriptorCache() {
+    return descriptorCache.load(std::memory_order_acquire);
+}
+
+bool Dvfs::LooseDvfsFile::readDirect(const std::filesystem::path& path, char* buffer, const uint64_t offset, const uint64_t length) {
+#if defined(O_DIRECT) && __has_include(<unistd.h>)
+    constexpr uint64_t alignment = DvfsAlignedBufferPool::alignment;
+    // Large reads through an aligned buffer are split up so the buffer doesn't have to hold the whole file
+    constexpr uint64_t maxBounceSize = 1024 * 1024;
+
+    // Filesystems without direct I/O reject the open, or the first read, and the caller falls back to a normal read
+    const int fd = open(path.c_str(), O_RDONLY | O_DIRECT);
+    if (fd < 0) return false;
+
+    bool success = true;
+    uint64_t done = 0;
+
+    // Read straight into the buffer for as long as both it and the file position are aligned
+    if (reinterpret_cast<uintptr_t>(buffer) % alignment == 0 && offset % alignment == 0) {
+        const uint64_t alignedLength = length / alignment * alignment;
+        while (done < alignedLength) {
+            const ssize_t count = pread(fd, buffer + done, alignedLength - done, static_cast<off_t>(offset + done));
+            if (count <= 0) {
+                success = false;
+                break;
+            }
+            done += static_cast<uint64_t>(count);
+            // A short read can leave the position unaligned, so carry on through the aligned buffer
+            if (count % alignment != 0) break;
+        }
+    }
+
+    // Read the rest through an aligned buffer, starting each read at the aligned position before the data
+    if (success && done < length) {
+        const uint64_t firstSkip = (offset + done) % alignment;
+        DvfsAlignedBufferPool::Buffer bounce = DvfsAlignedBufferPool::getDefault().acquire(
+                std::min(maxBounceSize, (firstSkip + length - done + alignment - 1) / alignment * alignment));
+
+        while (done < length) {
+            const uint64_t position = offset + done;
+            const uint64_t skip = position % alignment;
+            const uint64_t wanted = std::min<uint64_t>(bounce.size(), (skip + length - done + alignment - 1) / alignment * alignment);
 
-    std::ifstream fileStream(filePath, std::ios::in | std::ios::binary | std::ios::ate);
+            const ssize_t count = pread(fd, bounce.data(), wanted, static_cast<off_t>(position - skip));
+            if (count <= 0 || static_cast<uint64_t>(count) <= skip) {
+                success = false;
+                break;
+            }
 
-    std::streamsize fileSize = fileStream.tellg();
-    fileStream.seekg(0);
+            const uint64_t copied = std::min(static_cast<uint64_t>(count) - skip, length - done);
+            std::memcpy(buffer + done, bounce.data() + skip, copied);
+            done += copied;
+        }
+    }
 
-    return fileStream.read(buffer, fileSize).good();
+    close(fd);
+    return success;
+#else
+    return false;
+#endif
 }
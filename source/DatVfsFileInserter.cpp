@@ -1,18 +1,82 @@
 #include "../include/DatVfsFileInserter.h"
 
-#include <functional>
+#include <cassert>
 
-void Dvfs::IDvfsFileInserter::handleInsertFailure(const std::string& path, Dvfs::IDvfsFile* idvfsFile) const {
-    delete idvfsFile;
+namespace {
+    // The inserter whose default forEachFile is asking getAllFiles for its files on this thread, so an inserter that
+    // overrides neither is caught rather than recursing forever
+    thread_local const Dvfs::IDvfsFileInserter* collecting = nullptr;
+
+    /**
+     * Marks an inserter as collecting for as long as it's alive, putting the outer marker back even if collecting throws
+     */
+    struct CollectingScope {
+        const Dvfs::IDvfsFileInserter* previous;
+
+        explicit CollectingScope(const Dvfs::IDvfsFileInserter* inserter) : previous(collecting) {
+            collecting = inserter;
+        }
+
+        CollectingScope(const CollectingScope&) = delete;
+        CollectingScope& operator=(const CollectingScope&) = delete;
+
+        ~CollectingScope() {
+            collecting = previous;
+        }
+    };
 }
 
-std::vector<Dvfs::DvfsLooseFileInserter::pair> Dvfs::DvfsLooseFileInserter::getAllFiles() const {
+std::vector<Dvfs::IDvfsFileInserter::pair> Dvfs::IDvfsFileInserter::getAllFiles() const {
+    assert(collecting != this && "Inserters must override getAllFiles or forEachFile");
+    if (collecting == this) return {};
+
     std::vector<pair> files;
+    files.reserve(getSizeHint());
+
+    forEachFile([&files](std::string_view path, IDvfsFile* idvfsFile) {
+        files.emplace_back(path, idvfsFile);
+        return true;
+    });
+
+    return files;
+}
+
+void Dvfs::IDvfsFileInserter::forEachFile(const Visitor& visitor) const {
+    // getAllFiles may stream another inserter, so the outer marker is put back afterwards
+    std::vector<pair> files;
+    {
+        CollectingScope scope(this);
+        files = getAllFiles();
+    }
+
+    for (const auto& [path, idvfsFile]: files) {
+        if (!visitor(path, idvfsFile)) return;
+    }
+}
+
+size_t Dvfs::IDvfsFileInserter::getSizeHint() const {
+    return 0;
+}
+
+void Dvfs::IDvfsFileInserter::handleInsertFailure(const std::string& path, Dvfs::IDvfsFile* idvfsFile) const {
+    // Files the inserter shares with a VFS are still owned by it
+    if (idvfsFile->getReferenceCount() == 0) delete idvfsFile;
+}
+
+void Dvfs::DvfsLooseFileInserter::forEachFile(const Visitor& visitor) const {
+    // Every file of the mount lives in one slab, which is freed once they've all been deleted
+    const auto releaseSlab = [](DvfsFileSlab* slab) { slab->release(); };
+    const std::unique_ptr<DvfsFileSlab, decltype(releaseSlab)> slab(DvfsFileSlab::create(), releaseSlab);
+
+    // The files only store their path relative to the directory, so it's stored once for all of them
+    auto* root = new(slab->allocate(sizeof(std::string_view), alignof(std::string_view)))
+            std::string_view(slab->storeString(directory.string()));
 
     for (const auto& it: std::filesystem::recursive_directory_iterator(directory)) {
         if (it.is_directory()) continue;
-        files.emplace_back(std::filesystem::relative(it.path(), directory).string(), new LooseDvfsFile(it.path()));
-    }
 
-    return files;
+        // Generic paths always use '/', which is what DatPath expects
+        const std::string path = std::filesystem::relative(it.path(), directory).generic_string();
+        if (!visitor(path, slab->createFile<SlabLooseDvfsFile>(root, path))) return;
+    }
 }
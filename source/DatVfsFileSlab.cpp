@@ -0,0 +1,100 @@
+#include "../include/DatVfsFileSlab.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+void Dvfs::SlabDvfsFile::operator delete(SlabDvfsFile* file, std::destroying_delete_t) {
+    DvfsFileSlab* slab = file->slab;
+    file->~SlabDvfsFile();
+    slab->unreference(2);
+}
+
+Dvfs::DvfsFileSlab* Dvfs::DvfsFileSlab::create(const size_t chunkSize) {
+    return new DvfsFileSlab(chunkSize);
+}
+
+void* Dvfs::DvfsFileSlab::allocate(const size_t size, const size_t alignment) {
+    const size_t padding = (alignment - reinterpret_cast<uintptr_t>(current) % alignment) % alignment;
+
+    if (current == nullptr || padding + size > remaining) {
+        // New chunks come from operator new so are already aligned for anything but over-aligned types
+        const size_t newChunkSize = std::max(chunkSize, size + alignment);
+        chunks.emplace_back(new std::byte[newChunkSize]);
+        memoryUsage += newChunkSize;
+
+        current = chunks.back().get();
+        remaining = newChunkSize;
+        return allocate(size, alignment);
+    }
+
+    void* memory = current + padding;
+    current += padding + size;
+    remaining -= padding + size;
+    return memory;
+}
+
+std::string_view Dvfs::DvfsFileSlab::storeString(const std::string_view string) {
+    if (string.empty()) return {};
+
+    char* memory = static_cast<char*>(allocate(string.size(), 1));
+    std::memcpy(memory, string.data(), string.size());
+    return {memory, string.size()};
+}
+
+void Dvfs::DvfsFileSlab::unreference(const size_t count) {
+    // The last reference has to see every other thread's use of the files before the memory is freed
+    if (references.fetch_sub(count, std::memory_order_acq_rel) == count) delete this;
+}
+
+void Dvfs::DvfsFileSlab::release() {
+    unreference(1);
+}
+
+size_t Dvfs::DvfsFileSlab::getFileCount() const {
+    // The lowest bit is the creator's reference
+    return references.load(std::memory_order_relaxed) / 2;
+}
+
+size_t Dvfs::DvfsFileSlab::getMemoryUsage() const {
+    return memoryUsage;
+}
+
+Dvfs::SlabLooseDvfsFile::~SlabLooseDvfsFile() {
+    LooseDvfsFile::forgetDescriptor(this);
+}
+
+std::filesystem::path Dvfs::SlabLooseDvfsFile::getFilePath() const {
+    // Joining as a string first gives the path its storage in one go, rather than growing it a component at a time
+    std::string path;
+    path.reserve(root->size() + 1 + relativePath.size());
+    path.append(*root);
+    if (!path.empty() && path.back() != '/') path += '/';
+    path.append(relativePath);
+    return path;
+}
+
+uint64_t Dvfs::SlabLooseDvfsFile::fileSize() const {
+    return LooseDvfsFile::sizeAt(getFilePath());
+}
+
+bool Dvfs::SlabLooseDvfsFile::isValidFile() const {
+    return LooseDvfsFile::isValidAt(getFilePath());
+}
+
+bool Dvfs::SlabLooseDvfsFile::getContent(char* buffer) const {
+    return LooseDvfsFile::readAt(getFilePath(), this, buffer, 0, LooseDvfsFile::wholeFile);
+}
+
+bool Dvfs::SlabLooseDvfsFile::getContentRange(char* buffer, const uint64_t offset, const uint64_t length) const {
+    return LooseDvfsFile::readAt(getFilePath(), this, buffer, offset, length);
+}
+
+void Dvfs::SlabLooseDvfsFile::prefetch() const {
+    LooseDvfsFile::prefetchAt(getFilePath());
+}
+
+Dvfs::DvfsFileLocation Dvfs::SlabLooseDvfsFile::getLocation() const {
+    return LooseDvfsFile::locationAt(getFilePath());
+}
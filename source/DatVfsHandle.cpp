@@ -0,0 +1,49 @@
+#include "../include/DatVfsHandle.h"
+
+#include <mutex>
+
+Dvfs::DvfsFileHandle Dvfs::DvfsHandleTable::acquire(IDvfsFile* file) {
+    std::unique_lock lock(mutex);
+    auto [it, inserted] = fileSlots.try_emplace(file, freeHead);
+    if (!inserted) return {it->second, slots[it->second].generation};
+
+    // Reuse a free slot if there is one, its generation was already bumped when it was freed
+    if (freeHead != noSlot) {
+        freeHead = slots[freeHead].nextFree;
+    } else {
+        it->second = static_cast<uint32_t>(slots.size());
+        slots.emplace_back();
+    }
+
+    Slot& slot = slots[it->second];
+    slot.file = file;
+    return {it->second, slot.generation};
+}
+
+void Dvfs::DvfsHandleTable::release(const IDvfsFile* file) {
+    std::unique_lock lock(mutex);
+    auto it = fileSlots.find(file);
+    if (it == fileSlots.end()) return;
+
+    Slot& slot = slots[it->second];
+    slot.file = nullptr;
+    // Skip generation 0 on wrap around, so the null handle never resolves
+    if (++slot.generation == 0) slot.generation = 1;
+    slot.nextFree = freeHead;
+
+    freeHead = it->second;
+    fileSlots.erase(it);
+}
+
+Dvfs::IDvfsFile* Dvfs::DvfsHandleTable::resolve(const DvfsFileHandle handle) const {
+    std::shared_lock lock(mutex);
+    if (handle.index >= slots.size()) return nullptr;
+
+    const Slot& slot = slots[handle.index];
+    return slot.generation == handle.generation ? slot.file : nullptr;
+}
+
+size_t Dvfs::DvfsHandleTable::size() const {
+    std::shared_lock lock(mutex);
+    return fileSlots.size();
+}
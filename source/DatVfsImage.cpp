@@ -0,0 +1,359 @@
+#include "../include/DatVfsImage.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <unordered_map>
+
+#include "../include/DatVfs.h"
+#include "../include/DatVfsFileSlab.h"
+
+#if __has_include(<sys/mman.h>) && __has_include(<fcntl.h>) && __has_include(<unistd.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define DATVFS_IMAGE_MMAP
+#endif
+
+namespace {
+    constexpr char imageMagic[8] = {'D', 'V', 'F', 'S', 'I', 'M', 'G', '\0'};
+
+    /**
+     * Round a size up so the next section of the image is aligned
+     */
+    size_t alignSection(size_t size) {
+        return (size + 7) & ~size_t(7);
+    }
+
+    /**
+     * Append a section to the image
+     * @return The offset of the section
+     */
+    template<typename T>
+    uint64_t appendSection(std::vector<char>& image, std::span<const T> section) {
+        const size_t offset = image.size();
+        const size_t size = section.size_bytes();
+        image.resize(alignSection(offset + size));
+        if (size != 0) std::memcpy(image.data() + offset, section.data(), size);
+        return offset;
+    }
+
+    /**
+     * View a section of the image as an array of records
+     * @return The records, or an empty span if the section doesn't fit in the image
+     */
+    template<typename T>
+    std::span<const T> viewSection(std::span<const char> image, uint64_t offset, uint64_t count, bool& valid) {
+        if (offset % alignof(T) != 0 || offset > image.size() || count > (image.size() - offset) / sizeof(T)) {
+            valid = false;
+            return {};
+        }
+        return {reinterpret_cast<const T*>(image.data() + offset), static_cast<size_t>(count)};
+    }
+}
+
+Dvfs::DvfsImage::~DvfsImage() {
+    if (decoded && header != nullptr) {
+        for (size_t i = 0; i < header->fileCount; ++i) {
+            delete decoded[i].load(std::memory_order_relaxed);
+        }
+    }
+
+#ifdef DATVFS_IMAGE_MMAP
+    if (mapping != nullptr) munmap(mapping, mappingSize);
+#endif
+}
+
+std::vector<char> Dvfs::DvfsImage::build(const DatVFS& vfs, const Encoder& encoder) {
+    std::vector<Directory> directoryRecords;
+    std::vector<Entry> directoryEntryRecords;
+    std::vector<Entry> fileEntryRecords;
+    std::vector<File> fileRecords;
+    std::string nameData;
+    std::string payloadData;
+
+    // Identical names are common, so each is only stored once
+    std::unordered_map<std::string, uint32_t> nameOffsets;
+    // Files mounted at several paths share a record
+    std::unordered_map<const IDvfsFile*, uint32_t> fileIndices;
+
+    constexpr size_t limit = std::numeric_limits<uint32_t>::max();
+    bool tooLarge = false;
+
+    const auto addEntry = [&](std::vector<Entry>& entries, const std::string& name, size_t target) {
+        auto [it, inserted] = nameOffsets.try_emplace(name, static_cast<uint32_t>(nameData.size()));
+        if (inserted) nameData += name;
+
+        tooLarge |= nameData.size() > limit || target > limit;
+        entries.push_back({it->second, static_cast<uint32_t>(name.size()), static_cast<uint32_t>(target)});
+    };
+
+    // Directories are numbered breadth first, so the children of each directory are stored together
+    std::vector<const DatVFS*> queue = {&vfs};
+    for (size_t i = 0; i < queue.size(); ++i) {
+        const DatVFS* directory = queue[i];
+
+        std::vector<std::string> directoryNames = directory->listDirectories();
+        std::vector<std::string> fileNames = directory->listFiles();
+        std::ranges::sort(directoryNames);
+        std::ranges::sort(fileNames);
+
+        directoryRecords.push_back({
+                static_cast<uint32_t>(directoryEntryRecords.size()),
+                static_cast<uint32_t>(directoryNames.size()),
+                static_cast<uint32_t>(fileEntryRecords.size()),
+                static_cast<uint32_t>(fileNames.size())
+        });
+
+        for (const std::string& name: directoryNames) {
+            addEntry(directoryEntryRecords, name, queue.size());
+            queue.push_back(directory->getDirectory(DatPathView(DatPath(name))));
+        }
+
+        for (const std::string& name: fileNames) {
+            const IDvfsFile* file = directory->getFile(DatPathView(DatPath(name)));
+
+            auto [it, inserted] = fileIndices.try_emplace(file, static_cast<uint32_t>(fileRecords.size()));
+            if (inserted) {
+                const std::string payload = encoder(*file);
+                fileRecords.push_back({payloadData.size(), payload.size()});
+                payloadData += payload;
+            }
+
+            addEntry(fileEntryRecords, name, it->second);
+        }
+    }
+
+    if (tooLarge || directoryEntryRecords.size() > limit || fileEntryRecords.size() > limit) return {};
+
+    Header header{};
+    std::memcpy(header.magic, imageMagic, sizeof(imageMagic));
+    header.version = version;
+    header.caseInsensitive = vfs.isCaseInsensitive();
+    header.directoryCount = static_cast<uint32_t>(directoryRecords.size());
+    header.directoryEntryCount = static_cast<uint32_t>(directoryEntryRecords.size());
+    header.fileEntryCount = static_cast<uint32_t>(fileEntryRecords.size());
+    header.fileCount = static_cast<uint32_t>(fileRecords.size());
+
+    std::vector<char> image(alignSection(sizeof(Header)));
+    header.directoriesOffset = appendSection(image, std::span<const Directory>(directoryRecords));
+    header.directoryEntriesOffset = appendSection(image, std::span<const Entry>(directoryEntryRecords));
+    header.fileEntriesOffset = appendSection(image, std::span<const Entry>(fileEntryRecords));
+    header.filesOffset = appendSection(image, std::span<const File>(fileRecords));
+    header.namesOffset = appendSection(image, std::span<const char>(nameData));
+    header.namesSize = nameData.size();
+    header.payloadsOffset = appendSection(image, std::span<const char>(payloadData));
+    header.payloadsSize = payloadData.size();
+
+    std::memcpy(image.data(), &header, sizeof(Header));
+    return image;
+}
+
+bool Dvfs::DvfsImage::write(const DatVFS& vfs, const std::filesystem::path& path, const Encoder& encoder) {
+    const std::vector<char> image = build(vfs, encoder);
+    if (image.empty()) return false;
+
+    std::ofstream stream(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    return stream.write(image.data(), static_cast<std::streamsize>(image.size())).good();
+}
+
+std::unique_ptr<Dvfs::DvfsImage> Dvfs::DvfsImage::open(const std::filesystem::path& path, Decoder decoder) {
+#ifdef DATVFS_IMAGE_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+
+    struct stat status{};
+    if (fstat(fd, &status) != 0 || status.st_size <= 0) {
+        close(fd);
+        return nullptr;
+    }
+
+    const auto size = static_cast<size_t>(status.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping stays valid once the file is closed
+    close(fd);
+    if (mapping == MAP_FAILED) return nullptr;
+
+    std::unique_ptr<DvfsImage> image(new DvfsImage);
+    image->mapping = mapping;
+    image->mappingSize = size;
+    if (!image->attach({static_cast<const char*>(mapping), size}, std::move(decoder))) return nullptr;
+    return image;
+#else
+    std::ifstream stream(path, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!stream) return nullptr;
+
+    std::vector<char> buffer(static_cast<size_t>(stream.tellg()));
+    stream.seekg(0);
+    if (!stream.read(buffer.data(), static_cast<std::streamsize>(buffer.size()))) return nullptr;
+
+    return load(std::move(buffer), std::move(decoder));
+#endif
+}
+
+std::unique_ptr<Dvfs::DvfsImage> Dvfs::DvfsImage::load(std::vector<char> image, Decoder decoder) {
+    std::unique_ptr<DvfsImage> dvfsImage(new DvfsImage);
+    dvfsImage->buffer = std::move(image);
+    if (!dvfsImage->attach(dvfsImage->buffer, std::move(decoder))) return nullptr;
+    return dvfsImage;
+}
+
+bool Dvfs::DvfsImage::attach(const std::span<const char> data, Decoder imageDecoder) {
+    if (data.size() < sizeof(Header)) return false;
+    // Records are read straight from the image, so it has to be aligned like them
+    if (reinterpret_cast<uintptr_t>(data.data()) % alignof(Header) != 0) return false;
+
+    const auto* imageHeader = reinterpret_cast<const Header*>(data.data());
+    if (std::memcmp(imageHeader->magic, imageMagic, sizeof(imageMagic)) != 0) return false;
+    if (imageHeader->version != version || imageHeader->directoryCount == 0) return false;
+
+    bool valid = true;
+    directories = viewSection<Directory>(data, imageHeader->directoriesOffset, imageHeader->directoryCount, valid);
+    directoryEntries = viewSection<Entry>(data, imageHeader->directoryEntriesOffset, imageHeader->directoryEntryCount, valid);
+    fileEntries = viewSection<Entry>(data, imageHeader->fileEntriesOffset, imageHeader->fileEntryCount, valid);
+    files = viewSection<File>(data, imageHeader->filesOffset, imageHeader->fileCount, valid);
+    const std::span<const char> nameData = viewSection<char>(data, imageHeader->namesOffset, imageHeader->namesSize, valid);
+    const std::span<const char> payloadData = viewSection<char>(data, imageHeader->payloadsOffset, imageHeader->payloadsSize, valid);
+    if (!valid) return false;
+
+    image = data;
+    header = imageHeader;
+    names = {nameData.data(), nameData.size()};
+    payloads = {payloadData.data(), payloadData.size()};
+    decoder = std::move(imageDecoder);
+    decoded = std::make_unique<std::atomic<IDvfsFile*>[]>(header->fileCount);
+    return true;
+}
+
+std::string_view Dvfs::DvfsImage::getName(const Entry& entry) const {
+    if (entry.nameOffset > names.size() || entry.nameLength > names.size() - entry.nameOffset) return {};
+    return names.substr(entry.nameOffset, entry.nameLength);
+}
+
+const Dvfs::DvfsImage::Entry* Dvfs::DvfsImage::findEntry(const std::span<const Entry> entries, const std::string_view name) const {
+    const auto it = std::ranges::lower_bound(entries, name, {}, [this](const Entry& entry) {
+        return getName(entry);
+    });
+
+    if (it == entries.end() || getName(*it) != name) return nullptr;
+    return &*it;
+}
+
+std::span<const Dvfs::DvfsImage::Entry> Dvfs::DvfsImage::getEntries(const Directory& directory, const bool fileEntries) const {
+    const std::span<const Entry> entries = fileEntries ? this->fileEntries : directoryEntries;
+    const uint32_t first = fileEntries ? directory.firstFile : directory.firstDirectory;
+    const uint32_t count = fileEntries ? directory.fileCount : directory.directoryCount;
+
+    if (first > entries.size() || count > entries.size() - first) return {};
+    return entries.subspan(first, count);
+}
+
+const Dvfs::DvfsImage::Directory* Dvfs::DvfsImage::findDirectory(const std::span<const std::string_view> sections) const {
+    const Directory* directory = &directories[0];
+    for (const std::string_view section: sections) {
+        const Entry* entry = findEntry(getEntries(*directory, false), section);
+        if (entry == nullptr || entry->target >= directories.size()) return nullptr;
+
+        directory = &directories[entry->target];
+    }
+    return directory;
+}
+
+std::vector<std::string_view> Dvfs::DvfsImage::splitPath(const DatPath& path) const {
+    return path.split(header->caseInsensitive != 0);
+}
+
+std::vector<std::string> Dvfs::DvfsImage::list(const DatPath& path, const bool fileEntries) const {
+    const std::vector<std::string_view> sections = splitPath(path);
+    const Directory* directory = findDirectory(sections);
+    if (directory == nullptr) return {};
+
+    std::vector<std::string> entryNames;
+    const std::span<const Entry> entries = getEntries(*directory, fileEntries);
+    entryNames.reserve(entries.size());
+    for (const Entry& entry: entries) {
+        entryNames.emplace_back(getName(entry));
+    }
+    return entryNames;
+}
+
+std::string Dvfs::DvfsImage::encodeLooseFile(const IDvfsFile& file) {
+    if (const auto* looseFile = dynamic_cast<const LooseDvfsFile*>(&file)) {
+        return looseFile->getFilePath().string();
+    }
+    if (const auto* slabFile = dynamic_cast<const SlabLooseDvfsFile*>(&file)) {
+        return slabFile->getFilePath().string();
+    }
+    return {};
+}
+
+Dvfs::IDvfsFile* Dvfs::DvfsImage::decodeLooseFile(const std::string_view payload) {
+    return new LooseDvfsFile(std::filesystem::path(payload));
+}
+
+Dvfs::IDvfsFile* Dvfs::DvfsImage::getFile(const DatPath& path) const {
+    const std::vector<std::string_view> sections = splitPath(path);
+    if (sections.empty()) return nullptr;
+
+    const Directory* directory = findDirectory(std::span(sections).first(sections.size() - 1));
+    if (directory == nullptr) return nullptr;
+
+    const Entry* entry = findEntry(getEntries(*directory, true), sections.back());
+    if (entry == nullptr || entry->target >= files.size()) return nullptr;
+
+    std::atomic<IDvfsFile*>& slot = decoded[entry->target];
+    IDvfsFile* file = slot.load(std::memory_order_acquire);
+    if (file != nullptr) return file;
+
+    const File& record = files[entry->target];
+    if (record.payloadOffset > payloads.size() || record.payloadLength > payloads.size() - record.payloadOffset) return nullptr;
+
+    file = decoder(payloads.substr(record.payloadOffset, record.payloadLength));
+    if (file == nullptr) return nullptr;
+
+    // Another thread may have decoded the file at the same time, only one of them is kept
+    IDvfsFile* expected = nullptr;
+    if (!slot.compare_exchange_strong(expected, file, std::memory_order_acq_rel)) {
+        delete file;
+        return expected;
+    }
+    return file;
+}
+
+int Dvfs::DvfsImage::exists(const DatPath& path) const {
+    const std::vector<std::string_view> sections = splitPath(path);
+    if (sections.empty()) return 0;
+
+    const Directory* directory = findDirectory(std::span(sections).first(sections.size() - 1));
+    if (directory == nullptr) return 0;
+
+    if (findEntry(getEntries(*directory, true), sections.back()) != nullptr) return 1;
+    if (findEntry(getEntries(*directory, false), sections.back()) != nullptr) return -1;
+    return 0;
+}
+
+std::vector<std::string> Dvfs::DvfsImage::listFiles(const DatPath& path) const {
+    return list(path, true);
+}
+
+std::vector<std::string> Dvfs::DvfsImage::listDirectories(const DatPath& path) const {
+    return list(path, false);
+}
+
+bool Dvfs::DvfsImage::isCaseInsensitive() const {
+    return header->caseInsensitive != 0;
+}
+
+size_t Dvfs::DvfsImage::getFileCount() const {
+    return header->fileCount;
+}
+
+size_t Dvfs::DvfsImage::getDirectoryCount() const {
+    return header->directoryCount;
+}
+
+bool Dvfs::DvfsImage::isMapped() const {
+    return mapping != nullptr;
+}
@@ -0,0 +1,115 @@
+#include "../include/DatVfsIndex.h"
+
+void Dvfs::DvfsFileIndex::removeFromBucket(Bucket& bucket, const size_t slot, const bool tagBucket) {
+    if (slot != bucket.size() - 1) {
+        bucket[slot] = bucket.back();
+
+        // Point the moved entry's location at its new slot
+        Location& moved = locations.at(bucket[slot].name.data());
+        (tagBucket ? moved.tagSlot : moved.extensionSlot) = slot;
+    }
+
+    bucket.pop_back();
+}
+
+std::span<const Dvfs::DvfsFileIndex::Entry> Dvfs::DvfsFileIndex::findBucket(const BucketMap& buckets, std::string_view key) {
+    auto it = buckets.find(key);
+    if (it == buckets.end()) return {};
+    return it->second;
+}
+
+void Dvfs::DvfsFileIndex::insert(const DatVFS* directory, const std::string& name, IDvfsFile* file, std::string_view tag) {
+    const Entry entry{directory, name, file};
+
+    Location location{};
+
+    // Buckets are never removed, so the pointers to them stay valid
+    auto extensionIt = extensions.find(getExtension(name));
+    if (extensionIt == extensions.end()) {
+        extensionIt = extensions.emplace(std::string(getExtension(name)), Bucket()).first;
+    }
+    location.extensionBucket = &extensionIt->second;
+    location.extensionSlot = location.extensionBucket->size();
+    location.extensionBucket->push_back(entry);
+
+    if (!tag.empty()) {
+        auto tagIt = tags.find(tag);
+        if (tagIt == tags.end()) {
+            tagIt = tags.emplace(std::string(tag), Bucket()).first;
+        }
+        location.tagBucket = &tagIt->second;
+        location.tagSlot = location.tagBucket->size();
+        location.tagBucket->push_back(entry);
+    }
+
+    locations[name.data()] = location;
+}
+
+bool Dvfs::DvfsFileIndex::erase(const std::string& name) {
+    auto it = locations.find(name.data());
+    if (it == locations.end()) return false;
+
+    const Location location = it->second;
+    removeFromBucket(*location.extensionBucket, location.extensionSlot, false);
+    if (location.tagBucket != nullptr) {
+        removeFromBucket(*location.tagBucket, location.tagSlot, true);
+    }
+
+    locations.erase(name.data());
+    return true;
+}
+
+bool Dvfs::DvfsFileIndex::update(const std::string& name, IDvfsFile* file) {
+    auto it = locations.find(name.data());
+    if (it == locations.end()) return false;
+
+    const Location& location = it->second;
+    (*location.extensionBucket)[location.extensionSlot].file = file;
+    if (location.tagBucket != nullptr) {
+        (*location.tagBucket)[location.tagSlot].file = file;
+    }
+    return true;
+}
+
+bool Dvfs::DvfsFileIndex::rename(const char* previous, const std::string& name) {
+    auto node = locations.extract(previous);
+    if (node.empty()) return false;
+
+    const Location& location = node.mapped();
+    (*location.extensionBucket)[location.extensionSlot].name = name;
+    if (location.tagBucket != nullptr) {
+        (*location.tagBucket)[location.tagSlot].name = name;
+    }
+
+    node.key() = name.data();
+    locations.insert(std::move(node));
+    return true;
+}
+
+void Dvfs::DvfsFileIndex::clear() {
+    extensions.clear();
+    tags.clear();
+    locations.clear();
+}
+
+void Dvfs::DvfsFileIndex::reserve(const size_t count) {
+    locations.reserve(count);
+}
+
+size_t Dvfs::DvfsFileIndex::size() const {
+    return locations.size();
+}
+
+std::span<const Dvfs::DvfsFileIndex::Entry> Dvfs::DvfsFileIndex::getByExtension(std::string_view extension) const {
+    return findBucket(extensions, extension);
+}
+
+std::span<const Dvfs::DvfsFileIndex::Entry> Dvfs::DvfsFileIndex::getByTag(std::string_view tag) const {
+    return findBucket(tags, tag);
+}
+
+std::string_view Dvfs::DvfsFileIndex::getExtension(std::string_view name) {
+    const size_t dot = name.find_last_of('.');
+    if (dot == std::string_view::npos || dot == 0) return {};
+    return name.substr(dot + 1);
+}
@@ -0,0 +1,205 @@
+#include "../include/DatVfsIoScheduler.h"
+
+#include <algorithm>
+
+Dvfs::DvfsIoScheduler::DvfsIoScheduler(const size_t threadCount) {
+    const size_t count = std::max<size_t>(1, threadCount);
+    threads.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        threads.emplace_back(&DvfsIoScheduler::threadLoop, this);
+    }
+}
+
+Dvfs::DvfsIoScheduler::~DvfsIoScheduler() {
+    std::vector<Completion> cancelled;
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+        for (auto& [id, read]: reads) {
+            cancelled.push_back(std::move(read.completion));
+        }
+        reads.clear();
+        for (auto& sweep: sweeps) sweep.clear();
+        deadlines.clear();
+    }
+    wake.notify_all();
+
+    for (std::thread& thread: threads) {
+        thread.join();
+    }
+
+    for (Completion& completion: cancelled) {
+        completion(false);
+    }
+}
+
+uint64_t Dvfs::DvfsIoScheduler::read(const IDvfsFile& file, char* buffer, Completion completion,
+                                     const DvfsIoPriority priority, const Clock::time_point deadline) {
+    // Finding the location or size may touch the disk, so it happens before taking the lock
+    const DvfsFileLocation location = file.getLocation();
+    const bool needsSize = priority == DvfsIoPriority::Background || deadline != noDeadline;
+    const uint64_t size = needsSize ? file.fileSize() : 0;
+
+    uint64_t id;
+    {
+        std::lock_guard lock(mutex);
+        id = nextId++;
+
+        Clock::time_point latestStart = noDeadline;
+        if (deadline != noDeadline) {
+            latestStart = deadline - estimateReadTime(size);
+            deadlines.emplace(latestStart, id);
+        }
+
+        reads.emplace(id, Read{&file, buffer, std::move(completion), priority, location, deadline, latestStart, size});
+        sweeps[static_cast<size_t>(priority)].emplace(location, id);
+    }
+
+    wake.notify_one();
+    return id;
+}
+
+bool Dvfs::DvfsIoScheduler::cancel(const uint64_t id) {
+    std::lock_guard lock(mutex);
+    if (!reads.contains(id)) return false;
+
+    remove(id);
+    if (reads.empty() && activeReads == 0) idle.notify_all();
+    return true;
+}
+
+void Dvfs::DvfsIoScheduler::setBackgroundBandwidth(const uint64_t bytesPerSecond) {
+    {
+        std::lock_guard lock(mutex);
+        backgroundBandwidth = bytesPerSecond;
+    }
+    wake.notify_all();
+}
+
+void Dvfs::DvfsIoScheduler::setReadTimeEstimate(const Clock::duration latency, const uint64_t bytesPerSecond) {
+    std::lock_guard lock(mutex);
+    readLatency = latency;
+    secondsPerByte = bytesPerSecond == 0 ? 0 : 1.0 / static_cast<double>(bytesPerSecond);
+}
+
+void Dvfs::DvfsIoScheduler::pause() {
+    std::lock_guard lock(mutex);
+    paused = true;
+}
+
+void Dvfs::DvfsIoScheduler::resume() {
+    {
+        std::lock_guard lock(mutex);
+        paused = false;
+    }
+    wake.notify_all();
+}
+
+void Dvfs::DvfsIoScheduler::waitForReads() {
+    std::unique_lock lock(mutex);
+    idle.wait(lock, [this] {
+        return reads.empty() && activeReads == 0;
+    });
+}
+
+size_t Dvfs::DvfsIoScheduler::getQueuedCount() const {
+    std::lock_guard lock(mutex);
+    return reads.size();
+}
+
+Dvfs::DvfsIoScheduler::Read Dvfs::DvfsIoScheduler::remove(const uint64_t id) {
+    auto it = reads.find(id);
+    Read read = std::move(it->second);
+    reads.erase(it);
+
+    sweeps[static_cast<size_t>(read.priority)].erase({read.location, id});
+    if (read.deadline != noDeadline) deadlines.erase({read.latestStart, id});
+    return read;
+}
+
+Dvfs::DvfsIoScheduler::Clock::duration Dvfs::DvfsIoScheduler::estimateReadTime(const uint64_t size) const {
+    return std::chrono::duration_cast<Clock::duration>(readLatency + std::chrono::duration<double>(secondsPerByte * static_cast<double>(size)));
+}
+
+void Dvfs::DvfsIoScheduler::recordReadTime(const uint64_t size, const Clock::duration took) {
+    // Each read moves the estimates an eighth of the way, so one slow read doesn't throw them off
+    constexpr double weight = 1.0 / 8;
+    const std::chrono::duration<double> seconds = took;
+
+    if (size < rateSampleSize) {
+        readLatency += (seconds - readLatency) * weight;
+    } else {
+        const double transfer = std::max(0.0, (seconds - readLatency).count()) / static_cast<double>(size);
+        secondsPerByte += (transfer - secondsPerByte) * weight;
+    }
+}
+
+bool Dvfs::DvfsIoScheduler::take(const Clock::time_point now, Read& read, Clock::time_point& retryAt) {
+    retryAt = noDeadline;
+
+    // Reads that have to start now to meet their deadline go first, the one that had to start earliest first
+    if (!deadlines.empty() && deadlines.begin()->first <= now) {
+        read = remove(deadlines.begin()->second);
+    } else {
+        size_t priority = 0;
+        for (; priority < priorityCount; ++priority) {
+            if (sweeps[priority].empty()) continue;
+
+            if (priority == static_cast<size_t>(DvfsIoPriority::Background) && backgroundBandwidth != 0 && now < backgroundReadyAt) {
+                retryAt = backgroundReadyAt;
+                continue;
+            }
+            break;
+        }
+
+        if (priority == priorityCount) {
+            if (!deadlines.empty()) retryAt = std::min(retryAt, deadlines.begin()->first);
+            return false;
+        }
+
+        // Carry on sweeping from the last location read, wrapping back to the start at the end
+        auto& sweep = sweeps[priority];
+        auto it = sweep.lower_bound({sweepPositions[priority], 0});
+        if (it == sweep.end()) it = sweep.begin();
+        read = remove(it->second);
+    }
+
+    sweepPositions[static_cast<size_t>(read.priority)] = read.location;
+    if (read.priority == DvfsIoPriority::Background && backgroundBandwidth != 0) {
+        const auto cost = std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(static_cast<double>(read.size) / static_cast<double>(backgroundBandwidth)));
+        backgroundReadyAt = std::max(now, backgroundReadyAt) + cost;
+    }
+    return true;
+}
+
+void Dvfs::DvfsIoScheduler::threadLoop() {
+    std::unique_lock lock(mutex);
+    while (!stopping) {
+        Read read;
+        Clock::time_point retryAt;
+        if (paused || !take(Clock::now(), read, retryAt)) {
+            if (paused || retryAt == noDeadline) wake.wait(lock);
+            else wake.wait_until(lock, retryAt);
+            continue;
+        }
+
+        ++activeReads;
+        lock.unlock();
+
+        const Clock::time_point start = Clock::now();
+        const bool success = read.file->getContent(read.buffer);
+        const Clock::duration took = Clock::now() - start;
+        // Only background and deadline reads know their size without asking the file again
+        const uint64_t size = read.size != 0 ? read.size : read.file->fileSize();
+
+        read.completion(success);
+        // Let go of anything the completion captured before waking waiters
+        read.completion = nullptr;
+
+        lock.lock();
+        if (success) recordReadTime(size, took);
+        --activeReads;
+        if (reads.empty() && activeReads == 0) idle.notify_all();
+    }
+}
@@ -0,0 +1,12 @@
+#include "../include/DatVfsLookupCache.h"
+
+#include <array>
+
+std::atomic<uint64_t> Dvfs::DvfsLookupCache::epoch = 1;
+
+Dvfs::DvfsLookupCache::Entry& Dvfs::DvfsLookupCache::getEntry(const size_t hash) {
+    static_assert((entryCount & (entryCount - 1)) == 0, "The entry count must be a power of 2");
+
+    thread_local std::array<Entry, entryCount> entries;
+    return entries[hash & (entryCount - 1)];
+}
@@ -0,0 +1,148 @@
+#include "../include/DatVfsManifest.h"
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <istream>
+#include <ostream>
+
+#include "../include/DatHash.h"
+#include "../include/DatVfsBufferPool.h"
+
+void Dvfs::DvfsManifest::add(const std::string& path, const uint64_t size, const uint64_t hash) {
+    auto [it, inserted] = index.emplace(path, entries.size());
+    if (!inserted) {
+        entries[it->second].size = size;
+        entries[it->second].hash = hash;
+        return;
+    }
+
+    entries.push_back({path, size, hash});
+}
+
+const Dvfs::DvfsManifest::Entry* Dvfs::DvfsManifest::find(const std::string& path) const {
+    auto it = index.find(path);
+    return it == index.end() ? nullptr : &entries[it->second];
+}
+
+bool Dvfs::DvfsManifest::write(std::ostream& stream) const {
+    char hash[16];
+    for (const Entry& entry: entries) {
+        // Hashes are padded to a fixed width so the file lines up
+        auto [end, error] = std::to_chars(hash, hash + sizeof(hash), entry.hash, 16);
+        stream << std::string(hash + sizeof(hash) - end, '0') << std::string_view(hash, end - hash) << ' ' << entry.size << ' ' << entry.path << '\n';
+    }
+    return stream.good();
+}
+
+bool Dvfs::DvfsManifest::read(std::istream& stream) {
+    entries.clear();
+    index.clear();
+
+    std::string line;
+    while (std::getline(stream, line)) {
+        if (line.empty()) continue;
+
+        const size_t hashEnd = line.find(' ');
+        const size_t sizeEnd = hashEnd == std::string::npos ? std::string::npos : line.find(' ', hashEnd + 1);
+        if (sizeEnd == std::string::npos || sizeEnd + 1 == line.size()) return false;
+
+        uint64_t hash;
+        uint64_t size;
+        const char* start = line.data();
+        if (std::from_chars(start, start + hashEnd, hash, 16).ptr != start + hashEnd) return false;
+        if (std::from_chars(start + hashEnd + 1, start + sizeEnd, size).ptr != start + sizeEnd) return false;
+
+        add(line.substr(sizeEnd + 1), size, hash);
+    }
+    return stream.eof();
+}
+
+bool Dvfs::DvfsManifest::save(const std::filesystem::path& path) const {
+    std::ofstream stream(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    return stream && write(stream);
+}
+
+bool Dvfs::DvfsManifest::load(const std::filesystem::path& path) {
+    std::ifstream stream(path, std::ios::in | std::ios::binary);
+    return stream && read(stream);
+}
+
+bool Dvfs::DvfsManifest::hashFile(const IDvfsFile& file, uint64_t& hash) {
+    // Big enough that each read is worth the call, small enough to stay in cache while it's hashed
+    constexpr uint64_t pieceSize = 1024 * 1024;
+
+    const uint64_t size = file.fileSize();
+    // Pooled buffers are aligned, so direct reads fill them without another copy
+    DvfsAlignedBufferPool::Buffer buffer = DvfsAlignedBufferPool::getDefault().acquire(std::min(size, pieceSize));
+
+    if (size <= pieceSize) {
+        if (!file.getContent(buffer.data())) return false;
+        hash = DvfsHasher::hash(buffer.data(), size);
+        return true;
+    }
+
+    DvfsHasher hasher;
+    for (uint64_t offset = 0; offset < size; offset += pieceSize) {
+        const uint64_t length = std::min(pieceSize, size - offset);
+        if (!file.getContentRange(buffer.data(), offset, length)) return false;
+        hasher.update(buffer.data(), length);
+    }
+    hash = hasher.digest();
+    return true;
+}
+
+void Dvfs::DvfsManifestVerifier::report(std::string path, const DvfsVerifyMismatch::Problem problem) {
+    std::lock_guard lock(mismatchesMutex);
+    mismatches.push_back({std::move(path), problem});
+}
+
+void Dvfs::DvfsManifestVerifier::check(const DatPath& directory, const std::string& name, const IDvfsFile& file, const bool selected) {
+    std::string path(directory);
+    if (!path.empty()) path += '/';
+    path += name;
+
+    const DvfsManifest::Entry* entry = manifest.find(path);
+    if (entry != nullptr) found[entry - &*manifest.begin()] = 1;
+    if (!selected) return;
+
+    filesChecked.fetch_add(1, std::memory_order_relaxed);
+    if (entry == nullptr) {
+        report(std::move(path), DvfsVerifyMismatch::Problem::Unlisted);
+        return;
+    }
+
+    // Checking the size first saves reading files that can't match
+    if (file.fileSize() != entry->size) {
+        report(std::move(path), DvfsVerifyMismatch::Problem::SizeMismatch);
+        return;
+    }
+
+    uint64_t hash;
+    if (!DvfsManifest::hashFile(file, hash)) {
+        report(std::move(path), DvfsVerifyMismatch::Problem::ReadFailed);
+        return;
+    }
+    bytesHashed.fetch_add(entry->size, std::memory_order_relaxed);
+
+    if (hash != entry->hash) report(std::move(path), DvfsVerifyMismatch::Problem::HashMismatch);
+}
+
+Dvfs::DvfsVerifyResult Dvfs::DvfsManifestVerifier::finish(const bool recursive) {
+    size_t i = 0;
+    for (const DvfsManifest::Entry& entry: manifest) {
+        if (!found[i++] && (recursive || entry.path.find('/') == std::string::npos)) {
+            mismatches.push_back({entry.path, DvfsVerifyMismatch::Problem::Missing});
+        }
+    }
+
+    std::sort(mismatches.begin(), mismatches.end(), [](const DvfsVerifyMismatch& lh, const DvfsVerifyMismatch& rh) {
+        return lh.path < rh.path;
+    });
+
+    DvfsVerifyResult result;
+    result.mismatches = std::move(mismatches);
+    result.filesChecked = filesChecked.load(std::memory_order_relaxed);
+    result.bytesHashed = bytesHashed.load(std::memory_order_relaxed);
+    return result;
+}
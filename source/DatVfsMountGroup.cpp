@@ -0,0 +1,73 @@
+#include "../include/DatVfsMountGroup.h"
+
+uint32_t Dvfs::DvfsMountGroups::create() {
+    return nextId++;
+}
+
+void Dvfs::DvfsMountGroups::add(const uint32_t group, DatVFS* directory, const std::string& name) {
+    const char* key = name.data();
+
+    // New entries go on the front of the group's list
+    auto [head, inserted] = heads.try_emplace(group, key);
+    const char* next = inserted ? nullptr : head->second;
+    head->second = key;
+
+    entries.emplace(key, Link{directory, &name, group, nullptr, next});
+    if (next != nullptr) entries.at(next).previous = key;
+}
+
+bool Dvfs::DvfsMountGroups::forget(const std::string& name) {
+    auto it = entries.find(name.data());
+    if (it == entries.end()) return false;
+
+    const Link& link = it->second;
+    if (link.previous != nullptr) entries.at(link.previous).next = link.next;
+    if (link.next != nullptr) entries.at(link.next).previous = link.previous;
+
+    // The group is gone once its last entry is
+    if (link.previous == nullptr) {
+        if (link.next != nullptr) heads[link.group] = link.next;
+        else heads.erase(link.group);
+    }
+
+    entries.erase(it);
+    return true;
+}
+
+bool Dvfs::DvfsMountGroups::rename(const char* previous, const std::string& name) {
+    auto node = entries.extract(previous);
+    if (node.empty()) return false;
+
+    const char* key = name.data();
+    Link& link = node.mapped();
+    link.name = &name;
+
+    // The neighbours link to the entry by its key, so they have to follow it
+    if (link.previous != nullptr) entries.at(link.previous).next = key;
+    else heads[link.group] = key;
+    if (link.next != nullptr) entries.at(link.next).previous = key;
+
+    node.key() = key;
+    entries.insert(std::move(node));
+    return true;
+}
+
+Dvfs::DvfsMountGroups::Entry Dvfs::DvfsMountGroups::front(const uint32_t group) const {
+    auto head = heads.find(group);
+    if (head == heads.end()) return {nullptr, nullptr};
+
+    const Link& link = entries.at(head->second);
+    return {link.directory, link.name};
+}
+
+bool Dvfs::DvfsMountGroups::contains(const uint32_t group) const {
+    return heads.contains(group);
+}
+
+size_t Dvfs::DvfsMountGroups::size() const {
+    return entries.size();
+}
+
+void Dvfs::DvfsMountGroups::reserve(const size_t count) {
+    entries.reserve(count);
+}
@@ -0,0 +1,474 @@
+#include "../include/DatVfsPatch.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+#include "../include/DatHash.h"
+#include "../include/DatVfs.h"
+
+namespace {
+    constexpr char packMagic[8] = {'D', 'V', 'F', 'S', 'P', 'A', 'K', '\0'};
+
+    /** Copy a run of the base, followed by its offset and length */
+    constexpr unsigned char deltaCopy = 0;
+    /** Insert new bytes, followed by their length and the bytes */
+    constexpr unsigned char deltaInsert = 1;
+
+    /** The length of the runs matched between base and target, shorter matches aren't worth a copy */
+    constexpr uint64_t deltaBlockSize = 32;
+    /** The multiplier of the rolling hash used to find matching blocks */
+    constexpr uint64_t rollingPrime = 0x100000001b3;
+
+    /**
+     * A pack held in memory, read from like any other file
+     */
+    class MemoryDvfsFile : public Dvfs::IDvfsFile {
+        std::vector<char> data;
+
+    public:
+        explicit MemoryDvfsFile(std::vector<char> data) : data(std::move(data)) {}
+
+        [[nodiscard]] uint64_t fileSize() const override {
+            return data.size();
+        }
+
+        [[nodiscard]] bool isValidFile() const override {
+            return true;
+        }
+
+        bool getContent(char* buffer) const override {
+            std::memcpy(buffer, data.data(), data.size());
+            return true;
+        }
+
+        bool getContentRange(char* buffer, uint64_t offset, uint64_t length) const override {
+            if (offset > data.size() || length > data.size() - offset) return false;
+            std::memcpy(buffer, data.data() + offset, length);
+            return true;
+        }
+    };
+
+    /**
+     * Yields the files created when a pack is mounted
+     */
+    struct PatchFileInserter : public Dvfs::IDvfsFileInserter {
+        std::vector<pair> files;
+
+        void forEachFile(const Visitor& visitor) const override {
+            for (const auto& [path, file]: files) {
+                if (!visitor(path, file)) return;
+            }
+        }
+
+        [[nodiscard]] size_t getSizeHint() const override {
+            return files.size();
+        }
+    };
+
+    void writeVarint(std::vector<char>& output, uint64_t value) {
+        while (value >= 0x80) {
+            output.push_back(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        output.push_back(static_cast<char>(value));
+    }
+
+    bool readVarint(const char*& data, const char* end, uint64_t& value) {
+        value = 0;
+        for (unsigned shift = 0; shift < 64 && data != end; shift += 7) {
+            const auto byte = static_cast<unsigned char>(*data++);
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) return true;
+        }
+        return false;
+    }
+
+    uint64_t hashBlock(const char* data) {
+        uint64_t hash = 0;
+        for (uint64_t i = 0; i < deltaBlockSize; ++i) {
+            hash = hash * rollingPrime + static_cast<unsigned char>(data[i]);
+        }
+        return hash;
+    }
+
+    void appendInsert(std::vector<char>& delta, const char* data, uint64_t length) {
+        if (length == 0) return;
+
+        delta.push_back(static_cast<char>(deltaInsert));
+        writeVarint(delta, length);
+        delta.insert(delta.end(), data, data + length);
+    }
+
+    void appendCopy(std::vector<char>& delta, uint64_t offset, uint64_t length) {
+        delta.push_back(static_cast<char>(deltaCopy));
+        writeVarint(delta, offset);
+        writeVarint(delta, length);
+    }
+
+    std::vector<char> readContent(const Dvfs::IDvfsFile& file, uint64_t size, bool& success) {
+        std::vector<char> content(size);
+        success = file.getContent(content.data());
+        return content;
+    }
+}
+
+std::vector<char> Dvfs::DvfsPatchPack::createDelta(const char* base, const uint64_t baseSize, const char* target, const uint64_t targetSize) {
+    std::vector<char> delta;
+    if (baseSize < deltaBlockSize || targetSize < deltaBlockSize) {
+        appendInsert(delta, target, targetSize);
+        return delta;
+    }
+
+    // Index the base by the hash of each block, keeping the first of any repeated blocks
+    std::unordered_map<uint64_t, uint64_t> blocks;
+    blocks.reserve(baseSize / deltaBlockSize);
+    for (uint64_t offset = 0; offset + deltaBlockSize <= baseSize; offset += deltaBlockSize) {
+        blocks.try_emplace(hashBlock(base + offset), offset);
+    }
+
+    // Removing the byte leaving the window needs the multiplier of the oldest byte
+    uint64_t oldestFactor = 1;
+    for (uint64_t i = 1; i < deltaBlockSize; ++i) oldestFactor *= rollingPrime;
+
+    uint64_t literalStart = 0;
+    uint64_t position = 0;
+    uint64_t hash = hashBlock(target);
+    while (position + deltaBlockSize <= targetSize) {
+        auto it = blocks.find(hash);
+        if (it != blocks.end() && std::memcmp(base + it->second, target + position, deltaBlockSize) == 0) {
+            uint64_t baseOffset = it->second;
+            uint64_t targetOffset = position;
+
+            // Grow the match both ways, backwards only as far as the bytes not yet stored
+            while (targetOffset > literalStart && baseOffset > 0 && base[baseOffset - 1] == target[targetOffset - 1]) {
+                --baseOffset;
+                --targetOffset;
+            }
+            uint64_t length = position + deltaBlockSize - targetOffset;
+            while (targetOffset + length < targetSize && baseOffset + length < baseSize && base[baseOffset + length] == target[targetOffset + length]) {
+                ++length;
+            }
+
+            appendInsert(delta, target + literalStart, targetOffset - literalStart);
+            appendCopy(delta, baseOffset, length);
+
+            position = targetOffset + length;
+            literalStart = position;
+            if (position + deltaBlockSize <= targetSize) hash = hashBlock(target + position);
+            continue;
+        }
+
+        if (position + deltaBlockSize < targetSize) {
+            hash -= static_cast<unsigned char>(target[position]) * oldestFactor;
+            hash = hash * rollingPrime + static_cast<unsigned char>(target[position + deltaBlockSize]);
+        }
+        ++position;
+    }
+
+    appendInsert(delta, target + literalStart, targetSize - literalStart);
+    return delta;
+}
+
+bool Dvfs::DvfsPatchPack::applyDelta(const char* base, const uint64_t baseSize, const char* delta, const uint64_t deltaSize, char* output, const uint64_t outputSize) {
+    const char* data = delta;
+    const char* end = delta + deltaSize;
+    uint64_t written = 0;
+
+    while (data != end) {
+        const auto op = static_cast<unsigned char>(*data++);
+        if (op == deltaCopy) {
+            uint64_t offset;
+            uint64_t length;
+            if (!readVarint(data, end, offset) || !readVarint(data, end, length)) return false;
+            if (offset > baseSize || length > baseSize - offset || length > outputSize - written) return false;
+
+            std::memcpy(output + written, base + offset, length);
+            written += length;
+        } else if (op == deltaInsert) {
+            uint64_t length;
+            if (!readVarint(data, end, length)) return false;
+            if (length > static_cast<uint64_t>(end - data) || length > outputSize - written) return false;
+
+            std::memcpy(output + written, data, length);
+            data += length;
+            written += length;
+        } else {
+            return false;
+        }
+    }
+    return written == outputSize;
+}
+
+std::vector<char> Dvfs::DvfsPatchPack::build(const DatVFS& base, const DatVFS& target) {
+    struct BuiltEntry {
+        std::string path;
+        Kind kind;
+        std::vector<char> data;
+        uint64_t size;
+        uint64_t hash;
+        uint64_t baseSize;
+        uint64_t baseHash;
+    };
+
+    // Manifests find the changed files without holding every file in memory at once
+    const DvfsManifest baseManifest = base.createManifestParallel();
+    const DvfsManifest targetManifest = target.createManifestParallel();
+
+    std::vector<BuiltEntry> built;
+    for (const DvfsManifest::Entry& entry: targetManifest) {
+        const DvfsManifest::Entry* previous = baseManifest.find(entry.path);
+        if (previous != nullptr && previous->size == entry.size && previous->hash == entry.hash) continue;
+
+        bool success;
+        std::vector<char> content = readContent(*target.getFile(entry.path), entry.size, success);
+        if (!success) continue;
+
+        BuiltEntry builtEntry{entry.path, Kind::Full, {}, entry.size, entry.hash, 0, 0};
+        if (previous != nullptr) {
+            std::vector<char> previousContent = readContent(*base.getFile(entry.path), previous->size, success);
+            if (success) {
+                std::vector<char> delta = createDelta(previousContent.data(), previousContent.size(), content.data(), content.size());
+                if (delta.size() < content.size()) {
+                    builtEntry.kind = Kind::Delta;
+                    builtEntry.data = std::move(delta);
+                    builtEntry.baseSize = previous->size;
+                    builtEntry.baseHash = previous->hash;
+                }
+            }
+        }
+        if (builtEntry.kind == Kind::Full) builtEntry.data = std::move(content);
+        built.push_back(std::move(builtEntry));
+    }
+
+    for (const DvfsManifest::Entry& entry: baseManifest) {
+        if (targetManifest.find(entry.path) == nullptr) built.push_back({entry.path, Kind::Removed, {}, 0, 0, 0, 0});
+    }
+
+    std::sort(built.begin(), built.end(), [](const BuiltEntry& lh, const BuiltEntry& rh) {
+        return lh.path < rh.path;
+    });
+
+    // The index goes first so opening a pack only reads the start of it
+    Header header{};
+    std::memcpy(header.magic, packMagic, sizeof(packMagic));
+    header.version = version;
+    header.entryCount = static_cast<uint32_t>(built.size());
+    header.entriesOffset = sizeof(Header);
+    header.namesOffset = header.entriesOffset + built.size() * sizeof(StoredEntry);
+
+    std::vector<StoredEntry> storedEntries;
+    storedEntries.reserve(built.size());
+    std::string names;
+    uint64_t dataSize = 0;
+    for (const BuiltEntry& entry: built) {
+        storedEntries.push_back({static_cast<uint32_t>(names.size()), static_cast<uint32_t>(entry.path.size()), static_cast<uint32_t>(entry.kind), 0,
+                                 dataSize, entry.data.size(), entry.size, entry.hash, entry.baseSize, entry.baseHash});
+        names += entry.path;
+        dataSize += entry.data.size();
+    }
+    header.namesSize = names.size();
+    header.dataOffset = header.namesOffset + names.size();
+    header.dataSize = dataSize;
+
+    std::vector<char> pack(header.dataOffset + dataSize);
+    for (StoredEntry& entry: storedEntries) {
+        entry.dataOffset += header.dataOffset;
+    }
+    std::memcpy(pack.data(), &header, sizeof(header));
+    if (!storedEntries.empty()) std::memcpy(pack.data() + header.entriesOffset, storedEntries.data(), storedEntries.size() * sizeof(StoredEntry));
+    std::memcpy(pack.data() + header.namesOffset, names.data(), names.size());
+
+    char* data = pack.data() + header.dataOffset;
+    for (const BuiltEntry& entry: built) {
+        if (entry.data.empty()) continue;
+        std::memcpy(data, entry.data.data(), entry.data.size());
+        data += entry.data.size();
+    }
+    return pack;
+}
+
+bool Dvfs::DvfsPatchPack::write(const DatVFS& base, const DatVFS& target, const std::filesystem::path& path) {
+    const std::vector<char> pack = build(base, target);
+
+    std::ofstream stream(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    return stream.write(pack.data(), static_cast<std::streamsize>(pack.size())).good();
+}
+
+std::unique_ptr<Dvfs::DvfsPatchPack> Dvfs::DvfsPatchPack::open(const std::filesystem::path& path) {
+    auto source = std::make_shared<LooseDvfsFile>(path);
+    if (!source->isValidFile()) return nullptr;
+
+    return attach(std::move(source));
+}
+
+std::unique_ptr<Dvfs::DvfsPatchPack> Dvfs::DvfsPatchPack::load(std::vector<char> pack) {
+    return attach(std::make_shared<MemoryDvfsFile>(std::move(pack)));
+}
+
+std::unique_ptr<Dvfs::DvfsPatchPack> Dvfs::DvfsPatchPack::attach(std::shared_ptr<const IDvfsFile> packSource) {
+    const uint64_t packSize = packSource->fileSize();
+
+    Header header{};
+    if (packSize < sizeof(Header) || !packSource->getContentRange(reinterpret_cast<char*>(&header), 0, sizeof(Header))) return nullptr;
+    if (std::memcmp(header.magic, packMagic, sizeof(packMagic)) != 0 || header.version != version) return nullptr;
+
+    // Every section has to fit in the pack before any of it is trusted
+    const auto fits = [packSize](uint64_t offset, uint64_t size) {
+        return offset <= packSize && size <= packSize - offset;
+    };
+    if (header.entryCount > packSize / sizeof(StoredEntry) || !fits(header.entriesOffset, header.entryCount * sizeof(StoredEntry))) return nullptr;
+    if (!fits(header.namesOffset, header.namesSize) || !fits(header.dataOffset, header.dataSize)) return nullptr;
+
+    std::vector<StoredEntry> storedEntries(header.entryCount);
+    std::string names(header.namesSize, '\0');
+    if (!packSource->getContentRange(reinterpret_cast<char*>(storedEntries.data()), header.entriesOffset, header.entryCount * sizeof(StoredEntry))) return nullptr;
+    if (!packSource->getContentRange(names.data(), header.namesOffset, header.namesSize)) return nullptr;
+
+    std::unique_ptr<DvfsPatchPack> pack(new DvfsPatchPack);
+    pack->entries.reserve(storedEntries.size());
+    for (const StoredEntry& stored: storedEntries) {
+        if (stored.nameOffset > names.size() || stored.nameLength > names.size() - stored.nameOffset) return nullptr;
+        if (stored.kind > static_cast<uint32_t>(Kind::Removed)) return nullptr;
+        if (stored.dataOffset < header.dataOffset || !fits(stored.dataOffset, stored.dataLength) ||
+            stored.dataOffset + stored.dataLength > header.dataOffset + header.dataSize) return nullptr;
+        // Whole files are stored as is, so their size has to match what's stored
+        if (stored.kind == static_cast<uint32_t>(Kind::Full) && stored.dataLength != stored.size) return nullptr;
+
+        pack->entries.push_back({names.substr(stored.nameOffset, stored.nameLength), static_cast<Kind>(stored.kind),
+                                 stored.dataOffset, stored.dataLength, stored.size, stored.hash, stored.baseSize, stored.baseHash});
+    }
+
+    pack->source = std::move(packSource);
+    return pack;
+}
+
+Dvfs::DvfsMountGroup Dvfs::DvfsPatchPack::mount(DatVFS& vfs, const DatPath& path) const {
+    struct Replaced {
+        DatPath path;
+        IDvfsFile* file;
+        bool unmounted;
+    };
+
+    // Nothing is unmounted until every file is created, so a skipped delta leaves its file alone
+    PatchFileInserter inserter;
+    inserter.files.reserve(entries.size());
+    std::vector<Replaced> replaced;
+    replaced.reserve(entries.size());
+
+    for (const Entry& entry: entries) {
+        DatPath filePath = path.empty() ? DatPath(entry.path) : path / entry.path;
+        IDvfsFile* existing = vfs.getFile(filePath);
+
+        switch (entry.kind) {
+            case Kind::Removed:
+                break;
+            case Kind::Full:
+                inserter.files.emplace_back(entry.path, new DvfsPatchFile(source, entry.dataOffset, entry.size));
+                break;
+            case Kind::Delta:
+                // Without the content the delta was made against, there's nothing it can be applied to
+                if (existing == nullptr || existing->fileSize() != entry.baseSize) continue;
+
+                inserter.files.emplace_back(entry.path, new DvfsPatchDeltaFile(source, vfs, existing, entry.baseHash, entry.dataOffset,
+                                                                               entry.dataLength, entry.size, entry.hash));
+                break;
+        }
+        if (existing != nullptr) replaced.push_back({std::move(filePath), existing, false});
+    }
+
+    // The replaced files are held while they're unmounted, so they can be put back if the pack doesn't fit
+    for (Replaced& file: replaced) {
+        vfs.holdFile(file.file);
+        file.unmounted = vfs.unmountFile(file.path);
+    }
+
+    const size_t fileCount = inserter.files.size();
+    DvfsMountGroup group = vfs.mountFiles(path, inserter, true);
+    const bool mounted = static_cast<size_t>(group.fileCount) == fileCount;
+    if (!mounted) {
+        vfs.unmountGroup(group, false);
+        for (const Replaced& file: replaced) {
+            if (file.unmounted) vfs.mountFile(file.path, file.file, true);
+        }
+    }
+
+    for (const Replaced& file: replaced) {
+        vfs.releaseHeldFile(file.file);
+    }
+    return mounted ? group : DvfsMountGroup();
+}
+
+uint64_t Dvfs::DvfsPatchFile::fileSize() const {
+    return size;
+}
+
+bool Dvfs::DvfsPatchFile::isValidFile() const {
+    return source->isValidFile();
+}
+
+bool Dvfs::DvfsPatchFile::getContent(char* buffer) const {
+    return source->getContentRange(buffer, offset, size);
+}
+
+bool Dvfs::DvfsPatchFile::getContentRange(char* buffer, const uint64_t rangeOffset, const uint64_t length) const {
+    if (rangeOffset > size || length > size - rangeOffset) return false;
+    return source->getContentRange(buffer, offset + rangeOffset, length);
+}
+
+Dvfs::DvfsPatchDeltaFile::DvfsPatchDeltaFile(std::shared_ptr<const IDvfsFile> source, DatVFS& vfs, IDvfsFile* base, const uint64_t baseHash,
+                                             const uint64_t offset, const uint64_t length, const uint64_t size, const uint64_t hash)
+        : source(std::move(source)), vfs(&vfs), base(base), baseHash(baseHash), offset(offset), length(length), size(size), hash(hash) {
+    vfs.holdFile(base);
+}
+
+Dvfs::DvfsPatchDeltaFile::~DvfsPatchDeltaFile() {
+    // The VFS stops tracking the base in its deduplicator and handle table when the last reference goes
+    vfs->releaseHeldFile(base);
+}
+
+bool Dvfs::DvfsPatchDeltaFile::apply() const {
+    if (applied.load(std::memory_order_acquire)) return true;
+
+    std::lock_guard lock(mutex);
+    if (applied.load(std::memory_order_relaxed)) return true;
+
+    bool success;
+    const std::vector<char> baseContent = readContent(*base, base->fileSize(), success);
+    // A base of the right size can still be the wrong file
+    if (!success || DvfsHasher::hash(baseContent.data(), baseContent.size()) != baseHash) return false;
+
+    std::vector<char> delta(length);
+    if (!source->getContentRange(delta.data(), offset, length)) return false;
+
+    std::vector<char> result(size);
+    if (!DvfsPatchPack::applyDelta(baseContent.data(), baseContent.size(), delta.data(), delta.size(), result.data(), size)) return false;
+    if (DvfsHasher::hash(result.data(), size) != hash) return false;
+
+    patched = std::move(result);
+    applied.store(true, std::memory_order_release);
+    return true;
+}
+
+uint64_t Dvfs::DvfsPatchDeltaFile::fileSize() const {
+    return size;
+}
+
+bool Dvfs::DvfsPatchDeltaFile::isValidFile() const {
+    return base->isValidFile() && source->isValidFile();
+}
+
+bool Dvfs::DvfsPatchDeltaFile::getContent(char* buffer) const {
+    if (!apply()) return false;
+
+    if (size != 0) std::memcpy(buffer, patched.data(), size);
+    return true;
+}
+
+bool Dvfs::DvfsPatchDeltaFile::getContentRange(char* buffer, const uint64_t rangeOffset, const uint64_t rangeLength) const {
+    if (rangeOffset > size || rangeLength > size - rangeOffset || !apply()) return false;
+
+    if (rangeLength != 0) std::memcpy(buffer, patched.data() + rangeOffset, rangeLength);
+    return true;
+}
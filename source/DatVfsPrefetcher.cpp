@@ -0,0 +1,107 @@
+#include "../include/DatVfsPrefetcher.h"
+
+#include <algorithm>
+#include <fstream>
+
+#include "../include/DatVfs.h"
+
+Dvfs::DvfsPrefetcher::DvfsPrefetcher(const DatVFS& vfs, const size_t lookahead, DvfsThreadPool& pool) :
+        vfs(vfs),
+        prefetches(pool),
+        lookahead(lookahead) {}
+
+Dvfs::DvfsPrefetcher::~DvfsPrefetcher() {
+    waitForPrefetches();
+}
+
+void Dvfs::DvfsPrefetcher::prefetchHistory(size_t begin, const size_t end) {
+    begin = std::max(begin, prefetchedUpTo);
+    for (size_t i = begin; i < end && i < history.size(); ++i) {
+        // Paths are resolved here, so the VFS is only ever read from the calling thread
+        if (const IDvfsFile* file = vfs.getFile(history[i])) queuePrefetch(file);
+    }
+    prefetchedUpTo = std::max(prefetchedUpTo, std::min(end, history.size()));
+}
+
+void Dvfs::DvfsPrefetcher::queuePrefetch(const IDvfsFile* file) {
+    prefetchCount.fetch_add(1, std::memory_order_relaxed);
+    prefetches.run([file]() {
+        file->prefetch();
+    });
+}
+
+Dvfs::IDvfsFile* Dvfs::DvfsPrefetcher::getFile(const DatPath& path) {
+    recordAccess(path);
+    return vfs.getFile(path);
+}
+
+void Dvfs::DvfsPrefetcher::recordAccess(const DatPath& path) {
+    auto name = static_cast<std::string>(path);
+
+    std::lock_guard lock(mutex);
+    if (sessionPaths.insert(name).second) {
+        session.push_back(name);
+    }
+
+    auto it = historyPositions.find(name);
+    if (it == historyPositions.end()) return;
+
+    prefetchHistory(it->second + 1, it->second + 1 + lookahead);
+}
+
+void Dvfs::DvfsPrefetcher::prefetch(const std::vector<DatPath>& paths) {
+    for (const DatPath& path: paths) {
+        if (const IDvfsFile* file = vfs.getFile(path)) queuePrefetch(file);
+    }
+}
+
+void Dvfs::DvfsPrefetcher::waitForPrefetches() {
+    prefetches.wait();
+}
+
+bool Dvfs::DvfsPrefetcher::loadHistory(const std::filesystem::path& historyFile) {
+    std::ifstream stream(historyFile);
+    if (!stream) return false;
+
+    std::string line;
+    if (!std::getline(stream, line) || line != historyHeader) return false;
+
+    std::lock_guard lock(mutex);
+    history.clear();
+    historyPositions.clear();
+    prefetchedUpTo = 0;
+
+    while (std::getline(stream, line)) {
+        if (line.empty()) continue;
+
+        historyPositions.emplace(line, history.size());
+        history.push_back(std::move(line));
+    }
+
+    // Get ahead of the first accesses of the session
+    prefetchHistory(0, lookahead);
+    return true;
+}
+
+bool Dvfs::DvfsPrefetcher::saveHistory(const std::filesystem::path& historyFile) const {
+    std::ofstream stream(historyFile, std::ios::out | std::ios::trunc);
+    if (!stream) return false;
+
+    stream << historyHeader << '\n';
+
+    std::lock_guard lock(mutex);
+    for (const std::string& path: session) {
+        stream << path << '\n';
+    }
+
+    return stream.good();
+}
+
+std::vector<std::string> Dvfs::DvfsPrefetcher::getSessionHistory() const {
+    std::lock_guard lock(mutex);
+    return session;
+}
+
+uint64_t Dvfs::DvfsPrefetcher::getPrefetchCount() const {
+    return prefetchCount.load(std::memory_order_relaxed);
+}
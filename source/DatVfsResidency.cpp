@@ -0,0 +1,222 @@
+#include "../include/DatVfsResidency.h"
+
+#include "../include/DatVfs.h"
+
+Dvfs::DvfsResidencyManager::Content Dvfs::DvfsResidencyManager::load(const IDvfsFile& file, const std::string_view tag, const int priority) {
+    return load(file, tag, priority, nullptr, {});
+}
+
+Dvfs::DvfsResidencyManager::Content Dvfs::DvfsResidencyManager::load(const IDvfsFile& file, const std::string_view tag, const int priority,
+                                                                     const DatVFS* vfs, const DvfsFileHandle handle) {
+    // Finding the size may touch the disk, so it happens before taking the lock
+    const uint64_t size = file.fileSize();
+
+    std::unique_lock lock(mutex);
+    auto it = entries.find(&file);
+
+    // A different handle from the same VFS means the file that was loaded has been deleted, and this is a new file
+    // that happens to have the same address
+    if (it != entries.end() && vfs != nullptr && it->second.vfs == vfs && it->second.handle != handle && it->second.content != nullptr) {
+        remove(it);
+        it = entries.end();
+    }
+
+    if (it != entries.end()) {
+        // Another thread is reading the file, wait for it rather than reading it again
+        loaded.wait(lock, [&] {
+            it = entries.find(&file);
+            return it == entries.end() || it->second.content != nullptr;
+        });
+
+        if (it != entries.end()) {
+            ++hits;
+            Entry& entry = it->second;
+            evictionOrder.erase({entry.priority, entry.lastUsed, &file});
+            entry.lastUsed = ++clock;
+            evictionOrder.emplace(entry.priority, entry.lastUsed, &file);
+            return entry.content;
+        }
+        // The other read failed or the file was unloaded, so try reading it here
+    }
+
+    ++misses;
+    if (!makeRoom(size)) {
+        ++failures;
+        return nullptr;
+    }
+
+    // The file is accounted for while it's read, but can't be unloaded until it has content
+    entries.emplace(&file, Entry{nullptr, size, std::string(tag), priority, ++clock, vfs, handle});
+    *usedBytes += size;
+    auto tagIt = tags.find(tag);
+    if (tagIt == tags.end()) tagIt = tags.emplace(std::string(tag), TagResidency{std::string(tag)}).first;
+    tagIt->second.bytes += size;
+    ++tagIt->second.fileCount;
+
+    /**
+     * Takes the placeholder back out if the read fails or throws, so waiters on the file aren't left blocking forever
+     */
+    struct PendingRead {
+        DvfsResidencyManager& manager;
+        const IDvfsFile& file;
+        std::unique_lock<std::mutex>& lock;
+        bool succeeded = false;
+
+        ~PendingRead() {
+            if (succeeded) return;
+
+            if (!lock.owns_lock()) lock.lock();
+            auto placeholder = manager.entries.find(&file);
+            if (placeholder != manager.entries.end() && placeholder->second.content == nullptr) manager.remove(placeholder);
+            ++manager.failures;
+            manager.loaded.notify_all();
+        }
+    } read{*this, file, lock};
+
+    lock.unlock();
+    std::shared_ptr<std::vector<char>> content = allocate(size);
+    read.succeeded = file.getContent(content->data());
+    lock.lock();
+    if (!read.succeeded) return nullptr;
+
+    // The file may have been unloaded while it was read, in which case the content is only the caller's, but it stays
+    // accounted until they drop it
+    it = entries.find(&file);
+    const bool tracked = it != entries.end() && it->second.content == nullptr;
+    if (tracked) {
+        it->second.content = content;
+        evictionOrder.emplace(it->second.priority, it->second.lastUsed, &file);
+    }
+    loaded.notify_all();
+    return content;
+}
+
+Dvfs::DvfsResidencyManager::Content Dvfs::DvfsResidencyManager::load(const DatVFS& vfs, const DatPath& path, const std::string_view tag, const int priority) {
+    const DvfsFileHandle handle = vfs.getFileHandle(path);
+    const IDvfsFile* file = vfs.resolve(handle);
+    if (file == nullptr) return nullptr;
+
+    return load(*file, tag, priority, &vfs, handle);
+}
+
+Dvfs::DvfsResidencyManager::Content Dvfs::DvfsResidencyManager::find(const IDvfsFile& file) {
+    std::lock_guard lock(mutex);
+    auto it = entries.find(&file);
+    if (it == entries.end() || it->second.content == nullptr) return nullptr;
+
+    Entry& entry = it->second;
+    evictionOrder.erase({entry.priority, entry.lastUsed, &file});
+    entry.lastUsed = ++clock;
+    evictionOrder.emplace(entry.priority, entry.lastUsed, &file);
+    return entry.content;
+}
+
+bool Dvfs::DvfsResidencyManager::isResident(const IDvfsFile& file) const {
+    std::lock_guard lock(mutex);
+    auto it = entries.find(&file);
+    return it != entries.end() && it->second.content != nullptr;
+}
+
+bool Dvfs::DvfsResidencyManager::unload(const IDvfsFile& file) {
+    std::lock_guard lock(mutex);
+    auto it = entries.find(&file);
+    if (it == entries.end()) return false;
+
+    remove(it);
+    // Wakes anyone waiting on the file so they read it themselves
+    loaded.notify_all();
+    return true;
+}
+
+size_t Dvfs::DvfsResidencyManager::unloadTag(const std::string_view tag) {
+    std::lock_guard lock(mutex);
+    size_t count = 0;
+    for (auto it = entries.begin(); it != entries.end();) {
+        auto next = std::next(it);
+        if (it->second.tag == tag) {
+            remove(it);
+            ++count;
+        }
+        it = next;
+    }
+
+    if (count != 0) loaded.notify_all();
+    return count;
+}
+
+bool Dvfs::DvfsResidencyManager::setBudget(const uint64_t bytes) {
+    std::lock_guard lock(mutex);
+    budget = bytes;
+    return makeRoom(0);
+}
+
+Dvfs::DvfsResidencyManager::Residency Dvfs::DvfsResidencyManager::getResidency() const {
+    std::lock_guard lock(mutex);
+    Residency residency;
+    residency.budget = budget;
+    residency.usedBytes = *usedBytes;
+    residency.fileCount = entries.size();
+    residency.hits = hits;
+    residency.misses = misses;
+    residency.evictions = evictions;
+    residency.failures = failures;
+
+    // Everything in use is held by a caller apart from files being read and content only the manager holds
+    residency.heldBytes = residency.usedBytes;
+    for (const auto& [file, entry]: entries) {
+        if (entry.content.use_count() <= 1) residency.heldBytes -= entry.size;
+    }
+
+    residency.tags.reserve(tags.size());
+    for (const auto& [tag, usage]: tags) {
+        residency.tags.push_back(usage);
+    }
+    return residency;
+}
+
+bool Dvfs::DvfsResidencyManager::makeRoom(const uint64_t bytes) {
+    if (bytes > budget) return false;
+
+    auto it = evictionOrder.begin();
+    while (*usedBytes + bytes > budget && it != evictionOrder.end()) {
+        auto entry = entries.find(std::get<2>(*it));
+        ++it;
+
+        // Only the manager holds it once the use count is 1, and only the manager can hand out more references
+        if (entry->second.content.use_count() > 1) continue;
+
+        // Dropping the manager's reference frees the content, which returns its bytes
+        remove(entry);
+        ++evictions;
+    }
+    return *usedBytes + bytes <= budget;
+}
+
+std::shared_ptr<std::vector<char>> Dvfs::DvfsResidencyManager::allocate(const uint64_t size) const {
+    std::vector<char>* memory;
+    try {
+        memory = new std::vector<char>(size);
+    } catch (...) {
+        // There's no content for a deleter to hand the bytes back from
+        *usedBytes -= size;
+        throw;
+    }
+
+    // If the control block can't be allocated, the deleter is still called
+    return {memory, [usedBytes = usedBytes, size](const std::vector<char>* content) {
+        *usedBytes -= size;
+        delete content;
+    }};
+}
+
+void Dvfs::DvfsResidencyManager::remove(const std::unordered_map<const IDvfsFile*, Entry>::iterator it) {
+    const Entry& entry = it->second;
+    if (entry.content) evictionOrder.erase({entry.priority, entry.lastUsed, it->first});
+
+    auto tagIt = tags.find(entry.tag);
+    tagIt->second.bytes -= entry.size;
+    if (--tagIt->second.fileCount == 0) tags.erase(tagIt);
+
+    // The bytes stay in use until the content is freed, which may be after callers holding it drop it
+    entries.erase(it);
+}
@@ -0,0 +1,163 @@
+#include "../include/DatVfsThreadPool.h"
+
+#include <utility>
+
+namespace {
+    /** The pool the current thread is a worker of, if any */
+    thread_local const Dvfs::DvfsThreadPool* currentPool = nullptr;
+    /** The index of the current worker's queue in currentPool */
+    thread_local size_t currentQueue = 0;
+}
+
+Dvfs::DvfsThreadPool::TaskGroup::~TaskGroup() {
+    // Tasks reference the group, so it must outlive them, but exceptions can't be thrown from here
+    drain();
+}
+
+void Dvfs::DvfsThreadPool::TaskGroup::run(std::function<void()> task) {
+    pending.fetch_add(1, std::memory_order_relaxed);
+    pool.push([this, task = std::move(task)]() {
+        // The task has to be counted as finished even if it throws, or waiting would never end
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard lock(exceptionMutex);
+            if (!exception) exception = std::current_exception();
+        }
+        pending.fetch_sub(1, std::memory_order_release);
+    });
+}
+
+void Dvfs::DvfsThreadPool::TaskGroup::wait() {
+    drain();
+
+    std::exception_ptr thrown;
+    {
+        std::lock_guard lock(exceptionMutex);
+        thrown = std::exchange(exception, nullptr);
+    }
+    if (thrown) std::rethrow_exception(thrown);
+}
+
+void Dvfs::DvfsThreadPool::TaskGroup::drain() {
+    while (pending.load(std::memory_order_acquire) != 0) {
+        // Help out instead of blocking, this keeps nested waits from starving the pool
+        if (!pool.runPendingTask()) std::this_thread::yield();
+    }
+}
+
+Dvfs::DvfsThreadPool::DvfsThreadPool(unsigned int threadCount) {
+    if (threadCount == 0) threadCount = 1;
+
+    // The extra queue is shared by threads outside the pool
+    for (unsigned int i = 0; i <= threadCount; ++i) {
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+
+    workers.reserve(threadCount);
+    for (unsigned int i = 0; i < threadCount; ++i) {
+        workers.emplace_back(&DvfsThreadPool::workerLoop, this, i);
+    }
+}
+
+Dvfs::DvfsThreadPool::~DvfsThreadPool() {
+    {
+        std::lock_guard lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (auto& worker: workers) {
+        worker.join();
+    }
+}
+
+Dvfs::DvfsThreadPool& Dvfs::DvfsThreadPool::getDefault() {
+    static DvfsThreadPool pool;
+    return pool;
+}
+
+size_t Dvfs::DvfsThreadPool::size() const {
+    return workers.size();
+}
+
+size_t Dvfs::DvfsThreadPool::localQueue() const {
+    return currentPool == this ? currentQueue : queues.size() - 1;
+}
+
+void Dvfs::DvfsThreadPool::submit(std::function<void()> task) {
+    push(std::move(task));
+}
+
+void Dvfs::DvfsThreadPool::push(std::function<void()> task) {
+    WorkQueue& queue = *queues[localQueue()];
+    {
+        std::lock_guard lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+
+    // Incremented before taking the sleep lock so a worker checking for work can't miss it
+    queuedTasks.fetch_add(1, std::memory_order_release);
+    {
+        std::lock_guard lock(sleepMutex);
+    }
+    wake.notify_one();
+}
+
+bool Dvfs::DvfsThreadPool::take(size_t preferred, std::function<void()>& task) {
+    // Newest first from our own queue, keeping the working set of the current subtree hot
+    {
+        WorkQueue& queue = *queues[preferred];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // Oldest first from everybody else, these are usually the largest pieces of work
+    for (size_t offset = 1; offset < queues.size(); ++offset) {
+        WorkQueue& queue = *queues[(preferred + offset) % queues.size()];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool Dvfs::DvfsThreadPool::runPendingTask() {
+    if (queuedTasks.load(std::memory_order_acquire) == 0) return false;
+
+    std::function<void()> task;
+    if (!take(localQueue(), task)) return false;
+
+    task();
+    return true;
+}
+
+void Dvfs::DvfsThreadPool::workerLoop(size_t index) {
+    currentPool = this;
+    currentQueue = index;
+
+    std::function<void()> task;
+    while (true) {
+        if (take(index, task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock lock(sleepMutex);
+        wake.wait(lock, [this]() {
+            return stopping || queuedTasks.load(std::memory_order_acquire) != 0;
+        });
+        if (stopping && queuedTasks.load(std::memory_order_acquire) == 0) return;
+    }
+}
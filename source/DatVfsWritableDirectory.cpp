@@ -0,0 +1,103 @@
+#include "../include/DatVfsWritableDirectory.h"
+
+#include <vector>
+
+#include "../include/DatVfs.h"
+
+Dvfs::DvfsLooseWritableDirectory::DvfsLooseWritableDirectory(DatVFS& vfs,
+                                                             DatPath mountPoint,
+                                                             std::filesystem::path directory,
+                                                             const size_t bufferCapacity) :
+        vfs(vfs),
+        mountPoint(std::move(mountPoint)),
+        directory(std::move(directory)),
+        bufferCapacity(bufferCapacity) {}
+
+Dvfs::LooseDvfsWritableFile* Dvfs::DvfsLooseWritableDirectory::findFile(const DatPath& path) const {
+    if (!mountedPaths.contains(static_cast<std::string>(path))) return nullptr;
+
+    // The file may have been unmounted or replaced since, so check it is still ours
+    return dynamic_cast<LooseDvfsWritableFile*>(vfs.getFile(DatPathBuf<>(mountPoint) /= path));
+}
+
+Dvfs::LooseDvfsWritableFile* Dvfs::DvfsLooseWritableDirectory::mountFile(const DatPath& path) {
+    const DatPath vfsPath = mountPoint / path;
+    if (vfs.exists(vfsPath) < 0) return nullptr;
+
+    // The file underneath stays readable through the new one until something is committed over it, which holds a
+    // reference to it so unmounting only takes it out of the tree
+    const std::filesystem::path filePath = directory / static_cast<std::string>(path);
+    IDvfsFile* lower = vfs.getFile(vfsPath);
+    auto* file = lower != nullptr
+            ? new LooseDvfsWritableFile(filePath, vfs, lower, bufferCapacity)
+            : new LooseDvfsWritableFile(filePath, bufferCapacity);
+    vfs.unmountFile(vfsPath);
+
+    if (!vfs.mountFile(vfsPath, file, true)) {
+        // Put the file underneath back before the new one lets go of it
+        if (lower != nullptr) vfs.mountFile(vfsPath, lower, true);
+        delete file;
+        return nullptr;
+    }
+
+    mountedPaths.insert(static_cast<std::string>(path));
+    return file;
+}
+
+int Dvfs::DvfsLooseWritableDirectory::mountExisting() {
+    std::error_code error;
+    if (!std::filesystem::is_directory(directory, error)) return 0;
+
+    int count = 0;
+    for (const auto& it: std::filesystem::recursive_directory_iterator(directory, error)) {
+        if (it.is_directory() || it.path().extension() == stagingExtension) continue;
+
+        // DatPath only takes forward slashes, which generic_string uses on every platform
+        if (mountFile(std::filesystem::relative(it.path(), directory).generic_string()) != nullptr) ++count;
+    }
+
+    return count;
+}
+
+Dvfs::IDvfsWritableFile* Dvfs::DvfsLooseWritableDirectory::openFile(const DatPath& path) {
+    if (LooseDvfsWritableFile* file = findFile(path)) return file;
+    return mountFile(path);
+}
+
+bool Dvfs::DvfsLooseWritableDirectory::commitAll() {
+    std::vector<LooseDvfsWritableFile*> pending;
+    for (const std::string& path: mountedPaths) {
+        LooseDvfsWritableFile* file = findFile(path);
+        if (file != nullptr && file->hasPendingChanges()) pending.push_back(file);
+    }
+
+    // Files that fail to sync are left staged rather than published half written
+    bool success = true;
+    std::erase_if(pending, [&success](LooseDvfsWritableFile* file) {
+        if (file->sync()) return false;
+        success = false;
+        return true;
+    });
+
+    std::set<std::filesystem::path> parents;
+    for (LooseDvfsWritableFile* file: pending) {
+        success &= file->publish();
+        parents.insert(file->getFilePath().parent_path());
+    }
+
+    for (const auto& parent: parents) {
+        success &= LooseDvfsWritableFile::syncDirectory(parent);
+    }
+
+    return success;
+}
+
+void Dvfs::DvfsLooseWritableDirectory::discardAll() {
+    for (const std::string& path: mountedPaths) {
+        if (LooseDvfsWritableFile* file = findFile(path)) file->discard();
+    }
+}
+
+const std::filesystem::path& Dvfs::DvfsLooseWritableDirectory::getDirectory() const {
+    return directory;
+}
@@ -0,0 +1,233 @@
+#include "../include/DatVfsWritableFile.h"
+
+#include <algorithm>
+#include <cerrno>
+
+#include "../include/DatVfs.h"
+
+#if __has_include(<fcntl.h>) && __has_include(<unistd.h>)
+#include <fcntl.h>
+#include <unistd.h>
+#define DATVFS_WRITABLE_FILES
+#endif
+
+Dvfs::LooseDvfsWritableFile::LooseDvfsWritableFile(std::filesystem::path filePath, const size_t bufferCapacity) :
+        committed(filePath),
+        filePath(std::move(filePath)),
+        bufferCapacity(bufferCapacity) {
+    stagingPath = this->filePath;
+    stagingPath += ".dvfs-staging";
+}
+
+Dvfs::LooseDvfsWritableFile::LooseDvfsWritableFile(std::filesystem::path filePath,
+                                                   DatVFS& vfs,
+                                                   IDvfsFile* lower,
+                                                   const size_t bufferCapacity) :
+        LooseDvfsWritableFile(std::move(filePath), bufferCapacity) {
+    this->vfs = &vfs;
+    this->lower = lower;
+    vfs.holdFile(lower);
+
+    // A file already on disk was committed over the lower one before
+    lowerVisible = !committed.isValidFile();
+}
+
+Dvfs::LooseDvfsWritableFile::~LooseDvfsWritableFile() {
+    discard();
+    if (lower != nullptr) vfs->releaseHeldFile(lower);
+}
+
+const Dvfs::IDvfsFile& Dvfs::LooseDvfsWritableFile::visible() const {
+    if (lowerVisible) return *lower;
+    return committed;
+}
+
+uint64_t Dvfs::LooseDvfsWritableFile::fileSize() const {
+    return visible().fileSize();
+}
+
+bool Dvfs::LooseDvfsWritableFile::isValidFile() const {
+    return visible().isValidFile();
+}
+
+bool Dvfs::LooseDvfsWritableFile::getContent(char* buffer) const {
+    return visible().getContent(buffer);
+}
+
+bool Dvfs::LooseDvfsWritableFile::getContentRange(char* buffer, const uint64_t offset, const uint64_t length) const {
+    return visible().getContentRange(buffer, offset, length);
+}
+
+void Dvfs::LooseDvfsWritableFile::prefetch() const {
+    visible().prefetch();
+}
+
+bool Dvfs::LooseDvfsWritableFile::stage(const bool copyExisting) {
+#ifdef DATVFS_WRITABLE_FILES
+    if (stagingFd >= 0) return true;
+
+    std::error_code error;
+    std::filesystem::create_directories(filePath.parent_path(), error);
+
+    stagedSize = 0;
+    if (copyExisting && !lowerVisible && committed.isValidFile()) {
+        std::filesystem::copy_file(filePath, stagingPath, std::filesystem::copy_options::overwrite_existing, error);
+        if (error) return false;
+        stagedSize = committed.fileSize();
+    }
+
+    stagingFd = ::open(stagingPath.c_str(), O_RDWR | O_CREAT | (stagedSize == 0 ? O_TRUNC : 0), 0644);
+    if (stagingFd < 0) return false;
+
+    // The lower file may not be on disk at all, so it's copied up through a read
+    if (copyExisting && lowerVisible && lower->isValidFile()) {
+        std::vector<char> content(lower->fileSize());
+        if (!lower->getContent(content.data()) || !writeFully(content.data(), content.size(), 0)) {
+            discard();
+            return false;
+        }
+        stagedSize = content.size();
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool Dvfs::LooseDvfsWritableFile::writeFully(const char* data, uint64_t size, uint64_t offset) const {
+#ifdef DATVFS_WRITABLE_FILES
+    while (size > 0) {
+        const ssize_t written = ::pwrite(stagingFd, data, size, static_cast<off_t>(offset));
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+
+        data += written;
+        size -= written;
+        offset += written;
+    }
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool Dvfs::LooseDvfsWritableFile::flushBuffer() {
+    if (buffer.empty()) return true;
+
+    const bool success = writeFully(buffer.data(), buffer.size(), bufferOffset);
+    buffer.clear();
+    return success;
+}
+
+bool Dvfs::LooseDvfsWritableFile::write(const char* data, const uint64_t size, const uint64_t offset) {
+    if (!stage(true)) return false;
+
+    // Coalesce writes that continue on from the buffered range
+    const bool contiguous = buffer.empty() || offset == bufferOffset + buffer.size();
+    if (!contiguous || buffer.size() + size > bufferCapacity) {
+        if (!flushBuffer()) return false;
+    }
+
+    if (size >= bufferCapacity) {
+        if (!writeFully(data, size, offset)) return false;
+    } else {
+        if (buffer.empty()) bufferOffset = offset;
+        buffer.insert(buffer.end(), data, data + size);
+    }
+
+    stagedSize = std::max(stagedSize, offset + size);
+    return true;
+}
+
+bool Dvfs::LooseDvfsWritableFile::append(const char* data, const uint64_t size) {
+    if (!stage(true)) return false;
+    return write(data, size, stagedSize);
+}
+
+bool Dvfs::LooseDvfsWritableFile::truncate(const uint64_t size) {
+    // Nothing needs copying if everything is being thrown away
+    if (!stage(size != 0)) return false;
+    if (!flushBuffer()) return false;
+
+#ifdef DATVFS_WRITABLE_FILES
+    if (::ftruncate(stagingFd, static_cast<off_t>(size)) != 0) return false;
+    stagedSize = size;
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool Dvfs::LooseDvfsWritableFile::flush() {
+    if (stagingFd < 0) return true;
+    return flushBuffer();
+}
+
+bool Dvfs::LooseDvfsWritableFile::sync() {
+    if (stagingFd < 0) return true;
+#ifdef DATVFS_WRITABLE_FILES
+    return flushBuffer() && ::fsync(stagingFd) == 0;
+#else
+    return false;
+#endif
+}
+
+bool Dvfs::LooseDvfsWritableFile::publish() {
+    if (stagingFd < 0) return true;
+    if (!flushBuffer()) return false;
+
+    // Rename is atomic, readers see either the old or the new content but never a mix
+    std::error_code error;
+    std::filesystem::rename(stagingPath, filePath, error);
+    // Nothing is lost if the rename fails, the staging file is still open and can be published again
+    if (error) return false;
+
+#ifdef DATVFS_WRITABLE_FILES
+    ::close(stagingFd);
+#endif
+    stagingFd = -1;
+    lowerVisible = false;
+    return true;
+}
+
+bool Dvfs::LooseDvfsWritableFile::commit() {
+    if (stagingFd < 0) return true;
+    return sync() && publish() && syncDirectory(filePath.parent_path());
+}
+
+void Dvfs::LooseDvfsWritableFile::discard() {
+    buffer.clear();
+    if (stagingFd < 0) return;
+
+#ifdef DATVFS_WRITABLE_FILES
+    ::close(stagingFd);
+#endif
+    stagingFd = -1;
+
+    std::error_code error;
+    std::filesystem::remove(stagingPath, error);
+}
+
+bool Dvfs::LooseDvfsWritableFile::hasPendingChanges() const {
+    return stagingFd >= 0;
+}
+
+const std::filesystem::path& Dvfs::LooseDvfsWritableFile::getFilePath() const {
+    return filePath;
+}
+
+bool Dvfs::LooseDvfsWritableFile::syncDirectory(const std::filesystem::path& directory) {
+#ifdef DATVFS_WRITABLE_FILES
+    const int fd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0) return false;
+
+    const bool success = ::fsync(fd) == 0;
+    ::close(fd);
+    return success;
+#else
+    return false;
+#endif
+}
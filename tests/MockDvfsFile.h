@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include <DatVfs.h>
+
+/**
+ * A file for tests that holds its content in memory
+ * <br>
+ * A default constructed file is empty, invalid and can't be read, a file given content is valid
+ */
+class MockDvfsFile : public Dvfs::IDvfsFile {
+public:
+    std::string content;
+    bool valid = false;
+    /** Whether reads succeed, a failed read still copies the content */
+    bool readable = true;
+    /** The number of reads made, whole or ranged */
+    mutable std::atomic<int> reads = 0;
+
+    MockDvfsFile() = default;
+
+    explicit MockDvfsFile(std::string content) : content(std::move(content)), valid(true) {}
+
+    [[nodiscard]] uint64_t fileSize() const override {
+        return content.size();
+    }
+
+    [[nodiscard]] bool isValidFile() const override {
+        return valid;
+    }
+
+    bool getContent(char* buffer) const override {
+        ++reads;
+        if (!valid) return false;
+
+        content.copy(buffer, content.size());
+        return readable;
+    }
+
+    bool getContentRange(char* buffer, uint64_t offset, uint64_t length) const override {
+        ++reads;
+        if (!valid || offset > content.size() || length > content.size() - offset) return false;
+
+        content.copy(buffer, length, offset);
+        return readable;
+    }
+};
+
+/**
+ * An inserter for tests that streams an empty MockDvfsFile for each of a list of paths
+ */
+class MockDvfsPathInserter : public Dvfs::IDvfsFileInserter {
+public:
+    std::vector<std::string> paths;
+    /** The paths that couldn't be mounted */
+    mutable std::vector<std::string> failures;
+
+    explicit MockDvfsPathInserter(std::vector<std::string> paths) : paths(std::move(paths)) {}
+
+    void forEachFile(const Visitor& visitor) const override {
+        for (const std::string& path: paths) {
+            if (!visitor(path, new MockDvfsFile)) return;
+        }
+    }
+
+    [[nodiscard]] size_t getSizeHint() const override {
+        return paths.size();
+    }
+
+    void handleInsertFailure(const std::string& path, Dvfs::IDvfsFile* idvfsFile) const override {
+        failures.push_back(path);
+        IDvfsFileInserter::handleInsertFailure(path, idvfsFile);
+    }
+};
@@ -0,0 +1,88 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <DatGlob.h>
+
+using namespace Dvfs;
+
+TEST_CASE("DatGlob wildcard matching", "[DatGlob]") {
+    SECTION("Literal") {
+        REQUIRE(DatGlob::wildcardMatch("test", "test"));
+        REQUIRE_FALSE(DatGlob::wildcardMatch("test", "test2"));
+        REQUIRE_FALSE(DatGlob::wildcardMatch("test2", "test"));
+    }
+
+    SECTION("Star") {
+        REQUIRE(DatGlob::wildcardMatch("*", ""));
+        REQUIRE(DatGlob::wildcardMatch("*", "anything"));
+        REQUIRE(DatGlob::wildcardMatch("*.dds", "texture.dds"));
+        REQUIRE(DatGlob::wildcardMatch("*.dds", ".dds"));
+        REQUIRE_FALSE(DatGlob::wildcardMatch("*.dds", "texture.png"));
+        REQUIRE(DatGlob::wildcardMatch("a*b*c", "aXXbYYbZZc"));
+        REQUIRE_FALSE(DatGlob::wildcardMatch("a*b*c", "aXXbYYbZZ"));
+    }
+
+    SECTION("Question mark") {
+        REQUIRE(DatGlob::wildcardMatch("test?", "test2"));
+        REQUIRE_FALSE(DatGlob::wildcardMatch("test?", "test"));
+        REQUIRE_FALSE(DatGlob::wildcardMatch("test?", "test22"));
+    }
+
+    SECTION("Character sets") {
+        REQUIRE(DatGlob::wildcardMatch("test[23]", "test2"));
+        REQUIRE_FALSE(DatGlob::wildcardMatch("test[23]", "test4"));
+        REQUIRE(DatGlob::wildcardMatch("test[2-4]", "test4"));
+        REQUIRE_FALSE(DatGlob::wildcardMatch("test[!2-4]", "test4"));
+        REQUIRE(DatGlob::wildcardMatch("test[!2-4]", "test5"));
+        REQUIRE(DatGlob::wildcardMatch("[]]", "]"));
+    }
+}
+
+TEST_CASE("DatGlob compilation", "[DatGlob]") {
+    SECTION("Segment types") {
+        DatGlob glob("textures/**/*.dds");
+        const auto& segments = glob.getSegments();
+
+        REQUIRE(glob.isValid());
+        REQUIRE(segments.size() == 3);
+        REQUIRE(segments[0].type == DatGlob::Segment::Type::Literal);
+        REQUIRE(segments[1].type == DatGlob::Segment::Type::Recursive);
+        REQUIRE(segments[2].type == DatGlob::Segment::Type::Wildcard);
+        REQUIRE(segments[2].suffixLength == 4);
+        REQUIRE(segments[2].minLength == 4);
+    }
+
+    SECTION("Empty segments are ignored") {
+        DatGlob glob("//textures//*.dds/");
+        REQUIRE(glob.getSegments().size() == 2);
+    }
+
+    SECTION("Repeated recursive segments are collapsed") {
+        DatGlob glob("textures/**/**/*.dds");
+        REQUIRE(glob.getSegments().size() == 3);
+    }
+
+    SECTION("Trailing recursive segment") {
+        DatGlob glob("textures/**");
+        REQUIRE(glob.getSegments().size() == 3);
+        REQUIRE(glob.matches("textures/a.dds"));
+        REQUIRE(glob.matches("textures/a/b.dds"));
+        REQUIRE_FALSE(glob.matches("textures"));
+    }
+
+    SECTION("Unterminated set") {
+        DatGlob glob("textures/[abc");
+        REQUIRE_FALSE(glob.isValid());
+        REQUIRE_FALSE(glob.matches("textures/a"));
+    }
+}
+
+TEST_CASE("DatGlob path matching", "[DatGlob]") {
+    DatGlob glob("textures/**/*.dds");
+
+    REQUIRE(glob.matches("textures/a.dds"));
+    REQUIRE(glob.matches("textures/b/a.dds"));
+    REQUIRE(glob.matches("textures/b/c/a.dds"));
+    REQUIRE_FALSE(glob.matches("textures/a.png"));
+    REQUIRE_FALSE(glob.matches("models/a.dds"));
+    REQUIRE_FALSE(glob.matches("a.dds"));
+}
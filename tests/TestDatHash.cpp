@@ -0,0 +1,39 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstring>
+#include <string>
+
+#include <DatHash.h>
+
+using namespace Dvfs;
+
+TEST_CASE("DvfsHasher", "[DvfsHasher]") {
+    SECTION("Known values") {
+        REQUIRE(DvfsHasher::hash("", 0) == 0xEF46DB3751D8E999ULL);
+        REQUIRE(DvfsHasher::hash("a", 1) == 0xD24EC4F1A98C6E5BULL);
+        REQUIRE(DvfsHasher::hash("abc", 3) == 0x44BC2CF5AD770999ULL);
+
+        const char* longer = "Nobody inspects the spammish repetition";
+        REQUIRE(DvfsHasher::hash(longer, std::strlen(longer)) == 0xFBCEA83C8A378BF1ULL);
+    }
+
+    SECTION("Seed changes the hash") {
+        REQUIRE(DvfsHasher::hash("abc", 3, 1) != DvfsHasher::hash("abc", 3, 0));
+    }
+
+    SECTION("Streaming matches one shot") {
+        std::string data;
+        for (int i = 0; i < 1000; ++i) {
+            data += static_cast<char>(i * 31);
+        }
+
+        for (size_t pieceSize: {1, 7, 31, 32, 33, 100}) {
+            DvfsHasher hasher;
+            for (size_t offset = 0; offset < data.size(); offset += pieceSize) {
+                hasher.update(data.data() + offset, std::min(pieceSize, data.size() - offset));
+            }
+
+            REQUIRE(hasher.digest() == DvfsHasher::hash(data.data(), data.size()));
+        }
+    }
+}
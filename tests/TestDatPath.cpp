@@ -66,6 +66,65 @@ TEST_CASE("DatPath initialisation", "[DatPath]") {
 
             REQUIRE((std::string) testPath == "test/path/with/many/trailing/slashes");
         }
+
+        SECTION("Formatting with repeated slashes") {
+            DatPath testPath("test//path///with////repeated/slashes");
+
+            REQUIRE((std::string) testPath == "test/path/with/repeated/slashes");
+            REQUIRE(testPath.depth() == 5);
+        }
+
+        SECTION("Formatting with only slashes") {
+            DatPath testPath("//////");
+
+            REQUIRE(testPath.empty());
+        }
+
+        SECTION("Resolving dot sections") {
+            REQUIRE((std::string) DatPath("a/./b") == "a/b");
+            REQUIRE((std::string) DatPath("a/x/../b") == "a/b");
+            REQUIRE((std::string) DatPath("./a/b/.") == "a/b");
+            REQUIRE((std::string) DatPath("a/b/../..") == "");
+        }
+
+        SECTION("Dot sections can't go above the start") {
+            REQUIRE((std::string) DatPath("../a") == "a");
+            REQUIRE((std::string) DatPath("a/../../b") == "b");
+        }
+
+        SECTION("Names starting with dots are kept") {
+            REQUIRE((std::string) DatPath(".hidden/...") == ".hidden/...");
+            REQUIRE((std::string) DatPath("a/..b/.c") == "a/..b/.c");
+        }
+    }
+
+    SECTION("Backslashes are rejected") {
+        REQUIRE_THROWS_AS(DatPath("test\\path"), std::invalid_argument);
+        REQUIRE_THROWS_AS(DatPath(std::string(40, 'a') + "\\"), std::invalid_argument);
+    }
+}
+
+TEST_CASE("DatPath case folding", "[DatPath]") {
+    SECTION("Lowercase path is its own key") {
+        DatPath path("textures/player.png");
+        REQUIRE(path.getFoldedKey() == "textures/player.png");
+    }
+
+    SECTION("Uppercase path is folded") {
+        DatPath path("Textures/Player.PNG");
+        REQUIRE((std::string) path == "Textures/Player.PNG");
+        REQUIRE(path.getFoldedKey() == "textures/player.png");
+        REQUIRE(path.split(true) == std::vector<std::string_view>{"textures", "player.png"});
+    }
+
+    SECTION("Appending keeps the folded key") {
+        REQUIRE((DatPath("Textures") / DatPath("player.png")).getFoldedKey() == "textures/player.png");
+        REQUIRE((DatPath("textures") / DatPath("Player.png")).getFoldedKey() == "textures/player.png");
+        REQUIRE((DatPath("Textures") / "Player.png").getFoldedKey() == "textures/player.png");
+    }
+
+    SECTION("Folding doesn't affect equality") {
+        REQUIRE_FALSE(DatPath("A") == DatPath("a"));
     }
 }
 
@@ -114,6 +173,14 @@ TEST_CASE("DatPath Get Root", "[DatPath]") {
 }
 
 TEST_CASE("DatPath Append") {
+    SECTION("Regular Path + Parent Path") {
+        DatPath goal("test/other");
+        DatPath base("test/path");
+        DatPath result = base / "../other";
+
+        REQUIRE(result == goal);
+    }
+
     SECTION("Regular Path + Regular Path") {
         DatPath goal("test/path");
         DatPath base("test");
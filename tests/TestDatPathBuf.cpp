@@ -0,0 +1,123 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <DatPathBuf.h>
+
+using namespace Dvfs;
+
+TEST_CASE("DatPathBuf initialisation", "[DatPathBuf]") {
+    SECTION("Empty Initialisation") {
+        DatPathBuf<> path;
+        REQUIRE(path.empty());
+        REQUIRE(path.str().empty());
+    }
+
+    SECTION("Normalises like DatPath") {
+        for (const char* text: {"a/b/c", "/a//b/", "a/./b/../c", "../a", "a/b/../..", ".hidden/x", "///"}) {
+            DatPathBuf<> path(text);
+            REQUIRE(path.str() == static_cast<std::string>(DatPath(text)));
+        }
+    }
+
+    SECTION("Backslashes are rejected") {
+        REQUIRE_THROWS_AS(DatPathBuf<>("a\\b"), std::invalid_argument);
+    }
+
+    SECTION("From DatPath") {
+        DatPath source("Textures/Player.png");
+        DatPathBuf<> path(source);
+        REQUIRE(path.str() == "Textures/Player.png");
+    }
+}
+
+TEST_CASE("DatPathBuf append", "[DatPathBuf]") {
+    SECTION("Append string") {
+        DatPathBuf<> path("textures");
+        path /= "characters/player.png";
+        REQUIRE(path.str() == "textures/characters/player.png");
+    }
+
+    SECTION("Append parent sections") {
+        DatPathBuf<> path("textures/characters");
+        path /= "../ui/button.png";
+        REQUIRE(path.str() == "textures/ui/button.png");
+    }
+
+    SECTION("Append to empty path") {
+        DatPathBuf<> path;
+        path /= "/textures/";
+        REQUIRE(path.str() == "textures");
+    }
+
+    SECTION("Append DatPath") {
+        DatPathBuf<> path("textures");
+        path /= DatPath("ui");
+        REQUIRE(path.str() == "textures/ui");
+    }
+
+    SECTION("Append leaves the original unchanged") {
+        const DatPathBuf<> base("textures");
+        DatPathBuf<> path = base / "ui";
+
+        REQUIRE(base.str() == "textures");
+        REQUIRE(path.str() == "textures/ui");
+    }
+
+    SECTION("Remove last section") {
+        DatPathBuf<> path("a/b/c");
+        path.removeLast();
+        REQUIRE(path.str() == "a/b");
+
+        path.removeLast();
+        path.removeLast();
+        REQUIRE(path.empty());
+    }
+
+    SECTION("Fold case") {
+        DatPathBuf<> path("Textures/Player.PNG");
+        path.foldCase();
+        REQUIRE(path.str() == "textures/player.png");
+    }
+}
+
+TEST_CASE("DatPathBuf storage", "[DatPathBuf]") {
+    SECTION("Short paths stay inline") {
+        DatPathBuf<16> path("a/b/c");
+        REQUIRE(path.isInline());
+    }
+
+    SECTION("Long paths spill onto the heap") {
+        DatPathBuf<16> path("a/b/c");
+        path /= "a/much/longer/path";
+
+        REQUIRE_FALSE(path.isInline());
+        REQUIRE(path.str() == "a/b/c/a/much/longer/path");
+
+        path /= "../../..";
+        REQUIRE(path.str() == "a/b/c/a");
+    }
+
+    SECTION("Copies of spilled paths are independent") {
+        DatPathBuf<4> path("abcdef");
+        DatPathBuf<4> copy = path / "g";
+
+        REQUIRE(path.str() == "abcdef");
+        REQUIRE(copy.str() == "abcdef/g");
+    }
+}
+
+TEST_CASE("DatPathBuf conversions", "[DatPathBuf]") {
+    DatPathBuf<> path("textures/player.png");
+
+    SECTION("To DatPath") {
+        DatPath converted = path;
+        REQUIRE(converted == DatPath("textures/player.png"));
+    }
+
+    SECTION("To DatPathView") {
+        DatPathView view = path;
+        REQUIRE(view.str() == "textures/player.png");
+        REQUIRE(view.front() == "textures");
+        REQUIRE(view.next().str() == "player.png");
+        REQUIRE(view.next().next().empty());
+    }
+}
@@ -0,0 +1,45 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <DatPathLiteral.h>
+
+using namespace Dvfs;
+
+TEST_CASE("DatPathLiteral compile time", "[DatPathLiteral]") {
+    SECTION("Splits sections") {
+        constexpr const auto& path = "shaders/main.vert"_dp;
+        static_assert(path.sectionCount == 2);
+        static_assert(path.getSection(0).name == "shaders");
+        static_assert(path.getSection(1).name == "main.vert");
+        static_assert(path.str() == "shaders/main.vert");
+
+        REQUIRE(path.sectionCount == 2);
+    }
+
+    SECTION("Hashes sections") {
+        constexpr const auto& path = "Shaders/Main.vert"_dp;
+        static_assert(path.getSection(0).hash == HashedName::hashName("Shaders"));
+        static_assert(path.getSection(0, true).hash == HashedName::hashName("shaders"));
+        static_assert(path.getSection(1, true).name == "main.vert");
+
+        REQUIRE(HashedName("main.vert").hash == path.getSection(1, true).hash);
+    }
+
+    SECTION("Single section") {
+        constexpr const auto& path = "readme.txt"_dp;
+        static_assert(path.sectionCount == 1);
+        static_assert(path.getSection(0).name == "readme.txt");
+    }
+}
+
+TEST_CASE("DatPathLiteral conversions", "[DatPathLiteral]") {
+    SECTION("To DatPath") {
+        DatPath path = "textures/player.png"_dp;
+        REQUIRE(path == DatPath("textures/player.png"));
+        REQUIRE(path.getFoldedKey() == "textures/player.png");
+    }
+
+    SECTION("To DatPathView") {
+        DatPathView view = "textures/player.png"_dp;
+        REQUIRE(view.front() == "textures");
+    }
+}
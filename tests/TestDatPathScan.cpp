@@ -0,0 +1,111 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <DatPathScan.h>
+
+using namespace Dvfs;
+
+namespace {
+    void requireSameAsScalar(std::string_view path) {
+        REQUIRE(DatPathScan::scan(path) == DatPathScan::scanScalar(path));
+
+        std::vector<std::string_view> parts;
+        std::vector<std::string_view> scalarParts;
+        DatPathScan::split(path, parts);
+        DatPathScan::splitScalar(path, scalarParts);
+        REQUIRE(parts == scalarParts);
+    }
+}
+
+TEST_CASE("DatPathScan scanning", "[DatPathScan]") {
+    SECTION("Empty path") {
+        const DatPathScan scan = DatPathScan::scan("");
+        REQUIRE(scan.separators == 0);
+        REQUIRE_FALSE(scan.hasBackslash);
+        REQUIRE_FALSE(scan.hasRepeatedSeparator);
+    }
+
+    SECTION("Counts separators") {
+        REQUIRE(DatPathScan::scan("a/b/c").separators == 2);
+        REQUIRE(DatPathScan::scan("/a/b/c/").separators == 4);
+    }
+
+    SECTION("Finds backslashes") {
+        REQUIRE(DatPathScan::scan("a\\b").hasBackslash);
+        REQUIRE(DatPathScan::scan(std::string(100, 'a') + "\\").hasBackslash);
+        REQUIRE_FALSE(DatPathScan::scan(std::string(100, 'a')).hasBackslash);
+    }
+
+    SECTION("Finds repeated separators") {
+        REQUIRE(DatPathScan::scan("a//b").hasRepeatedSeparator);
+        REQUIRE_FALSE(DatPathScan::scan("a/b/c").hasRepeatedSeparator);
+    }
+
+    SECTION("Finds dot sections") {
+        REQUIRE(DatPathScan::scan(".").hasDotSection);
+        REQUIRE(DatPathScan::scan("a/../b").hasDotSection);
+        REQUIRE_FALSE(DatPathScan::scan("a.b/c.d").hasDotSection);
+        REQUIRE(DatPathScan::scan(std::string(40, 'a') + "/.").hasDotSection);
+    }
+
+    SECTION("Finds uppercase letters") {
+        REQUIRE(DatPathScan::scan("a/B").hasUppercase);
+        REQUIRE(DatPathScan::scan(std::string(40, 'a') + "Z").hasUppercase);
+        REQUIRE_FALSE(DatPathScan::scan(std::string(40, 'a') + "@[`{\xff").hasUppercase);
+    }
+
+    SECTION("Finds repeated separators across block boundaries") {
+        for (size_t i = 1; i < 70; ++i) {
+            std::string path(80, 'a');
+            path[i - 1] = '/';
+            path[i] = '/';
+
+            REQUIRE(DatPathScan::scan(path).hasRepeatedSeparator);
+            REQUIRE(DatPathScan::scan(path).separators == 2);
+        }
+    }
+}
+
+TEST_CASE("DatPathScan splitting", "[DatPathScan]") {
+    SECTION("Skips empty sections") {
+        std::vector<std::string_view> parts;
+        DatPathScan::split("//a//bc/def//", parts);
+
+        REQUIRE(parts == std::vector<std::string_view>{"a", "bc", "def"});
+    }
+
+    SECTION("Splits long paths") {
+        const std::string path = "textures/characters/player/armour/chest/iron_chestplate_normal_map.png";
+        std::vector<std::string_view> parts;
+        DatPathScan::split(path, parts);
+
+        REQUIRE(parts.size() == 6);
+        REQUIRE(parts.front() == "textures");
+        REQUIRE(parts.back() == "iron_chestplate_normal_map.png");
+    }
+}
+
+TEST_CASE("DatPathScan matches the scalar implementation", "[DatPathScan]") {
+    SECTION("Every separator layout in a short path") {
+        // Each bit decides whether that character is a separator
+        for (uint32_t layout = 0; layout < (1u << 12); ++layout) {
+            std::string path;
+            for (size_t i = 0; i < 12; ++i) path += (layout >> i) & 1 ? '/' : ".A"[i % 2];
+
+            requireSameAsScalar(path);
+        }
+    }
+
+    SECTION("Separators at every position in a long path") {
+        for (size_t i = 0; i < 100; ++i) {
+            std::string path(100, 'a');
+            path[i] = '/';
+            path[(i * 7) % 100] = '/';
+            path[(i * 13) % 100] = '\\';
+            path[(i * 3) % 100] = '.';
+            path[(i * 11) % 100] = static_cast<char>('@' + i % 28);
+
+            requireSameAsScalar(path);
+            requireSameAsScalar(std::string_view(path).substr(i));
+        }
+    }
+}
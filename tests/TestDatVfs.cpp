@@ -1,24 +1,15 @@
 #include <catch2/catch_test_macros.hpp>
+#include <algorithm>
 #include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
 
 #include <DatVfs.h>
 
-using namespace Dvfs;
-
-class MockDvfsFile : public IDvfsFile {
-public:
-    [[nodiscard]] uint64_t fileSize() const override {
-        return 0;
-    }
+#include "MockDvfsFile.h"
 
-    [[nodiscard]] bool isValidFile() const override {
-        return false;
-    }
-
-    bool getContent(char* buffer) const override {
-        return false;
-    }
-};
+using namespace Dvfs;
 
 class MockDvfsFileInserter : public IDvfsFileInserter {
 public:
@@ -74,7 +65,6 @@ TEST_CASE("DatVFS Empty VFS", "[DatVFS]") {
         REQUIRE(vfs->exists(path) == 1);
     }
 
-
     SECTION("Mount File reference counting") {
         DatPath path("test");
         DatPath path2("test2");
@@ -96,6 +86,49 @@ TEST_CASE("DatVFS Empty VFS", "[DatVFS]") {
         REQUIRE(file->getReferenceCount() == 1);
     }
 
+    SECTION("Mount file at more than 255 paths") {
+        IDvfsFile* file = new MockDvfsFile;
+        for (int i = 0; i < 1000; ++i) {
+            REQUIRE(vfs->mountFile(DatPath("alias") / std::to_string(i), file, true));
+        }
+        REQUIRE(file->getReferenceCount() == 1000);
+
+        for (int i = 0; i < 999; ++i) {
+            REQUIRE(vfs->unmountFile(DatPath("alias") / std::to_string(i)));
+        }
+        REQUIRE(file->getReferenceCount() == 1);
+        REQUIRE(vfs->getFile("alias/999") == file);
+    }
+
+    SECTION("Mount file shared between threads") {
+        IDvfsFile* file = new MockDvfsFile;
+        REQUIRE(vfs->mountFile("shared", file));
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([file]() {
+                DatVFS local;
+                for (int i = 0; i < 1000; ++i) {
+                    local.mountFile("shared", file);
+                    local.unmountFile("shared");
+                }
+            });
+        }
+        for (std::thread& thread: threads) thread.join();
+
+        // The VFS's own reference kept the file alive throughout
+        REQUIRE(file->getReferenceCount() == 1);
+    }
+
+    SECTION("Failed inserts of shared files aren't deleted") {
+        IDvfsFile* file = new MockDvfsFile;
+        REQUIRE(vfs->mountFile("shared", file));
+
+        MockDvfsFileInserter().handleInsertFailure("shared", file);
+        REQUIRE(vfs->getFile("shared") == file);
+        REQUIRE(file->getReferenceCount() == 1);
+    }
+
     SECTION("Mount file Create Directories") {
         DatPath path("test/create/directories");
         REQUIRE(vfs->mountFile(path, new MockDvfsFile, true));
@@ -109,7 +142,7 @@ TEST_CASE("DatVFS Empty VFS", "[DatVFS]") {
     }
 
     SECTION("Mount files, create directories") {
-        REQUIRE(vfs->mountFiles("", MockDvfsFileInserter(), true) == 16);
+        REQUIRE(vfs->mountFiles("", MockDvfsFileInserter(), true).fileCount == 16);
 
         REQUIRE(vfs->exists("test"));
         REQUIRE(vfs->exists("test2"));
@@ -130,7 +163,7 @@ TEST_CASE("DatVFS Empty VFS", "[DatVFS]") {
     }
 
     SECTION("Mount files, don't create directories") {
-        REQUIRE(vfs->mountFiles("", MockDvfsFileInserter(), false) == 4);
+        REQUIRE(vfs->mountFiles("", MockDvfsFileInserter(), false).fileCount == 4);
 
         REQUIRE(vfs->exists("test"));
         REQUIRE(vfs->exists("test2"));
@@ -174,7 +207,6 @@ TEST_CASE("DatVFS Empty VFS", "[DatVFS]") {
         REQUIRE(vfs->empty(path));
     }
 
-
     SECTION("Sub-directory contains file") {
         DatPath path("test");
         vfs->createDirectory(path);
@@ -255,4 +287,284 @@ TEST_CASE("DatVFS populated VFS", "[DatVFS]") {
     SECTION("Count files recursive") {
         REQUIRE(vfs->countDirectories("", true) == 3);
     }
-}
\ No newline at end of file
+
+    // Count Files Parallel
+    SECTION("Count files parallel") {
+        REQUIRE(vfs->countFilesParallel("directory", false) == 4);
+    }
+
+    SECTION("Count files parallel recursive") {
+        REQUIRE(vfs->countFilesParallel() == 16);
+        REQUIRE(vfs->countFilesParallel("directory2") == 8);
+    }
+
+    SECTION("Count files parallel with predicate") {
+        int count = vfs->countFilesParallel("", true, [](const std::string& name, IDvfsFile* file){
+            return name.length() > 4;
+        });
+        REQUIRE(count == 12);
+    }
+
+    // Count Directories Parallel
+    SECTION("Count directories parallel") {
+        REQUIRE(vfs->countDirectoriesParallel("", false) == 2);
+        REQUIRE(vfs->countDirectoriesParallel() == 3);
+    }
+
+    SECTION("Count directories parallel with predicate") {
+        int count = vfs->countDirectoriesParallel("", true, [](const std::string& name, DatVFS* directory){
+            return name.length() > 9;
+        });
+        REQUIRE(count == 1);
+    }
+
+    // Walk Files Parallel
+    SECTION("Walk files parallel") {
+        std::mutex mutex;
+        std::vector<std::string> paths;
+        REQUIRE(vfs->walkFilesParallel("directory2", [&](const DatPath& directory, const std::string& name, IDvfsFile* file){
+            std::lock_guard lock(mutex);
+            paths.push_back(static_cast<std::string>(directory / name));
+        }));
+        std::ranges::sort(paths);
+
+        REQUIRE(paths == std::vector<std::string>{
+                "directory/test", "directory/test2", "directory/test3", "directory/test4",
+                "test", "test2", "test3", "test4"
+        });
+    }
+
+    SECTION("Walk files parallel missing directory") {
+        REQUIRE_FALSE(vfs->walkFilesParallel("missing", [](const DatPath&, const std::string&, IDvfsFile*){}));
+    }
+
+    // Glob
+    SECTION("Glob literal") {
+        auto result = vfs->glob("directory2/directory/test3");
+        REQUIRE(result.size() == 1);
+        REQUIRE(result[0] == DatPath("directory2/directory/test3"));
+    }
+
+    SECTION("Glob wildcard") {
+        auto result = vfs->glob("directory*/test?");
+        std::ranges::sort(result, {}, [](const DatPath& path){return static_cast<std::string>(path);});
+
+        REQUIRE(result == std::vector<DatPath>{
+                "directory/test2", "directory/test3", "directory/test4",
+                "directory2/test2", "directory2/test3", "directory2/test4"
+        });
+    }
+
+    SECTION("Glob recursive") {
+        REQUIRE(vfs->glob("**/test").size() == 4);
+        REQUIRE(vfs->glob("directory2/**").size() == 8);
+        REQUIRE(vfs->glob("**").size() == 16);
+    }
+
+    SECTION("Glob repeated recursive matches each file once") {
+        REQUIRE(vfs->mountFile("a/x/x/f", new MockDvfsFile, true));
+        REQUIRE(vfs->mountFile("x/y/x/g", new MockDvfsFile, true));
+
+        int calls = 0;
+        int count = vfs->glob("**/x/**", [&calls](const DatPath&, IDvfsFile*){
+            ++calls;
+            return true;
+        });
+        REQUIRE(count == 2);
+        REQUIRE(calls == 2);
+
+        auto result = vfs->glob("a/**/x/**");
+        REQUIRE(result == std::vector<DatPath>{"a/x/x/f"});
+    }
+
+    SECTION("Glob no match") {
+        REQUIRE(vfs->glob("missing/**/test").empty());
+        REQUIRE(vfs->glob("directory/directory/*").empty());
+        REQUIRE(vfs->glob("").empty());
+    }
+
+    SECTION("Glob streaming stops early") {
+        int seen = 0;
+        int count = vfs->glob("**", [&seen](const DatPath&, IDvfsFile*){
+            return ++seen < 3;
+        });
+        REQUIRE(count == 3);
+        REQUIRE(seen == 3);
+    }
+
+    // Prune
+    SECTION("Prune") {
+        REQUIRE(vfs->createDirectory("empty/nested/deeper", true));
+        REQUIRE(vfs->createDirectory("directory/empty"));
+
+        REQUIRE(vfs->prune("", true) == 4);
+        REQUIRE_FALSE(vfs->exists("empty"));
+        REQUIRE_FALSE(vfs->exists("directory/empty"));
+        REQUIRE(vfs->countFiles("", true) == 16);
+    }
+
+    SECTION("Prune parallel") {
+        REQUIRE(vfs->createDirectory("empty/nested/deeper", true));
+        REQUIRE(vfs->createDirectory("directory/empty"));
+
+        REQUIRE(vfs->pruneParallel() == 4);
+        REQUIRE_FALSE(vfs->exists("empty"));
+        REQUIRE_FALSE(vfs->exists("directory/empty"));
+        REQUIRE(vfs->countFiles("", true) == 16);
+    }
+
+    SECTION("Normalised paths") {
+        REQUIRE(vfs->getFile("directory/./missing/../test") == vfs->getFile("directory/test"));
+        REQUIRE(vfs->getDirectory("directory2//directory/.") == vfs->getDirectory("directory2/directory"));
+        REQUIRE(vfs->getFile("../../test") == vfs->getFile("test"));
+        REQUIRE(vfs->getFile("directory/..") == nullptr);
+    }
+
+    SECTION("Lookups with DatPathBuf") {
+        DatPathBuf<> base("directory2");
+
+        REQUIRE(vfs->getFile(base / "directory/test") == vfs->getFile("directory2/directory/test"));
+        REQUIRE(vfs->getDirectory(base / "directory") == vfs->getDirectory("directory2/directory"));
+        REQUIRE(vfs->exists(base / "test") == 1);
+        REQUIRE(vfs->exists(base / "directory") == -1);
+        REQUIRE(vfs->exists(base / "missing/test") == 0);
+        REQUIRE(vfs->getFile(DatPathBuf<>()) == nullptr);
+
+        // Functions without a view overload take the DatPath conversion
+        REQUIRE(vfs->countFiles(base, true) == 8);
+    }
+
+    SECTION("Lookups with path literals") {
+        REQUIRE(vfs->getFile("directory2/directory/test"_dp) == vfs->getFile("directory2/directory/test"));
+        REQUIRE(vfs->getFile("test"_dp) == vfs->getFile("test"));
+        REQUIRE(vfs->getDirectory("directory2/directory"_dp) == vfs->getDirectory("directory2/directory"));
+        REQUIRE(vfs->exists("directory/test2"_dp) == 1);
+        REQUIRE(vfs->exists("directory2"_dp) == -1);
+        REQUIRE(vfs->exists("missing/test"_dp) == 0);
+        REQUIRE(vfs->getFile("directory"_dp) == nullptr);
+
+        // Functions without a literal overload take the DatPath conversion
+        REQUIRE(vfs->countFiles("directory"_dp) == 4);
+    }
+
+    SECTION("No link entries") {
+        std::vector<std::string> directories = vfs->listDirectories("");
+        std::ranges::sort(directories);
+
+        REQUIRE(directories == std::vector<std::string>{"directory", "directory2"});
+        REQUIRE(vfs->countDirectories("", true) == 3);
+        REQUIRE_FALSE(vfs->exists(".."));
+    }
+
+    delete vfs;
+}
+
+TEST_CASE("DatVFS case-insensitive", "[DatVFS]") {
+    DatVFS vfs;
+    REQUIRE(vfs.setCaseInsensitive(true));
+    REQUIRE(vfs.isCaseInsensitive());
+
+    IDvfsFile* file = new MockDvfsFile;
+    REQUIRE(vfs.mountFile("Textures/Player.PNG", file, true));
+
+    SECTION("Lookups ignore case") {
+        REQUIRE(vfs.getFile("textures/player.png") == file);
+        REQUIRE(vfs.getFile(DatPathBuf<>("TEXTURES/player.PNG")) == file);
+        REQUIRE(vfs.getFile("Textures/PLAYER.png"_dp) == file);
+        REQUIRE(vfs.getFile("TEXTURES/PLAYER.PNG") == file);
+        REQUIRE(vfs.getDirectory("TeXtUrEs") != nullptr);
+        REQUIRE(vfs.exists("textures/PLAYER.png") == 1);
+    }
+
+    SECTION("Mounting a path differing only in case fails") {
+        IDvfsFile* other = new MockDvfsFile;
+        REQUIRE_FALSE(vfs.mountFile("textures/player.png", other));
+        delete other;
+    }
+
+    SECTION("Names are stored folded") {
+        REQUIRE(vfs.listFiles("Textures") == std::vector<std::string>{"player.png"});
+    }
+
+    SECTION("Globs ignore case") {
+        REQUIRE(vfs.glob("TEXTURES/*.png") == std::vector<DatPath>{"textures/player.png"});
+    }
+
+    SECTION("Extensions ignore case") {
+        REQUIRE(vfs.findByExtension("png").size() == 1);
+        REQUIRE(vfs.findByExtension("PNG").size() == 1);
+    }
+
+    SECTION("Setting can't change once populated") {
+        REQUIRE_FALSE(vfs.setCaseInsensitive(false));
+        REQUIRE(vfs.isCaseInsensitive());
+    }
+}
+
+TEST_CASE("DatVFS streamed inserts", "[DatVFS]") {
+    DatVFS vfs;
+
+    SECTION("Files are mounted as they're streamed") {
+        const MockDvfsPathInserter inserter({"a/1", "a/2", "b/c/1", "a/3", "./b//c/2", "root"});
+        REQUIRE(vfs.mountFiles("base", inserter, true).fileCount == 6);
+        REQUIRE(inserter.failures.empty());
+
+        REQUIRE(vfs.countFiles("base/a") == 3);
+        REQUIRE(vfs.countFiles("base/b/c") == 2);
+        REQUIRE(vfs.exists("base/root") == 1);
+    }
+
+    SECTION("Failed entries are handed back") {
+        REQUIRE(vfs.mountFile("a/1", new MockDvfsFile, true));
+
+        const MockDvfsPathInserter inserter({"a/1", "a/2", "bad\\path", "a/1/2", "..", "missing/1"});
+        REQUIRE(vfs.mountFiles("", inserter, false).fileCount == 1);
+        REQUIRE(inserter.failures == std::vector<std::string>{"a/1", "bad\\path", "a/1/2", "..", "missing/1"});
+        REQUIRE(vfs.countFiles("a") == 2);
+    }
+
+    SECTION("Case-insensitive inserts are folded") {
+        REQUIRE(vfs.setCaseInsensitive(true));
+
+        const MockDvfsPathInserter inserter({"Dir/File", "DIR/Other", "dir/FILE"});
+        REQUIRE(vfs.mountFiles("", inserter, true).fileCount == 2);
+        REQUIRE(inserter.failures == std::vector<std::string>{"dir/FILE"});
+        REQUIRE(vfs.listFiles("dir").size() == 2);
+    }
+
+    SECTION("getAllFiles collects streamed files") {
+        const MockDvfsPathInserter inserter({"a", "b/c"});
+        auto files = inserter.getAllFiles();
+        REQUIRE(files.size() == 2);
+        REQUIRE(files[1].first == "b/c");
+
+        for (const auto& [path, file]: files) delete file;
+    }
+
+    SECTION("A throwing getAllFiles doesn't leave the inserter marked") {
+        // Collects through the default forEachFile until it fails, then streams through the default getAllFiles
+        struct FlakyInserter : public MockDvfsPathInserter {
+            mutable bool failing = true;
+
+            FlakyInserter() : MockDvfsPathInserter({"a"}) {}
+
+            [[nodiscard]] std::vector<pair> getAllFiles() const override {
+                if (failing) throw std::runtime_error("failed");
+                return IDvfsFileInserter::getAllFiles();
+            }
+
+            void forEachFile(const Visitor& visitor) const override {
+                if (failing) IDvfsFileInserter::forEachFile(visitor);
+                else MockDvfsPathInserter::forEachFile(visitor);
+            }
+        };
+
+        const FlakyInserter inserter;
+        REQUIRE_THROWS_AS(inserter.forEachFile([](std::string_view, IDvfsFile*) { return true; }), std::runtime_error);
+
+        inserter.failing = false;
+        auto files = inserter.getAllFiles();
+        REQUIRE(files.size() == 1);
+        for (const auto& [path, file]: files) delete file;
+    }
+}
@@ -0,0 +1,130 @@
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <DatVfs.h>
+
+#include "MockDvfsFile.h"
+
+using namespace Dvfs;
+
+namespace {
+    /**
+     * Runs work on a new thread every time, to check coroutines resume wherever the executor chooses
+     */
+    class ThreadExecutor : public IDvfsExecutor {
+        std::mutex mutex;
+        std::vector<std::thread> threads;
+
+    public:
+        std::atomic<int> executed = 0;
+
+        ~ThreadExecutor() override {
+            std::unique_lock lock(mutex);
+            std::vector<std::thread> finished = std::move(threads);
+            lock.unlock();
+
+            for (std::thread& thread: finished) thread.join();
+        }
+
+        void execute(std::function<void()> work) override {
+            // The work may run and queue more work before emplace_back returns
+            std::lock_guard lock(mutex);
+            ++executed;
+            threads.emplace_back(std::move(work));
+        }
+    };
+
+    DvfsTask<std::string> readString(const DatVFS& vfs, const DatPath& path, IDvfsExecutor& executor) {
+        std::vector<char> content = co_await vfs.read(path, executor);
+        co_return std::string(content.begin(), content.end());
+    }
+
+    DvfsTask<std::string> readBoth(const DatVFS& vfs, IDvfsExecutor& executor) {
+        std::string first = co_await readString(vfs, "a.txt", executor);
+        std::string second = co_await readString(vfs, "dir/b.txt", executor);
+        co_return first + second;
+    }
+
+    DvfsTask<size_t> readRepeatedly(const IDvfsFile& file, IDvfsExecutor& executor, int times) {
+        char buffer[3];
+        size_t succeeded = 0;
+        for (int i = 0; i < times; ++i) {
+            if (co_await file.readRange(buffer, 4, 3, executor)) ++succeeded;
+        }
+        co_return succeeded;
+    }
+
+    DvfsTask<> fail() {
+        co_await std::suspend_never();
+        throw std::runtime_error("failed");
+    }
+}
+
+TEST_CASE("DvfsTask", "[DvfsTask]") {
+    DatVFS vfs;
+    REQUIRE(vfs.mountFile("a.txt", new MockDvfsFile("hello ")));
+    REQUIRE(vfs.mountFile("dir/b.txt", new MockDvfsFile("world"), true));
+
+    SECTION("Inline executor") {
+        DvfsInlineExecutor executor;
+        REQUIRE(readBoth(vfs, executor).wait() == "hello world");
+    }
+
+    SECTION("Pool executor") {
+        REQUIRE(readBoth(vfs, DvfsPoolExecutor::getDefault()).wait() == "hello world");
+    }
+
+    SECTION("Custom executor") {
+        ThreadExecutor executor;
+        REQUIRE(readBoth(vfs, executor).wait() == "hello world");
+        REQUIRE(executor.executed == 2);
+    }
+
+    SECTION("Missing files don't suspend") {
+        ThreadExecutor executor;
+        REQUIRE(readString(vfs, "missing.txt", executor).wait().empty());
+        REQUIRE(executor.executed == 0);
+    }
+
+    SECTION("Exceptions reach the awaiter") {
+        REQUIRE_THROWS_AS(fail().wait(), std::runtime_error);
+    }
+}
+
+TEST_CASE("IDvfsFile ranges", "[DvfsTask]") {
+    MockDvfsFile file("0123456789");
+    char buffer[10] = {};
+
+    SECTION("Get content range") {
+        REQUIRE(file.getContentRange(buffer, 2, 5));
+        REQUIRE(std::string(buffer, 5) == "23456");
+        REQUIRE(file.getContentRange(buffer, 10, 0));
+        REQUIRE_FALSE(file.getContentRange(buffer, 8, 3));
+        REQUIRE_FALSE(file.getContentRange(buffer, 11, 0));
+    }
+
+    SECTION("Loose file range") {
+        const LooseDvfsFile loose("../../include/DatVfsAsync.h");
+        REQUIRE(loose.getContentRange(buffer, 0, 9));
+        REQUIRE(std::string(buffer, 9) == "#pragma o");
+        REQUIRE_FALSE(loose.getContentRange(buffer, loose.fileSize() - 1, 2));
+    }
+
+    SECTION("Awaiting in a loop doesn't grow the stack") {
+        DvfsInlineExecutor executor;
+        REQUIRE(readRepeatedly(file, executor, 100000).wait() == 100000);
+        REQUIRE(readRepeatedly(file, DvfsPoolExecutor::getDefault(), 1000).wait() == 1000);
+    }
+
+    SECTION("Await a range") {
+        auto read = [](const IDvfsFile& file, char* buffer) -> DvfsTask<bool> {
+            co_return co_await file.readRange(buffer, 4, 3);
+        };
+        REQUIRE(read(file, buffer).wait());
+        REQUIRE(std::string(buffer, 3) == "456");
+    }
+}
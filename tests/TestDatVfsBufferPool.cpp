@@ -0,0 +1,105 @@
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <DatVfs.h>
+
+using namespace Dvfs;
+
+TEST_CASE("DvfsAlignedBufferPool", "[DvfsAlignedBufferPool]") {
+    DvfsAlignedBufferPool pool(64 * 1024);
+
+    SECTION("Buffers are aligned and rounded up") {
+        DvfsAlignedBufferPool::Buffer small = pool.acquire(1);
+        DvfsAlignedBufferPool::Buffer large = pool.acquire(10000);
+
+        REQUIRE(reinterpret_cast<uintptr_t>(small.data()) % DvfsAlignedBufferPool::alignment == 0);
+        REQUIRE(reinterpret_cast<uintptr_t>(large.data()) % DvfsAlignedBufferPool::alignment == 0);
+        REQUIRE(small.size() == DvfsAlignedBufferPool::alignment);
+        REQUIRE(large.size() == 16384);
+    }
+
+    SECTION("Released buffers are reused") {
+        char* memory;
+        {
+            DvfsAlignedBufferPool::Buffer buffer = pool.acquire(8192);
+            memory = buffer.data();
+        }
+        REQUIRE(pool.getCachedBytes() == 8192);
+
+        DvfsAlignedBufferPool::Buffer buffer = pool.acquire(5000);
+        REQUIRE(buffer.data() == memory);
+        REQUIRE(pool.getCachedBytes() == 0);
+    }
+
+    SECTION("Buffers over the limit are freed") {
+        {
+            DvfsAlignedBufferPool::Buffer first = pool.acquire(32 * 1024);
+            DvfsAlignedBufferPool::Buffer second = pool.acquire(32 * 1024);
+            DvfsAlignedBufferPool::Buffer third = pool.acquire(32 * 1024);
+        }
+        REQUIRE(pool.getCachedBytes() == 64 * 1024);
+    }
+
+    SECTION("Moving a buffer") {
+        DvfsAlignedBufferPool::Buffer buffer = pool.acquire(4096);
+        char* memory = buffer.data();
+
+        DvfsAlignedBufferPool::Buffer moved = std::move(buffer);
+        REQUIRE_FALSE(buffer);
+        REQUIRE(moved.data() == memory);
+
+        moved = pool.acquire(4096);
+        REQUIRE(pool.getCachedBytes() == 4096);
+    }
+}
+
+TEST_CASE("LooseDvfsFile direct reads", "[DvfsAlignedBufferPool]") {
+    LooseDvfsFile file("../../include/DatVfs.h");
+    const uint64_t size = file.fileSize();
+    REQUIRE(size > 3 * DvfsAlignedBufferPool::alignment);
+
+    std::vector<char> expected(size);
+    REQUIRE(file.getContent(expected.data()));
+
+    LooseDvfsFile::setDirectReadThreshold(1);
+    REQUIRE(LooseDvfsFile::getDirectReadThreshold() == 1);
+
+    SECTION("Whole file into an unaligned buffer") {
+        std::vector<char> content(size + 1);
+        REQUIRE(file.getContent(content.data() + 1));
+        REQUIRE(std::equal(expected.begin(), expected.end(), content.begin() + 1));
+    }
+
+    SECTION("Whole file into a pool buffer") {
+        DvfsAlignedBufferPool::Buffer buffer = DatVFS::getBufferPool().acquire(size);
+        REQUIRE(file.getContent(buffer.data()));
+        REQUIRE(std::equal(expected.begin(), expected.end(), buffer.data()));
+    }
+
+    SECTION("Ranges") {
+        const uint64_t alignment = DvfsAlignedBufferPool::alignment;
+        const std::pair<uint64_t, uint64_t> ranges[] = {
+                {0, 1}, {1, alignment}, {alignment, alignment}, {alignment - 3, 2 * alignment + 7}, {size - 5, 5}, {0, size}
+        };
+
+        for (const auto& [offset, length]: ranges) {
+            DvfsAlignedBufferPool::Buffer buffer = DatVFS::getBufferPool().acquire(length);
+            REQUIRE(file.getContentRange(buffer.data(), offset, length));
+            REQUIRE(std::equal(expected.begin() + static_cast<std::ptrdiff_t>(offset),
+                               expected.begin() + static_cast<std::ptrdiff_t>(offset + length), buffer.data()));
+        }
+
+        char byte;
+        REQUIRE_FALSE(file.getContentRange(&byte, size, 1));
+    }
+
+    SECTION("Missing files still fail") {
+        LooseDvfsFile missing("../../include/Missing.h");
+        char byte;
+        REQUIRE_FALSE(missing.getContent(&byte));
+    }
+
+    LooseDvfsFile::setDirectReadThreshold(0);
+}
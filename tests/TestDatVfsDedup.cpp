@@ -0,0 +1,110 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <DatVfs.h>
+
+#include "MockDvfsFile.h"
+
+using namespace Dvfs;
+
+TEST_CASE("DvfsDeduplicator", "[DvfsDeduplicator]") {
+    DvfsDeduplicator deduplicator;
+    MockDvfsFile a("content");
+    MockDvfsFile b("content");
+    MockDvfsFile c("different");
+
+    SECTION("Identical content is shared") {
+        REQUIRE(deduplicator.deduplicate(&a) == &a);
+        REQUIRE(deduplicator.deduplicate(&b) == &a);
+        REQUIRE(deduplicator.deduplicate(&c) == &c);
+
+        REQUIRE(deduplicator.size() == 2);
+        REQUIRE(deduplicator.getDuplicateCount() == 1);
+        REQUIRE(deduplicator.getBytesSaved() == 7);
+    }
+
+    SECTION("Forgotten files aren't shared") {
+        REQUIRE(deduplicator.deduplicate(&a) == &a);
+        deduplicator.forget(&a);
+
+        REQUIRE(deduplicator.size() == 0);
+        REQUIRE(deduplicator.deduplicate(&b) == &b);
+    }
+
+    SECTION("Files over the maximum size are ignored") {
+        DvfsDeduplicator small(4);
+        REQUIRE(small.deduplicate(&a) == &a);
+        REQUIRE(small.deduplicate(&b) == &b);
+        REQUIRE(small.size() == 0);
+    }
+
+    SECTION("Verified content") {
+        DvfsDeduplicator verifying(DvfsDeduplicator::defaultMaxFileSize, true);
+        REQUIRE(verifying.deduplicate(&a) == &a);
+        REQUIRE(verifying.deduplicate(&b) == &a);
+    }
+}
+
+TEST_CASE("DatVFS deduplication", "[DatVFS][DvfsDeduplicator]") {
+    DatVFS vfs;
+
+    SECTION("Disabled by default") {
+        REQUIRE(vfs.getDeduplicator() == nullptr);
+        REQUIRE(vfs.mountFile("a", new MockDvfsFile("content")));
+        REQUIRE(vfs.mountFile("b", new MockDvfsFile("content")));
+        REQUIRE(vfs.getFile("a") != vfs.getFile("b"));
+    }
+
+    SECTION("Mounting shares identical files") {
+        vfs.enableDeduplication();
+        REQUIRE(vfs.mountFile("a", new MockDvfsFile("content")));
+        REQUIRE(vfs.mountFile("directory/b", new MockDvfsFile("content"), true));
+        REQUIRE(vfs.mountFile("c", new MockDvfsFile("different")));
+
+        IDvfsFile* shared = vfs.getFile("a");
+        REQUIRE(vfs.getFile("directory/b") == shared);
+        REQUIRE(vfs.getFile("c") != shared);
+        REQUIRE(shared->getReferenceCount() == 2);
+        REQUIRE(vfs.getDeduplicator()->getDuplicateCount() == 1);
+    }
+
+    SECTION("Shared files survive unmounting one path") {
+        vfs.enableDeduplication();
+        REQUIRE(vfs.mountFile("a", new MockDvfsFile("content")));
+        REQUIRE(vfs.mountFile("b", new MockDvfsFile("content")));
+
+        REQUIRE(vfs.unmountFile("a"));
+        REQUIRE(vfs.getFile("b")->getReferenceCount() == 1);
+        REQUIRE(vfs.getDeduplicator()->size() == 1);
+
+        REQUIRE(vfs.unmountFile("b"));
+        REQUIRE(vfs.getDeduplicator()->size() == 0);
+    }
+
+    SECTION("Enabling merges existing duplicates") {
+        REQUIRE(vfs.mountFile("a", new MockDvfsFile("content")));
+        REQUIRE(vfs.mountFile("directory/b", new MockDvfsFile("content"), true));
+        vfs.enableIndex();
+
+        vfs.enableDeduplication();
+        REQUIRE(vfs.getFile("a") == vfs.getFile("directory/b"));
+        REQUIRE(vfs.getFile("a")->getReferenceCount() == 2);
+        REQUIRE(vfs.findByExtension("")[0].file == vfs.getFile("a"));
+        REQUIRE(vfs.findByExtension("")[1].file == vfs.getFile("a"));
+    }
+
+    SECTION("Files already in a VFS aren't replaced") {
+        DatVFS other;
+        IDvfsFile* file = new MockDvfsFile("content");
+        REQUIRE(other.mountFile("a", file));
+
+        vfs.enableDeduplication();
+        REQUIRE(vfs.mountFile("a", new MockDvfsFile("content")));
+        REQUIRE(vfs.mountFile("b", file));
+
+        REQUIRE(vfs.getFile("b") == file);
+        REQUIRE(vfs.getFile("a") != file);
+        REQUIRE(file->getReferenceCount() == 2);
+
+        REQUIRE(vfs.unmountFile("b"));
+    }
+}
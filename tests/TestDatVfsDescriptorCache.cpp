@@ -0,0 +1,150 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <DatVfs.h>
+
+using namespace Dvfs;
+
+namespace {
+    std::string readContent(const IDvfsFile& file) {
+        std::string content(file.fileSize(), '\0');
+        if (!file.getContent(content.data())) return {};
+        return content;
+    }
+
+    void writeFile(const std::filesystem::path& path, const std::string& content) {
+        std::ofstream stream(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        stream << content;
+    }
+}
+
+TEST_CASE("DvfsDescriptorCache", "[DvfsDescriptorCache]") {
+    DvfsDescriptorCache cache(2);
+    const int keys[3] = {};
+    uint64_t size = 0;
+
+    SECTION("Repeated acquires hit") {
+        auto first = cache.acquire(&keys[0], "../../include/DatVfs.h", size);
+        REQUIRE(first != nullptr);
+        REQUIRE(size == std::filesystem::file_size("../../include/DatVfs.h"));
+
+        auto second = cache.acquire(&keys[0], "../../include/DatVfs.h", size);
+        REQUIRE(second == first);
+
+        DvfsDescriptorCache::Stats stats = cache.getStats();
+        REQUIRE(stats.hits == 1);
+        REQUIRE(stats.misses == 1);
+        REQUIRE(stats.openCount == 1);
+        REQUIRE(stats.getHitRate() == 0.5);
+    }
+
+    SECTION("Least recently used descriptors are closed") {
+        auto first = cache.acquire(&keys[0], "../../include/DatVfs.h", size);
+        cache.acquire(&keys[1], "../../include/DatPath.h", size);
+        // Using the first again makes the second the least recently used
+        cache.acquire(&keys[0], "../../include/DatVfs.h", size);
+        cache.acquire(&keys[2], "../../include/DatGlob.h", size);
+
+        DvfsDescriptorCache::Stats stats = cache.getStats();
+        REQUIRE(stats.evictions == 1);
+        REQUIRE(stats.openCount == 2);
+
+        REQUIRE(cache.acquire(&keys[0], "../../include/DatVfs.h", size) == first);
+        cache.acquire(&keys[1], "../../include/DatPath.h", size);
+        REQUIRE(cache.getStats().misses == 4);
+    }
+
+    SECTION("Evicted descriptors stay usable while held") {
+        auto descriptor = cache.acquire(&keys[0], "../../include/DatVfs.h", size);
+        cache.clear();
+        REQUIRE(cache.getStats().openCount == 0);
+
+        char start[8];
+        REQUIRE(descriptor->read(start, 0, sizeof(start)));
+        REQUIRE(std::string(start, sizeof(start)) == "#pragma ");
+    }
+
+    SECTION("Missing files and directories") {
+        REQUIRE(cache.acquire(&keys[0], "../../include/Missing.h", size) == nullptr);
+        REQUIRE(cache.acquire(&keys[0], "../../include", size) == nullptr);
+        REQUIRE(cache.getStats().openCount == 0);
+    }
+}
+
+TEST_CASE("LooseDvfsFile descriptor caching", "[DvfsDescriptorCache]") {
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "dvfs-descriptor-cache-test";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    const std::filesystem::path filePath = directory / "table.txt";
+    writeFile(filePath, "first version");
+
+    DvfsDescriptorCache cache;
+    LooseDvfsFile::setDescriptorCache(&cache);
+    REQUIRE(LooseDvfsFile::getDescriptorCache() == &cache);
+
+    LooseDvfsFile file(filePath);
+
+    SECTION("Whole and ranged reads share a descriptor") {
+        REQUIRE(readContent(file) == "first version");
+
+        char range[7];
+        REQUIRE(file.getContentRange(range, 6, 7));
+        REQUIRE(std::string(range, 7) == "version");
+        REQUIRE_FALSE(file.getContentRange(range, 10, 7));
+
+        DvfsDescriptorCache::Stats stats = cache.getStats();
+        REQUIRE(stats.misses == 1);
+        REQUIRE(stats.hits >= 2);
+    }
+
+    SECTION("Replaced files are reopened") {
+        REQUIRE(readContent(file) == "first version");
+
+        writeFile(directory / "replacement.txt", "second");
+        std::filesystem::rename(directory / "replacement.txt", filePath);
+        REQUIRE(readContent(file) == "second");
+        REQUIRE(cache.getStats().misses == 2);
+    }
+
+    SECTION("Deleted files can't be read") {
+        REQUIRE(readContent(file) == "first version");
+
+        std::filesystem::remove(filePath);
+        char byte;
+        REQUIRE_FALSE(file.getContent(&byte));
+        REQUIRE(cache.getStats().openCount == 0);
+    }
+
+    SECTION("Slab files are kept open for the slab file") {
+        DatVFS vfs;
+        REQUIRE(vfs.mountFiles("loose", DvfsLooseFileInserter(directory), true).fileCount == 1);
+
+        IDvfsFile* slabFile = vfs.getFile("loose/table.txt");
+        REQUIRE(readContent(*slabFile) == "first version");
+        REQUIRE(readContent(*slabFile) == "first version");
+        REQUIRE(cache.getStats().misses == 1);
+        REQUIRE(cache.getStats().hits == 1);
+    }
+
+    SECTION("Destroyed files close their descriptors") {
+        {
+            const LooseDvfsFile temporary(filePath);
+            REQUIRE(readContent(temporary) == "first version");
+            REQUIRE(cache.getStats().openCount == 1);
+        }
+        REQUIRE(cache.getStats().openCount == 0);
+
+        DatVFS vfs;
+        REQUIRE(vfs.mountFiles("loose", DvfsLooseFileInserter(directory), true).fileCount == 1);
+        REQUIRE(readContent(*vfs.getFile("loose/table.txt")) == "first version");
+        REQUIRE(cache.getStats().openCount == 1);
+        REQUIRE(vfs.unmountFile("loose/table.txt"));
+        REQUIRE(cache.getStats().openCount == 0);
+    }
+
+    LooseDvfsFile::setDescriptorCache(nullptr);
+    std::filesystem::remove_all(directory);
+}
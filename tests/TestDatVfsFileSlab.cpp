@@ -0,0 +1,123 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+
+#include <DatVfs.h>
+#include <DatVfsFileSlab.h>
+
+using namespace Dvfs;
+
+class MockSlabDvfsFile : public SlabDvfsFile {
+public:
+    int& destroyed;
+
+    MockSlabDvfsFile(DvfsFileSlab& slab, int& destroyed) : SlabDvfsFile(slab), destroyed(destroyed) {}
+
+    ~MockSlabDvfsFile() override {
+        ++destroyed;
+    }
+
+    [[nodiscard]] uint64_t fileSize() const override {
+        return 0;
+    }
+
+    [[nodiscard]] bool isValidFile() const override {
+        return false;
+    }
+
+    bool getContent(char* buffer) const override {
+        return false;
+    }
+};
+
+TEST_CASE("DvfsFileSlab", "[DvfsFileSlab]") {
+    DvfsFileSlab* slab = DvfsFileSlab::create(256);
+
+    SECTION("Allocations are aligned") {
+        slab->allocate(1, 1);
+        REQUIRE(reinterpret_cast<uintptr_t>(slab->allocate(8, 8)) % 8 == 0);
+        slab->allocate(3, 1);
+        REQUIRE(reinterpret_cast<uintptr_t>(slab->allocate(16, 16)) % 16 == 0);
+        slab->release();
+    }
+
+    SECTION("Large allocations get their own chunk") {
+        slab->allocate(1024);
+        REQUIRE(slab->getMemoryUsage() >= 1024);
+        slab->release();
+    }
+
+    SECTION("Strings are copied") {
+        std::string string = "textures/player.png";
+        const std::string_view stored = slab->storeString(string);
+        string[0] = 'x';
+
+        REQUIRE(stored == "textures/player.png");
+        REQUIRE(slab->storeString("").empty());
+        slab->release();
+    }
+
+    SECTION("Files are counted") {
+        int destroyed = 0;
+        IDvfsFile* first = slab->createFile<MockSlabDvfsFile>(destroyed);
+        IDvfsFile* second = slab->createFile<MockSlabDvfsFile>(destroyed);
+        REQUIRE(slab->getFileCount() == 2);
+
+        delete first;
+        REQUIRE(destroyed == 1);
+        REQUIRE(slab->getFileCount() == 1);
+
+        // The slab outlives its creator while it still has files
+        slab->release();
+        delete second;
+        REQUIRE(destroyed == 2);
+    }
+
+    SECTION("Files are deleted by the VFS") {
+        int destroyed = 0;
+        DatVFS vfs;
+        REQUIRE(vfs.mountFile("a", slab->createFile<MockSlabDvfsFile>(destroyed)));
+        slab->release();
+
+        REQUIRE(vfs.unmountFile("a", true));
+        REQUIRE(destroyed == 1);
+    }
+}
+
+TEST_CASE("SlabLooseDvfsFile", "[DvfsFileSlab][IDvfsFile]") {
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "dvfs-file-slab-test";
+    std::filesystem::create_directories(directory / "sub");
+    std::ofstream(directory / "top.txt") << "top";
+    std::ofstream(directory / "sub" / "nested.txt") << "nested!";
+
+    SECTION("Files only store their relative path") {
+        // The vtable, reference count, slab, root and relative path
+        REQUIRE(sizeof(SlabLooseDvfsFile) <= 48);
+    }
+
+    SECTION("Loose inserter mounts slab files") {
+        DatVFS vfs;
+        REQUIRE(vfs.mountFiles("loose", DvfsLooseFileInserter(directory), true).fileCount == 2);
+
+        auto* nested = dynamic_cast<SlabLooseDvfsFile*>(vfs.getFile("loose/sub/nested.txt"));
+        REQUIRE(nested != nullptr);
+        REQUIRE(nested->getFilePath() == directory / "sub/nested.txt");
+        REQUIRE(nested->isValidFile());
+        REQUIRE(nested->fileSize() == 7);
+
+        char buffer[7];
+        REQUIRE(nested->getContent(buffer));
+        REQUIRE(std::string_view(buffer, 7) == "nested!");
+
+        auto* top = dynamic_cast<SlabLooseDvfsFile*>(vfs.getFile("loose/top.txt"));
+        REQUIRE(top != nullptr);
+        REQUIRE(&top->getSlab() == &nested->getSlab());
+        REQUIRE(top->getSlab().getFileCount() == 2);
+
+        REQUIRE(vfs.unmountFile("loose/top.txt", true));
+        REQUIRE(nested->getSlab().getFileCount() == 1);
+    }
+
+    std::filesystem::remove_all(directory);
+}
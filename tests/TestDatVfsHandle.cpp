@@ -0,0 +1,121 @@
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <DatVfs.h>
+
+#include "MockDvfsFile.h"
+
+using namespace Dvfs;
+
+TEST_CASE("DvfsHandleTable", "[DvfsHandleTable]") {
+    DvfsHandleTable table;
+    MockDvfsFile a;
+    MockDvfsFile b;
+
+    SECTION("Null handle never resolves") {
+        REQUIRE(DvfsFileHandle().isNull());
+        REQUIRE(table.resolve({}) == nullptr);
+    }
+
+    SECTION("Acquire resolves to the file") {
+        DvfsFileHandle handle = table.acquire(&a);
+        REQUIRE_FALSE(handle.isNull());
+        REQUIRE(table.resolve(handle) == &a);
+    }
+
+    SECTION("Each file has a single slot") {
+        REQUIRE(table.acquire(&a) == table.acquire(&a));
+        REQUIRE_FALSE(table.acquire(&a) == table.acquire(&b));
+        REQUIRE(table.size() == 2);
+    }
+
+    SECTION("Release invalidates handles") {
+        DvfsFileHandle handle = table.acquire(&a);
+        table.release(&a);
+
+        REQUIRE(table.resolve(handle) == nullptr);
+        REQUIRE(table.size() == 0);
+    }
+
+    SECTION("Reused slots don't resolve old handles") {
+        DvfsFileHandle oldHandle = table.acquire(&a);
+        table.release(&a);
+        DvfsFileHandle newHandle = table.acquire(&b);
+
+        REQUIRE(newHandle.index == oldHandle.index);
+        REQUIRE(table.resolve(oldHandle) == nullptr);
+        REQUIRE(table.resolve(newHandle) == &b);
+    }
+
+    SECTION("Out of range handles don't resolve") {
+        REQUIRE(table.resolve({100, 1}) == nullptr);
+    }
+}
+
+TEST_CASE("DatVFS file handles", "[DatVFS][DvfsHandleTable]") {
+    DatVFS vfs;
+    IDvfsFile* file = new MockDvfsFile;
+    REQUIRE(vfs.mountFile("directory/file", file, true));
+
+    SECTION("Handle resolves to the mounted file") {
+        DvfsFileHandle handle = vfs.getFileHandle("directory/file");
+        REQUIRE(vfs.isValid(handle));
+        REQUIRE(vfs.resolve(handle) == file);
+    }
+
+    SECTION("Missing files give the null handle") {
+        REQUIRE(vfs.getFileHandle("directory/missing").isNull());
+        REQUIRE_FALSE(vfs.isValid({}));
+    }
+
+    SECTION("Handles stop resolving after unmounting") {
+        DvfsFileHandle handle = vfs.getFileHandle("directory/file");
+        REQUIRE(vfs.unmountFile("directory/file"));
+        REQUIRE_FALSE(vfs.isValid(handle));
+    }
+
+    SECTION("Handles stop resolving after removing the directory") {
+        DvfsFileHandle handle = vfs.getFileHandle("directory/file");
+        REQUIRE(vfs.removeDirectory("directory"));
+        REQUIRE(vfs.resolve(handle) == nullptr);
+    }
+
+    SECTION("Handles survive while the file is mounted elsewhere") {
+        REQUIRE(vfs.mountFile("other", file));
+        DvfsFileHandle handle = vfs.getFileHandle("other");
+        REQUIRE(handle == vfs.getFileHandle("directory/file"));
+
+        REQUIRE(vfs.unmountFile("directory/file"));
+        REQUIRE(vfs.resolve(handle) == file);
+    }
+
+    SECTION("Handles can be requested from subdirectories") {
+        DvfsFileHandle handle = vfs.getDirectory("directory")->getFileHandle("file");
+        REQUIRE(vfs.resolve(handle) == file);
+    }
+
+    SECTION("Handles can be requested from many threads") {
+        for (int i = 0; i < 64; ++i) {
+            REQUIRE(vfs.mountFile(DatPath("many") / std::to_string(i), new MockDvfsFile, true));
+        }
+
+        const DatVFS& constVfs = vfs;
+        std::atomic<int> resolved = 0;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&constVfs, &resolved]() {
+                for (int i = 0; i < 64; ++i) {
+                    DvfsFileHandle handle = constVfs.getFileHandle(DatPath("many") / std::to_string(i));
+                    if (constVfs.resolve(handle) != nullptr) ++resolved;
+                }
+            });
+        }
+        for (std::thread& thread: threads) thread.join();
+
+        REQUIRE(resolved == 4 * 64);
+        REQUIRE(vfs.getFileHandle("many/0") == constVfs.getFileHandle("many/0"));
+    }
+}
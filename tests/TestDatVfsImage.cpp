@@ -0,0 +1,122 @@
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <string>
+
+#include <DatVfs.h>
+#include <DatVfsImage.h>
+
+#include "MockDvfsFile.h"
+
+using namespace Dvfs;
+
+static std::string encodeMockFile(const IDvfsFile& file) {
+    return dynamic_cast<const MockDvfsFile&>(file).content;
+}
+
+static IDvfsFile* decodeMockFile(std::string_view payload) {
+    return new MockDvfsFile(std::string(payload));
+}
+
+TEST_CASE("DvfsImage", "[DvfsImage]") {
+    DatVFS vfs;
+    REQUIRE(vfs.mountFile("readme.txt", new MockDvfsFile("readme"), true));
+    REQUIRE(vfs.mountFile("textures/player.png", new MockDvfsFile("player"), true));
+    REQUIRE(vfs.mountFile("textures/enemy.png", new MockDvfsFile("enemy"), true));
+    REQUIRE(vfs.mountFile("textures/ui/button.png", new MockDvfsFile("button"), true));
+    REQUIRE(vfs.createDirectory("empty"));
+
+    IDvfsFile* shared = vfs.getFile("readme.txt");
+    REQUIRE(vfs.mountFile("docs/readme.txt", shared, true));
+
+    std::vector<char> buffer = DvfsImage::build(vfs, encodeMockFile);
+    REQUIRE_FALSE(buffer.empty());
+
+    std::unique_ptr<DvfsImage> image = DvfsImage::load(buffer, decodeMockFile);
+    REQUIRE(image != nullptr);
+
+    SECTION("Counts") {
+        REQUIRE(image->getDirectoryCount() == 5);
+        // The shared file is only stored once
+        REQUIRE(image->getFileCount() == 4);
+        REQUIRE_FALSE(image->isMapped());
+    }
+
+    SECTION("Lookups match the VFS") {
+        for (const char* path: {"readme.txt", "textures", "textures/player.png", "textures/ui/button.png", "empty",
+                                "docs/readme.txt", "missing", "textures/missing.png", "readme.txt/child", ""}) {
+            CAPTURE(path);
+            REQUIRE(image->exists(path) == vfs.exists(path));
+            REQUIRE((image->getFile(path) != nullptr) == (vfs.getFile(path) != nullptr));
+        }
+    }
+
+    SECTION("Files are decoded once") {
+        auto* file = dynamic_cast<MockDvfsFile*>(image->getFile("textures/ui/button.png"));
+        REQUIRE(file != nullptr);
+        REQUIRE(file->content == "button");
+        REQUIRE(image->getFile("./textures//ui/button.png") == file);
+
+        // Paths sharing a file share the decoded file too
+        REQUIRE(image->getFile("docs/readme.txt") == image->getFile("readme.txt"));
+    }
+
+    SECTION("Listing") {
+        auto files = vfs.listFiles("textures");
+        std::ranges::sort(files);
+        REQUIRE(image->listFiles("textures") == files);
+        REQUIRE(image->listDirectories() == std::vector<std::string>{"docs", "empty", "textures"});
+        REQUIRE(image->listDirectories("textures") == std::vector<std::string>{"ui"});
+        REQUIRE(image->listFiles("missing").empty());
+    }
+
+    SECTION("Invalid images are rejected") {
+        REQUIRE(DvfsImage::load({}, decodeMockFile) == nullptr);
+
+        std::vector<char> corrupt = buffer;
+        corrupt[0] = 'X';
+        REQUIRE(DvfsImage::load(corrupt, decodeMockFile) == nullptr);
+
+        std::vector<char> truncated(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(buffer.size() / 2));
+        REQUIRE(DvfsImage::load(truncated, decodeMockFile) == nullptr);
+    }
+
+    SECTION("Write and map") {
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / "dvfs-image-test.img";
+        REQUIRE(DvfsImage::write(vfs, path, encodeMockFile));
+
+        std::unique_ptr<DvfsImage> mapped = DvfsImage::open(path, decodeMockFile);
+        REQUIRE(mapped != nullptr);
+        REQUIRE(mapped->exists("textures/enemy.png") == 1);
+        REQUIRE(dynamic_cast<MockDvfsFile*>(mapped->getFile("textures/enemy.png"))->content == "enemy");
+
+        mapped.reset();
+        std::filesystem::remove(path);
+        REQUIRE(DvfsImage::open(path, decodeMockFile) == nullptr);
+    }
+}
+
+TEST_CASE("DvfsImage case-insensitive", "[DvfsImage]") {
+    DatVFS vfs;
+    REQUIRE(vfs.setCaseInsensitive(true));
+    REQUIRE(vfs.mountFile("Textures/Player.PNG", new MockDvfsFile("player"), true));
+
+    std::unique_ptr<DvfsImage> image = DvfsImage::load(DvfsImage::build(vfs, encodeMockFile), decodeMockFile);
+    REQUIRE(image != nullptr);
+    REQUIRE(image->isCaseInsensitive());
+    REQUIRE(image->exists("TEXTURES/player.png") == 1);
+    REQUIRE(image->getFile("textures/PLAYER.png") != nullptr);
+}
+
+TEST_CASE("DvfsImage loose files", "[DvfsImage]") {
+    DatVFS vfs;
+    REQUIRE(vfs.mountFile("header", new LooseDvfsFile("../../include/DatVfsImage.h")));
+
+    std::unique_ptr<DvfsImage> image = DvfsImage::load(DvfsImage::build(vfs));
+    REQUIRE(image != nullptr);
+
+    IDvfsFile* file = image->getFile("header");
+    REQUIRE(file != nullptr);
+    REQUIRE(file->isValidFile());
+    REQUIRE(file->fileSize() == std::filesystem::file_size("../../include/DatVfsImage.h"));
+}
@@ -0,0 +1,143 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <DatVfs.h>
+
+#include "MockDvfsFile.h"
+
+using namespace Dvfs;
+
+TEST_CASE("DvfsFileIndex", "[DvfsFileIndex]") {
+    SECTION("Get extension") {
+        REQUIRE(DvfsFileIndex::getExtension("sound.wav") == "wav");
+        REQUIRE(DvfsFileIndex::getExtension("archive.tar.gz") == "gz");
+        REQUIRE(DvfsFileIndex::getExtension("noextension").empty());
+        REQUIRE(DvfsFileIndex::getExtension(".hidden").empty());
+    }
+
+    SECTION("Insert and erase") {
+        DvfsFileIndex index;
+        MockDvfsFile file;
+        const std::string a = "a.wav";
+        const std::string b = "b.wav";
+        const std::string c = "c.wav";
+
+        index.insert(nullptr, a, &file, "audio");
+        index.insert(nullptr, b, &file);
+        index.insert(nullptr, c, &file, "audio");
+
+        REQUIRE(index.size() == 3);
+        REQUIRE(index.getByExtension("wav").size() == 3);
+        REQUIRE(index.getByTag("audio").size() == 2);
+
+        REQUIRE(index.erase(a));
+        REQUIRE_FALSE(index.erase(a));
+        REQUIRE(index.size() == 2);
+        REQUIRE(index.getByExtension("wav").size() == 2);
+        REQUIRE(index.getByTag("audio").size() == 1);
+        REQUIRE(index.getByTag("audio")[0].name == "c.wav");
+
+        // The remaining entries must still be removable after being moved
+        REQUIRE(index.erase(c));
+        REQUIRE(index.erase(b));
+        REQUIRE(index.getByExtension("wav").empty());
+        REQUIRE(index.getByTag("audio").empty());
+    }
+
+    SECTION("Missing buckets") {
+        DvfsFileIndex index;
+        REQUIRE(index.getByExtension("wav").empty());
+        REQUIRE(index.getByTag("audio").empty());
+    }
+}
+
+TEST_CASE("DatVFS index", "[DatVFS][DvfsFileIndex]") {
+    DatVFS vfs;
+    vfs.mountFile("audio/music.wav", new MockDvfsFile, true);
+    vfs.mountFile("audio/effects/bang.wav", new MockDvfsFile, true);
+    vfs.mountFile("ui/click.wav", new MockDvfsFile, true);
+    vfs.mountFile("shaders/main.vert", new MockDvfsFile, true);
+
+    SECTION("Disabled by default") {
+        REQUIRE(vfs.getIndex() == nullptr);
+    }
+
+    SECTION("Find by extension without index") {
+        REQUIRE(vfs.findByExtension("wav").size() == 3);
+        REQUIRE(vfs.findByExtension("wav", "audio").size() == 2);
+    }
+
+    SECTION("Enabling indexes existing files") {
+        vfs.enableIndex();
+
+        REQUIRE(vfs.getIndex() != nullptr);
+        REQUIRE(vfs.getIndex()->size() == 4);
+        REQUIRE(vfs.findByExtension("wav").size() == 3);
+        REQUIRE(vfs.findByExtension("vert").size() == 1);
+        REQUIRE(vfs.findByExtension("wav", "audio").size() == 2);
+        REQUIRE(vfs.findByExtension("wav", "audio/effects").size() == 1);
+        REQUIRE(vfs.findByExtension("wav", "missing").empty());
+    }
+
+    SECTION("Index is shared with subdirectories") {
+        vfs.enableIndex();
+        DatVFS* audio = vfs.getDirectory("audio");
+
+        REQUIRE(audio->getIndex() == vfs.getIndex());
+        REQUIRE(audio->findByExtension("wav").size() == 2);
+    }
+
+    SECTION("Mounting updates the index") {
+        vfs.enableIndex();
+        IDvfsFile* file = new MockDvfsFile;
+        REQUIRE(vfs.mountFile("audio/voice.wav", file, false, "dialogue"));
+
+        REQUIRE(vfs.findByExtension("wav").size() == 4);
+
+        auto tagged = vfs.findByTag("dialogue");
+        REQUIRE(tagged.size() == 1);
+        REQUIRE(tagged[0].name == "voice.wav");
+        REQUIRE(tagged[0].file == file);
+        REQUIRE(tagged[0].directory == vfs.getDirectory("audio"));
+    }
+
+    SECTION("Unmounting updates the index") {
+        vfs.enableIndex();
+        REQUIRE(vfs.unmountFile("audio/music.wav"));
+
+        REQUIRE(vfs.findByExtension("wav").size() == 2);
+        REQUIRE(vfs.getIndex()->size() == 3);
+    }
+
+    SECTION("Removing a directory updates the index") {
+        vfs.enableIndex();
+        REQUIRE(vfs.removeDirectory("audio"));
+
+        REQUIRE_FALSE(vfs.exists("audio"));
+        REQUIRE(vfs.findByExtension("wav").size() == 1);
+        REQUIRE(vfs.getIndex()->size() == 2);
+    }
+
+    SECTION("Removing a nested directory") {
+        vfs.enableIndex();
+        REQUIRE(vfs.removeDirectory("audio/effects"));
+
+        REQUIRE(vfs.exists("audio") == -1);
+        REQUIRE_FALSE(vfs.exists("audio/effects"));
+        REQUIRE(vfs.findByExtension("wav").size() == 2);
+    }
+
+    SECTION("Tags are ignored while disabled") {
+        REQUIRE(vfs.mountFile("audio/voice.wav", new MockDvfsFile, false, "dialogue"));
+        vfs.enableIndex();
+
+        REQUIRE(vfs.findByTag("dialogue").empty());
+    }
+
+    SECTION("Disabling") {
+        vfs.enableIndex();
+        vfs.disableIndex();
+
+        REQUIRE(vfs.getIndex() == nullptr);
+        REQUIRE(vfs.findByExtension("wav").size() == 3);
+    }
+}
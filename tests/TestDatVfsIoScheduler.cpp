@@ -0,0 +1,186 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <DatVfsIoScheduler.h>
+
+#include "MockDvfsFile.h"
+
+using namespace Dvfs;
+
+namespace {
+    class ScheduledMockDvfsFile : public MockDvfsFile {
+    public:
+        DvfsFileLocation location;
+
+        ScheduledMockDvfsFile(std::string content, uint64_t offset) : MockDvfsFile(std::move(content)), location{1, offset} {
+            // Empty files stand in for files that can't be read
+            valid = !this->content.empty();
+        }
+
+        [[nodiscard]] DvfsFileLocation getLocation() const override {
+            return location;
+        }
+    };
+
+    /**
+     * Records the order reads complete in
+     */
+    class CompletionLog {
+        std::mutex mutex;
+
+    public:
+        std::vector<std::string> order;
+
+        DvfsIoScheduler::Completion record(std::string name) {
+            return [this, name = std::move(name)](bool success) {
+                std::lock_guard lock(mutex);
+                order.push_back(success ? name : "!" + name);
+            };
+        }
+    };
+}
+
+TEST_CASE("DvfsIoScheduler", "[DvfsIoScheduler]") {
+    DvfsIoScheduler scheduler;
+    CompletionLog log;
+    char buffer[64];
+
+    ScheduledMockDvfsFile texture("texture", 30), model("model", 20), audio("audio", 40), music("music", 10);
+
+    SECTION("Reads fill the buffer") {
+        bool succeeded = false;
+        scheduler.read(audio, buffer, [&](bool success) { succeeded = success; });
+        scheduler.waitForReads();
+
+        REQUIRE(succeeded);
+        REQUIRE(std::string(buffer, audio.fileSize()) == "audio");
+    }
+
+    SECTION("Failed reads complete unsuccessfully") {
+        ScheduledMockDvfsFile missing("", 0);
+        scheduler.read(missing, buffer, log.record("missing"));
+        scheduler.waitForReads();
+        REQUIRE(log.order == std::vector<std::string>{"!missing"});
+    }
+
+    SECTION("Higher priorities go first") {
+        scheduler.pause();
+        scheduler.read(texture, buffer, log.record("texture"), DvfsIoPriority::Background);
+        scheduler.read(model, buffer, log.record("model"));
+        scheduler.read(audio, buffer, log.record("audio"), DvfsIoPriority::Critical);
+        REQUIRE(scheduler.getQueuedCount() == 3);
+
+        scheduler.resume();
+        scheduler.waitForReads();
+        REQUIRE(log.order == std::vector<std::string>{"audio", "model", "texture"});
+    }
+
+    SECTION("Reads of the same priority are swept by location") {
+        scheduler.pause();
+        scheduler.read(audio, buffer, log.record("audio"));
+        scheduler.read(model, buffer, log.record("model"));
+        scheduler.read(texture, buffer, log.record("texture"));
+        scheduler.resume();
+        scheduler.waitForReads();
+        REQUIRE(log.order == std::vector<std::string>{"model", "texture", "audio"});
+
+        // The sweep carries on from where it was, wrapping around to the start
+        log.order.clear();
+        scheduler.pause();
+        scheduler.read(music, buffer, log.record("music"));
+        scheduler.read(audio, buffer, log.record("audio"));
+        scheduler.resume();
+        scheduler.waitForReads();
+        REQUIRE(log.order == std::vector<std::string>{"audio", "music"});
+    }
+
+    SECTION("Overdue reads go ahead of everything") {
+        scheduler.pause();
+        scheduler.read(audio, buffer, log.record("audio"), DvfsIoPriority::Critical);
+        scheduler.read(music, buffer, log.record("music"), DvfsIoPriority::Background, DvfsIoScheduler::Clock::now());
+        scheduler.read(texture, buffer, log.record("texture"), DvfsIoPriority::Background,
+                       DvfsIoScheduler::Clock::now() + std::chrono::hours(1));
+        scheduler.resume();
+        scheduler.waitForReads();
+        REQUIRE(log.order == std::vector<std::string>{"music", "audio", "texture"});
+    }
+
+    SECTION("Reads go ahead once they'd miss their deadline") {
+        // Each read is estimated to take an hour, so a deadline in half an hour has to start now
+        scheduler.setReadTimeEstimate(std::chrono::hours(1), 0);
+        scheduler.pause();
+        scheduler.read(audio, buffer, log.record("audio"), DvfsIoPriority::Critical);
+        scheduler.read(music, buffer, log.record("music"), DvfsIoPriority::Background,
+                       DvfsIoScheduler::Clock::now() + std::chrono::minutes(30));
+        scheduler.read(texture, buffer, log.record("texture"), DvfsIoPriority::Background,
+                       DvfsIoScheduler::Clock::now() + std::chrono::hours(2));
+        scheduler.resume();
+        scheduler.waitForReads();
+        REQUIRE(log.order == std::vector<std::string>{"music", "audio", "texture"});
+    }
+
+    SECTION("Large reads are estimated to take longer") {
+        // 1 byte per second makes the 5 byte music read start 5 seconds early, the 3 second deadline is already late
+        scheduler.setReadTimeEstimate(std::chrono::seconds(0), 1);
+        scheduler.pause();
+        scheduler.read(audio, buffer, log.record("audio"), DvfsIoPriority::Critical);
+        scheduler.read(music, buffer, log.record("music"), DvfsIoPriority::Background,
+                       DvfsIoScheduler::Clock::now() + std::chrono::seconds(3));
+        scheduler.resume();
+        scheduler.waitForReads();
+        REQUIRE(log.order == std::vector<std::string>{"music", "audio"});
+    }
+
+    SECTION("Background bandwidth is limited") {
+        // Each 5 byte read holds back the next by 50ms
+        scheduler.setBackgroundBandwidth(100);
+        const auto start = DvfsIoScheduler::Clock::now();
+
+        scheduler.pause();
+        scheduler.read(music, buffer, log.record("music"), DvfsIoPriority::Background);
+        scheduler.read(model, buffer, log.record("model"), DvfsIoPriority::Background);
+        scheduler.read(audio, buffer, log.record("audio"), DvfsIoPriority::Background);
+        scheduler.read(texture, buffer, log.record("texture"), DvfsIoPriority::Critical);
+        scheduler.resume();
+        scheduler.waitForReads();
+
+        REQUIRE(DvfsIoScheduler::Clock::now() - start >= std::chrono::milliseconds(100));
+        REQUIRE(log.order == std::vector<std::string>{"texture", "music", "model", "audio"});
+    }
+
+    SECTION("Cancel") {
+        scheduler.pause();
+        const uint64_t id = scheduler.read(audio, buffer, log.record("audio"));
+        scheduler.read(model, buffer, log.record("model"));
+
+        REQUIRE(scheduler.cancel(id));
+        REQUIRE_FALSE(scheduler.cancel(id));
+        scheduler.resume();
+        scheduler.waitForReads();
+        REQUIRE(log.order == std::vector<std::string>{"model"});
+    }
+
+    SECTION("Destroying completes queued reads unsuccessfully") {
+        {
+            DvfsIoScheduler paused;
+            paused.pause();
+            paused.read(audio, buffer, log.record("audio"));
+        }
+        REQUIRE(log.order == std::vector<std::string>{"!audio"});
+    }
+}
+
+TEST_CASE("LooseDvfsFile location", "[DvfsIoScheduler]") {
+    const LooseDvfsFile header("../../include/DatVfsIoScheduler.h");
+    const LooseDvfsFile source("../../source/DatVfsIoScheduler.cpp");
+    const LooseDvfsFile missing("../../include/missing.h");
+
+    REQUIRE(missing.getLocation() == DvfsFileLocation());
+#if __has_include(<sys/stat.h>)
+    REQUIRE(header.getLocation() != source.getLocation());
+    REQUIRE(header.getLocation() == header.getLocation());
+#endif
+}
@@ -0,0 +1,98 @@
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <thread>
+
+#include <DatVfs.h>
+
+#include "MockDvfsFile.h"
+
+using namespace Dvfs;
+
+TEST_CASE("DvfsLookupCache", "[DvfsLookupCache]") {
+    MockDvfsFile file;
+    int resolves = 0;
+    auto resolve = [&] {
+        ++resolves;
+        return &file;
+    };
+
+    const auto* directory = reinterpret_cast<const DatVFS*>(&file);
+    // Start every section with nothing cached
+    DvfsLookupCache::invalidate();
+
+    SECTION("Repeated lookups are cached") {
+        REQUIRE(DvfsLookupCache::lookup(directory, "a/b", resolve) == &file);
+        REQUIRE(DvfsLookupCache::lookup(directory, "a/b", resolve) == &file);
+        REQUIRE(resolves == 1);
+
+        // Other paths and directories are cached separately
+        DvfsLookupCache::lookup(directory, "a/c", resolve);
+        DvfsLookupCache::lookup(nullptr, "a/b", resolve);
+        REQUIRE(resolves == 3);
+    }
+
+    SECTION("Invalidating makes entries stale") {
+        DvfsLookupCache::lookup(directory, "a/b", resolve);
+        const uint64_t epoch = DvfsLookupCache::getEpoch();
+        DvfsLookupCache::invalidate();
+        REQUIRE(DvfsLookupCache::getEpoch() == epoch + 1);
+
+        DvfsLookupCache::lookup(directory, "a/b", resolve);
+        REQUIRE(resolves == 2);
+    }
+
+    SECTION("Threads have their own entries") {
+        DvfsLookupCache::lookup(directory, "a/b", resolve);
+
+        int threadResolves = 0;
+        std::thread thread([&] {
+            DvfsLookupCache::lookup(directory, "a/b", [&] {
+                ++threadResolves;
+                return &file;
+            });
+        });
+        thread.join();
+
+        REQUIRE(threadResolves == 1);
+        DvfsLookupCache::lookup(directory, "a/b", resolve);
+        REQUIRE(resolves == 1);
+    }
+}
+
+TEST_CASE("DatVFS lookup cache", "[DatVFS][DvfsLookupCache]") {
+    DatVFS vfs;
+    IDvfsFile* file = new MockDvfsFile;
+    REQUIRE(vfs.mountFile("shaders/main.vert", file, true));
+
+    const DatPath path("shaders/main.vert");
+    REQUIRE(vfs.getFile(path) == file);
+
+    SECTION("Mounting and unmounting are seen straight away") {
+        const DatPath other("shaders/other.vert");
+        REQUIRE(vfs.getFile(other) == nullptr);
+
+        IDvfsFile* otherFile = new MockDvfsFile;
+        REQUIRE(vfs.mountFile(other, otherFile));
+        REQUIRE(vfs.getFile(other) == otherFile);
+
+        REQUIRE(vfs.unmountFile(path));
+        REQUIRE(vfs.getFile(path) == nullptr);
+    }
+
+    SECTION("Removing and pruning directories are seen straight away") {
+        REQUIRE(vfs.removeDirectory("shaders"));
+        REQUIRE(vfs.getFile(path) == nullptr);
+
+        REQUIRE(vfs.createDirectory("shaders/empty", true));
+        REQUIRE(vfs.getFile("shaders/empty/file") == nullptr);
+        REQUIRE(vfs.prune("", true) == 2);
+        REQUIRE(vfs.getFile("shaders/empty/file") == nullptr);
+    }
+
+    SECTION("VFSs don't share entries") {
+        DatVFS other;
+        REQUIRE(other.getFile(path) == nullptr);
+        REQUIRE(vfs.getDirectory("shaders")->getFile("main.vert") == file);
+        REQUIRE(vfs.getFile(path) == file);
+    }
+}
@@ -0,0 +1,160 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <DatHash.h>
+#include <DatVfs.h>
+
+#include "MockDvfsFile.h"
+
+using namespace Dvfs;
+
+TEST_CASE("DvfsManifest", "[DvfsManifest]") {
+    DvfsManifest manifest;
+    manifest.add("a.txt", 5, 0x1234);
+    manifest.add("dir/b with spaces.txt", 0, 0xfedcba9876543210);
+
+    SECTION("Finding files") {
+        REQUIRE(manifest.size() == 2);
+        REQUIRE(manifest.find("a.txt")->hash == 0x1234);
+        REQUIRE(manifest.find("missing.txt") == nullptr);
+
+        manifest.add("a.txt", 6, 0x5678);
+        REQUIRE(manifest.size() == 2);
+        REQUIRE(manifest.find("a.txt")->size == 6);
+    }
+
+    SECTION("Text round trip") {
+        std::stringstream stream;
+        REQUIRE(manifest.write(stream));
+        REQUIRE(stream.str().starts_with("0000000000001234 5 a.txt\n"));
+
+        DvfsManifest read;
+        REQUIRE(read.read(stream));
+        REQUIRE(read.size() == 2);
+        REQUIRE(read.find("dir/b with spaces.txt")->hash == 0xfedcba9876543210);
+    }
+
+    SECTION("Malformed text") {
+        std::stringstream stream("nothex 5 a.txt\n");
+        DvfsManifest read;
+        REQUIRE_FALSE(read.read(stream));
+
+        std::stringstream missingPath("1234 5\n");
+        REQUIRE_FALSE(read.read(missingPath));
+    }
+
+    SECTION("Hashing large files in pieces") {
+        std::string content(3 * 1024 * 1024 + 17, '\0');
+        for (size_t i = 0; i < content.size(); ++i) content[i] = static_cast<char>(i * 31 + i / 977);
+
+        MockDvfsFile file(content);
+        uint64_t hash;
+        REQUIRE(DvfsManifest::hashFile(file, hash));
+        REQUIRE(hash == DvfsHasher::hash(content.data(), content.size()));
+
+        file.readable = false;
+        REQUIRE_FALSE(DvfsManifest::hashFile(file, hash));
+    }
+}
+
+TEST_CASE("DatVFS verification", "[DvfsManifest][DatVFS]") {
+    DatVFS vfs;
+    auto* damaged = new MockDvfsFile("content c");
+    REQUIRE(vfs.mountFile("game/a.txt", new MockDvfsFile("content a"), true));
+    REQUIRE(vfs.mountFile("game/data/b.txt", new MockDvfsFile("content b"), true));
+    REQUIRE(vfs.mountFile("game/data/c.txt", damaged, true));
+    REQUIRE(vfs.mountFile("game/data/deep/d.txt", new MockDvfsFile(std::string(2 * 1024 * 1024, 'd')), true));
+
+    const DvfsManifest manifest = vfs.createManifestParallel("game");
+    REQUIRE(manifest.size() == 4);
+    REQUIRE(manifest.find("data/deep/d.txt") != nullptr);
+
+    SECTION("An intact install passes") {
+        DvfsVerifyResult result = vfs.verifyParallel(manifest, "game");
+        REQUIRE(result.isValid());
+        REQUIRE(result.filesChecked == 4);
+        REQUIRE(result.bytesHashed == 27 + 2 * 1024 * 1024);
+    }
+
+    SECTION("Damaged, resized, unreadable and extra files are reported") {
+        damaged->content = "content C";
+        REQUIRE(vfs.mountFile("game/extra.txt", new MockDvfsFile("extra"), true));
+
+        DvfsVerifyResult result = vfs.verifyParallel(manifest, "game");
+        REQUIRE(result.mismatches.size() == 2);
+        REQUIRE(result.mismatches[0].path == "data/c.txt");
+        REQUIRE(result.mismatches[0].problem == DvfsVerifyMismatch::Problem::HashMismatch);
+        REQUIRE(result.mismatches[1].path == "extra.txt");
+        REQUIRE(result.mismatches[1].problem == DvfsVerifyMismatch::Problem::Unlisted);
+
+        damaged->content = "longer content";
+        result = vfs.verifyParallel(manifest, "game");
+        REQUIRE(result.mismatches[0].problem == DvfsVerifyMismatch::Problem::SizeMismatch);
+
+        damaged->content = "content c";
+        damaged->readable = false;
+        result = vfs.verifyParallel(manifest, "game");
+        REQUIRE(result.mismatches[0].problem == DvfsVerifyMismatch::Problem::ReadFailed);
+    }
+
+    SECTION("Missing files are reported") {
+        REQUIRE(vfs.unmountFile("game/data/b.txt"));
+
+        DvfsVerifyResult result = vfs.verifyParallel(manifest, "game");
+        REQUIRE(result.mismatches.size() == 1);
+        REQUIRE(result.mismatches[0].path == "data/b.txt");
+        REQUIRE(result.mismatches[0].problem == DvfsVerifyMismatch::Problem::Missing);
+
+        // Every file is missing when the directory is gone
+        REQUIRE(vfs.verifyParallel(manifest, "elsewhere").mismatches.size() == 4);
+    }
+
+    SECTION("Scope") {
+        damaged->content = "content C";
+
+        // Without recursion, only the top level is checked or reported missing
+        DvfsVerifyResult result = vfs.verifyParallel(manifest, "game", false, [](const std::string&, IDvfsFile*) {return true;});
+        REQUIRE(result.isValid());
+        REQUIRE(result.filesChecked == 1);
+
+        // Filtered out files are skipped rather than missing
+        result = vfs.verifyParallel(manifest, "game", true, [](const std::string& name, IDvfsFile*) {
+            return name != "c.txt";
+        });
+        REQUIRE(result.isValid());
+        REQUIRE(result.filesChecked == 3);
+    }
+}
+
+TEST_CASE("DatVFS verification of one large directory", "[DvfsManifest][DatVFS]") {
+    DatVFS vfs;
+    for (int i = 0; i < 64; ++i) {
+        REQUIRE(vfs.mountFile("flat/" + std::to_string(i) + ".txt", new MockDvfsFile("content " + std::to_string(i)), true));
+    }
+
+    // Each check takes long enough that the pool's threads all pick up batches
+    DvfsThreadPool pool(4);
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    auto predicate = [&](const std::string&, IDvfsFile*) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        std::lock_guard lock(mutex);
+        threads.insert(std::this_thread::get_id());
+        return true;
+    };
+
+    const DvfsManifest manifest = vfs.createManifestParallel("flat", true, predicate, pool);
+    REQUIRE(manifest.size() == 64);
+    REQUIRE(threads.size() > 1);
+
+    threads.clear();
+    const DvfsVerifyResult result = vfs.verifyParallel(manifest, "flat", true, predicate, pool);
+    REQUIRE(result.isValid());
+    REQUIRE(result.filesChecked == 64);
+    REQUIRE(threads.size() > 1);
+}
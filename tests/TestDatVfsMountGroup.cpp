@@ -0,0 +1,117 @@
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <vector>
+
+#include <DatVfs.h>
+
+#include "MockDvfsFile.h"
+
+using namespace Dvfs;
+
+TEST_CASE("DvfsMountGroups", "[DvfsMountGroups]") {
+    DvfsMountGroups groups;
+    const std::string first = "first", second = "second", third = "third", other = "other";
+
+    const uint32_t group = groups.create();
+    const uint32_t otherGroup = groups.create();
+    REQUIRE(group != otherGroup);
+    REQUIRE_FALSE(groups.contains(group));
+
+    groups.add(group, nullptr, first);
+    groups.add(group, nullptr, second);
+    groups.add(group, nullptr, third);
+    groups.add(otherGroup, nullptr, other);
+    REQUIRE(groups.size() == 4);
+
+    SECTION("Front is the last file added") {
+        REQUIRE(groups.front(group).name == &third);
+        REQUIRE(groups.front(otherGroup).name == &other);
+        REQUIRE(groups.front(groups.create()).name == nullptr);
+    }
+
+    SECTION("Forget entries from anywhere in a group") {
+        REQUIRE(groups.forget(second));
+        REQUIRE(groups.forget(third));
+        REQUIRE_FALSE(groups.forget(third));
+
+        REQUIRE(groups.front(group).name == &first);
+        REQUIRE(groups.forget(first));
+        REQUIRE_FALSE(groups.contains(group));
+        REQUIRE(groups.size() == 1);
+    }
+
+    SECTION("Renamed entries keep their place") {
+        const std::string moved = second;
+        REQUIRE(groups.rename(second.data(), moved));
+        REQUIRE_FALSE(groups.forget(second));
+
+        REQUIRE(groups.forget(third));
+        REQUIRE(groups.front(group).name == &moved);
+        REQUIRE(groups.forget(moved));
+        REQUIRE(groups.front(group).name == &first);
+    }
+
+    SECTION("Forgetting the last entry removes the group") {
+        REQUIRE(groups.forget(other));
+        REQUIRE_FALSE(groups.contains(otherGroup));
+    }
+}
+
+TEST_CASE("DatVFS mount groups", "[DatVFS][DvfsMountGroups]") {
+    DatVFS vfs;
+    REQUIRE(vfs.mountFile("mods/keep", new MockDvfsFile, true));
+
+    const DvfsMountGroup group = vfs.mountFiles("mods", MockDvfsPathInserter({"a/1", "a/2", "a/b/1", "top"}), true);
+    const DvfsMountGroup otherGroup = vfs.mountFiles("other", MockDvfsPathInserter({"1", "2"}), true);
+    REQUIRE(group.fileCount == 4);
+    REQUIRE(vfs.hasGroup(group));
+    REQUIRE(vfs.hasGroup(otherGroup));
+
+    SECTION("Unmount a group") {
+        REQUIRE(vfs.unmountGroup(group) == 4);
+        REQUIRE_FALSE(vfs.hasGroup(group));
+        REQUIRE(vfs.countFiles("", true) == 3);
+
+        // Without pruning the directories stay
+        REQUIRE(vfs.getDirectory("mods/a/b") != nullptr);
+        REQUIRE(vfs.unmountGroup(group) == 0);
+    }
+
+    SECTION("Unmount a group and prune") {
+        REQUIRE(vfs.unmountGroup(group, true) == 4);
+        REQUIRE(vfs.getDirectory("mods/a") == nullptr);
+        REQUIRE(vfs.exists("mods/keep") == 1);
+
+        REQUIRE(vfs.unmountGroup(otherGroup, true) == 2);
+        REQUIRE(vfs.getDirectory("other") == nullptr);
+    }
+
+    SECTION("Files unmounted since are skipped") {
+        REQUIRE(vfs.unmountFile("mods/a/1"));
+        REQUIRE(vfs.mountFile("mods/a/1", new MockDvfsFile));
+
+        REQUIRE(vfs.unmountGroup(group) == 3);
+        REQUIRE(vfs.exists("mods/a/1") == 1);
+    }
+
+    SECTION("Removed directories leave the group") {
+        REQUIRE(vfs.removeDirectory("mods/a"));
+        REQUIRE(vfs.unmountGroup(group) == 1);
+        REQUIRE(vfs.exists("mods/top") == 0);
+    }
+
+    SECTION("Shared files keep their other references") {
+        IDvfsFile* shared = vfs.getFile("other/1");
+        REQUIRE(vfs.mountFile("shared", shared));
+
+        REQUIRE(vfs.unmountGroup(otherGroup) == 2);
+        REQUIRE(vfs.getFile("shared") == shared);
+        REQUIRE(shared->getReferenceCount() == 1);
+    }
+
+    SECTION("Nothing mounted gives a null group") {
+        const DvfsMountGroup empty = vfs.mountFiles("mods", MockDvfsPathInserter({"top"}), true);
+        REQUIRE(empty.isNull());
+        REQUIRE(empty.fileCount == 0);
+    }
+}
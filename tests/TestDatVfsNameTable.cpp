@@ -0,0 +1,193 @@
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+
+#include <DatVfs.h>
+
+#include "MockDvfsFile.h"
+
+using namespace Dvfs;
+
+TEST_CASE("DvfsNameTable", "[DvfsNameTable]") {
+    DvfsNameTable<int> table;
+    for (int i = 0; i < 1000; ++i) {
+        REQUIRE(table.emplace("name_" + std::to_string(i), i).second);
+    }
+    REQUIRE_FALSE(table.emplace(std::string("name_0"), 0).second);
+
+    std::unordered_map<const char*, const char*> moves;
+    auto record = [&](const char* previous, const auto& entry) { moves[previous] = entry.first.data(); };
+
+    SECTION("Freeze") {
+        REQUIRE(table.freeze(record));
+        REQUIRE(table.isFrozen());
+        REQUIRE(table.size() == 1000);
+        REQUIRE(moves.size() == 1000);
+
+        for (int i = 0; i < 1000; ++i) {
+            const std::string name = "name_" + std::to_string(i);
+            auto it = table.find(std::string_view(name));
+            REQUIRE(it != table.end());
+            REQUIRE(it->first == name);
+            REQUIRE(it->second == i);
+            REQUIRE(table.contains(HashedName(name)));
+        }
+
+        REQUIRE_FALSE(table.contains(std::string_view("name_1000")));
+        REQUIRE_FALSE(table.contains(std::string_view("")));
+        REQUIRE(table.count(std::string_view("missing")) == 0);
+    }
+
+    SECTION("Iterate a frozen table") {
+        REQUIRE(table.freeze(record));
+
+        int sum = 0, count = 0;
+        for (auto& [name, value]: table) {
+            sum += value;
+            ++count;
+            // Values can still be changed in place
+            value = -value;
+        }
+        REQUIRE(count == 1000);
+        REQUIRE(sum == 999 * 1000 / 2);
+        REQUIRE(table.find(std::string_view("name_7"))->second == -7);
+    }
+
+    SECTION("Thaw") {
+        REQUIRE(table.freeze(record));
+        const char* frozenName = table.find(std::string_view("name_5"))->first.data();
+
+        moves.clear();
+        table.thaw(record);
+        REQUIRE_FALSE(table.isFrozen());
+        REQUIRE(moves.size() == 1000);
+        REQUIRE(moves[frozenName] == table.find(std::string_view("name_5"))->first.data());
+
+        REQUIRE(table.emplace(std::string("extra"), 1000).second);
+        table.erase(table.find(std::string_view("name_0")));
+        REQUIRE(table.size() == 1000);
+        REQUIRE(table.contains(std::string_view("extra")));
+        REQUIRE_FALSE(table.contains(std::string_view("name_0")));
+
+        // Freezing again gives the same lookups
+        REQUIRE(table.freeze(record));
+        REQUIRE(table.find(std::string_view("extra"))->second == 1000);
+        REQUIRE_FALSE(table.contains(std::string_view("name_0")));
+    }
+
+    SECTION("Empty and small tables") {
+        DvfsNameTable<int> empty;
+        REQUIRE(empty.freeze(record));
+        REQUIRE(empty.empty());
+        REQUIRE(empty.begin() == empty.end());
+        REQUIRE_FALSE(empty.contains(std::string_view("name")));
+
+        DvfsNameTable<int> single;
+        single.emplace(std::string("only"), 1);
+        REQUIRE(single.freeze(record));
+        REQUIRE(single.find(std::string_view("only"))->second == 1);
+        REQUIRE_FALSE(single.contains(std::string_view("other")));
+    }
+
+    SECTION("Clear") {
+        REQUIRE(table.freeze(record));
+        table.clear();
+        REQUIRE_FALSE(table.isFrozen());
+        REQUIRE(table.empty());
+        REQUIRE(table.emplace(std::string("name_0"), 0).second);
+    }
+}
+
+TEST_CASE("DatVFS freeze", "[DatVFS][DvfsNameTable]") {
+    DatVFS vfs;
+    vfs.enableIndex();
+    for (int i = 0; i < 50; ++i) {
+        REQUIRE(vfs.mountFile("sounds/effect_" + std::to_string(i) + ".wav", new MockDvfsFile, true, "audio"));
+    }
+    REQUIRE(vfs.mountFile("shaders/main.vert", new MockDvfsFile, true));
+    REQUIRE(vfs.createDirectory("shaders/empty"));
+
+    vfs.freeze();
+    REQUIRE(vfs.isFrozen());
+    REQUIRE(vfs.getDirectory("sounds")->isFrozen());
+
+    SECTION("Lookups are unchanged") {
+        REQUIRE(vfs.getFile("sounds/effect_17.wav") != nullptr);
+        REQUIRE(vfs.getFile("sounds/effect_50.wav") == nullptr);
+        REQUIRE(vfs.getFile("shaders/main.vert"_dp) != nullptr);
+        REQUIRE(vfs.exists("shaders/empty") == -1);
+        REQUIRE(vfs.countFiles("", true) == 51);
+        REQUIRE(vfs.listDirectories("shaders") == std::vector<std::string>{"empty"});
+    }
+
+    SECTION("The index follows the names") {
+        auto tagged = vfs.findByTag("audio");
+        REQUIRE(tagged.size() == 50);
+        REQUIRE(std::ranges::all_of(tagged, [](const DvfsFileIndex::Entry& entry) {
+            return entry.directory->getFile(DatPath(std::string(entry.name))) == entry.file;
+        }));
+    }
+
+    SECTION("Changes thaw only the directory changed") {
+        REQUIRE(vfs.mountFile("sounds/new.wav", new MockDvfsFile, false, "audio"));
+        REQUIRE_FALSE(vfs.getDirectory("sounds")->isFrozen());
+        REQUIRE(vfs.isFrozen());
+        REQUIRE(vfs.getDirectory("shaders")->isFrozen());
+
+        REQUIRE(vfs.findByTag("audio").size() == 51);
+        REQUIRE(vfs.unmountFile("sounds/effect_3.wav"));
+        REQUIRE(vfs.findByTag("audio").size() == 50);
+
+        REQUIRE(vfs.removeDirectory("shaders/empty"));
+        REQUIRE_FALSE(vfs.getDirectory("shaders")->isFrozen());
+        REQUIRE(vfs.getIndex()->size() == 51);
+    }
+
+    SECTION("Failed changes don't thaw") {
+        REQUIRE_FALSE(vfs.unmountFile("sounds/missing.wav"));
+        MockDvfsFile file;
+        REQUIRE_FALSE(vfs.mountFile("sounds/effect_1.wav", &file));
+        REQUIRE(vfs.getDirectory("sounds")->isFrozen());
+        REQUIRE(vfs.prune() == 0);
+        REQUIRE(vfs.isFrozen());
+    }
+
+    SECTION("Pruning") {
+        REQUIRE(vfs.prune("", true) == 1);
+        REQUIRE(vfs.getDirectory("shaders/empty") == nullptr);
+        REQUIRE(vfs.getDirectory("sounds")->isFrozen());
+    }
+
+    SECTION("Pruning in parallel") {
+        for (int i = 0; i < 8; ++i) {
+            REQUIRE(vfs.mountFile("dir_" + std::to_string(i) + "/file.txt", new MockDvfsFile, true, "text"));
+            REQUIRE(vfs.createDirectory("dir_" + std::to_string(i) + "/empty"));
+        }
+        vfs.freeze();
+
+        // Sibling directories prune at once, which mustn't move files the shared index points at
+        REQUIRE(vfs.pruneParallel() == 9);
+        REQUIRE(vfs.getDirectory("dir_3/empty") == nullptr);
+        REQUIRE(vfs.getDirectory("dir_3")->getFile("file.txt") != nullptr);
+        REQUIRE(vfs.findByTag("text").size() == 8);
+        REQUIRE(vfs.getIndex()->size() == 59);
+    }
+}
+
+TEST_CASE("DatVFS freeze mount groups", "[DatVFS][DvfsNameTable][DvfsMountGroups]") {
+    DatVFS vfs;
+    REQUIRE(vfs.setCaseInsensitive(true));
+
+    DvfsLooseFileInserter inserter("../../include");
+    const DvfsMountGroup group = vfs.mountFiles("Include", inserter, true);
+    REQUIRE(group.fileCount > 0);
+
+    vfs.freeze();
+    REQUIRE(vfs.getFile("include/DATVFS.h") != nullptr);
+    REQUIRE(vfs.getFile("INCLUDE/datvfsnametable.h"_dp) != nullptr);
+
+    REQUIRE(vfs.unmountGroup(group, true) == group.fileCount);
+    REQUIRE(vfs.getDirectory("include") == nullptr);
+    REQUIRE(vfs.empty());
+}
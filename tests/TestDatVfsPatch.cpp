@@ -0,0 +1,230 @@
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <DatVfs.h>
+
+#include "MockDvfsFile.h"
+
+using namespace Dvfs;
+
+namespace {
+    std::string readContent(const IDvfsFile& file) {
+        std::string content(file.fileSize(), '\0');
+        if (!file.getContent(content.data())) return "<failed>";
+        return content;
+    }
+
+    std::string makeText(size_t length, unsigned seed) {
+        std::string text(length, '\0');
+        for (char& c: text) {
+            seed = seed * 1103515245 + 12345;
+            c = static_cast<char>('a' + (seed >> 16) % 26);
+        }
+        return text;
+    }
+}
+
+TEST_CASE("DvfsPatchPack deltas", "[DvfsPatchPack]") {
+    const std::string base = makeText(20000, 1);
+
+    SECTION("Edits, moves and insertions") {
+        std::string target = base.substr(10000) + makeText(300, 2) + base.substr(0, 5000);
+        target[1234] = '!';
+        target.insert(7000, "inserted");
+
+        const std::vector<char> delta = DvfsPatchPack::createDelta(base.data(), base.size(), target.data(), target.size());
+        REQUIRE(delta.size() < 600);
+
+        std::string output(target.size(), '\0');
+        REQUIRE(DvfsPatchPack::applyDelta(base.data(), base.size(), delta.data(), delta.size(), output.data(), output.size()));
+        REQUIRE(output == target);
+    }
+
+    SECTION("Small and unrelated content is inserted") {
+        const std::string target = "short";
+        const std::vector<char> delta = DvfsPatchPack::createDelta(base.data(), base.size(), target.data(), target.size());
+
+        std::string output(target.size(), '\0');
+        REQUIRE(DvfsPatchPack::applyDelta(base.data(), base.size(), delta.data(), delta.size(), output.data(), output.size()));
+        REQUIRE(output == target);
+    }
+
+    SECTION("Malformed deltas are rejected") {
+        const std::string target = base.substr(100, 1000);
+        std::vector<char> delta = DvfsPatchPack::createDelta(base.data(), base.size(), target.data(), target.size());
+
+        std::string output(target.size(), '\0');
+        // Wrong output size
+        REQUIRE_FALSE(DvfsPatchPack::applyDelta(base.data(), base.size(), delta.data(), delta.size(), output.data(), output.size() - 1));
+        // Base too short for the copy
+        REQUIRE_FALSE(DvfsPatchPack::applyDelta(base.data(), 500, delta.data(), delta.size(), output.data(), output.size()));
+        // Truncated
+        REQUIRE_FALSE(DvfsPatchPack::applyDelta(base.data(), base.size(), delta.data(), delta.size() - 1, output.data(), output.size()));
+        // Unknown operation
+        delta[0] = 7;
+        REQUIRE_FALSE(DvfsPatchPack::applyDelta(base.data(), base.size(), delta.data(), delta.size(), output.data(), output.size()));
+    }
+}
+
+TEST_CASE("DvfsPatchPack", "[DvfsPatchPack]") {
+    const std::string levelBefore = makeText(50000, 3);
+    std::string levelAfter = levelBefore;
+    levelAfter.replace(25000, 10, "0123456789");
+
+    auto* baseLevel = new MockDvfsFile(levelBefore);
+    DatVFS base;
+    REQUIRE(base.mountFile("data/level.bin", baseLevel, true));
+    REQUIRE(base.mountFile("data/same.txt", new MockDvfsFile("unchanged"), true));
+    REQUIRE(base.mountFile("data/old.txt", new MockDvfsFile("removed"), true));
+    REQUIRE(base.mountFile("config.ini", new MockDvfsFile("a=1"), true));
+
+    DatVFS target;
+    REQUIRE(target.mountFile("data/level.bin", new MockDvfsFile(levelAfter), true));
+    REQUIRE(target.mountFile("data/same.txt", new MockDvfsFile("unchanged"), true));
+    REQUIRE(target.mountFile("data/new.txt", new MockDvfsFile("added"), true));
+    REQUIRE(target.mountFile("config.ini", new MockDvfsFile("a=2"), true));
+
+    std::vector<char> packData = DvfsPatchPack::build(base, target);
+    REQUIRE(packData.size() < 1000);
+    baseLevel->reads = 0;
+
+    SECTION("Only changes are stored") {
+        std::unique_ptr<DvfsPatchPack> pack = DvfsPatchPack::load(packData);
+        REQUIRE(pack != nullptr);
+
+        const auto& entries = pack->getEntries();
+        REQUIRE(entries.size() == 4);
+        REQUIRE(entries[0].path == "config.ini");
+        REQUIRE(entries[0].kind == DvfsPatchPack::Kind::Full);
+        REQUIRE(entries[1].path == "data/level.bin");
+        REQUIRE(entries[1].kind == DvfsPatchPack::Kind::Delta);
+        REQUIRE(entries[2].path == "data/new.txt");
+        REQUIRE(entries[2].kind == DvfsPatchPack::Kind::Full);
+        REQUIRE(entries[3].path == "data/old.txt");
+        REQUIRE(entries[3].kind == DvfsPatchPack::Kind::Removed);
+    }
+
+    SECTION("Mounting applies the update") {
+        IDvfsFile* unchanged = base.getFile("data/same.txt");
+        DvfsMountGroup group;
+        {
+            // The mounted files keep the pack's data alive
+            std::unique_ptr<DvfsPatchPack> pack = DvfsPatchPack::load(packData);
+            group = pack->mount(base);
+        }
+        REQUIRE(group.fileCount == 3);
+        REQUIRE(baseLevel->reads == 0);
+
+        REQUIRE(base.getFile("data/same.txt") == unchanged);
+        REQUIRE(base.getFile("data/old.txt") == nullptr);
+        REQUIRE(readContent(*base.getFile("data/new.txt")) == "added");
+        REQUIRE(readContent(*base.getFile("config.ini")) == "a=2");
+
+        // The delta is applied on the first read, then kept
+        IDvfsFile* level = base.getFile("data/level.bin");
+        REQUIRE(level->fileSize() == levelAfter.size());
+        REQUIRE(readContent(*level) == levelAfter);
+        char range[10];
+        REQUIRE(level->getContentRange(range, 25000, 10));
+        REQUIRE(std::string(range, 10) == "0123456789");
+        REQUIRE(baseLevel->reads == 1);
+
+        // The whole update can be checked against the target
+        REQUIRE(base.verifyParallel(target.createManifestParallel()).isValid());
+    }
+
+    SECTION("Patched files are released through the VFS") {
+        DatVFS vfs;
+        vfs.enableDeduplication();
+        REQUIRE(vfs.mountFile("data/level.bin", new MockDvfsFile(levelBefore), true));
+        const DvfsFileHandle handle = vfs.getFileHandle("data/level.bin");
+
+        std::unique_ptr<DvfsPatchPack> pack = DvfsPatchPack::load(packData);
+        REQUIRE(pack->mount(vfs).fileCount == 3);
+        REQUIRE(vfs.isValid(handle));
+
+        // Unmounting the delta releases the base, which has to leave the deduplicator and handle table
+        REQUIRE(vfs.unmountFile("data/level.bin"));
+        REQUIRE_FALSE(vfs.isValid(handle));
+        REQUIRE(vfs.mountFile("data/copy.bin", new MockDvfsFile(levelBefore), true));
+        REQUIRE(readContent(*vfs.getFile("data/copy.bin")) == levelBefore);
+    }
+
+    SECTION("Deltas against the wrong file") {
+        const std::unique_ptr<DvfsPatchPack> pack = DvfsPatchPack::load(packData);
+        REQUIRE(pack->getEntries()[1].baseSize == levelBefore.size());
+
+        // A different size is caught when mounting, and the file is left alone
+        DatVFS other;
+        auto* otherLevel = new MockDvfsFile(makeText(40000, 4));
+        REQUIRE(other.mountFile("data/level.bin", otherLevel, true));
+        REQUIRE(pack->mount(other).fileCount == 2);
+        REQUIRE(other.getFile("data/level.bin") == otherLevel);
+        REQUIRE(otherLevel->reads == 0);
+
+        // The same size is only caught by the hash when the delta is read
+        DatVFS sameSize;
+        REQUIRE(sameSize.mountFile("data/level.bin", new MockDvfsFile(makeText(50000, 4)), true));
+        REQUIRE(pack->mount(sameSize).fileCount == 3);
+        REQUIRE(readContent(*sameSize.getFile("data/level.bin")) == "<failed>");
+    }
+
+    SECTION("Packs that don't fit are rolled back") {
+        DatVFS vfs;
+        auto* level = new MockDvfsFile(levelBefore);
+        auto* old = new MockDvfsFile("removed");
+        REQUIRE(vfs.mountFile("data/level.bin", level, true));
+        REQUIRE(vfs.mountFile("data/old.txt", old, true));
+        // A directory where the pack puts a file
+        REQUIRE(vfs.mountFile("config.ini/nested.txt", new MockDvfsFile("nested"), true));
+
+        std::unique_ptr<DvfsPatchPack> pack = DvfsPatchPack::load(packData);
+        REQUIRE(pack->mount(vfs).isNull());
+        REQUIRE(vfs.getFile("data/level.bin") == level);
+        REQUIRE(vfs.getFile("data/old.txt") == old);
+        REQUIRE(vfs.getFile("data/new.txt") == nullptr);
+        REQUIRE(readContent(*vfs.getFile("config.ini/nested.txt")) == "nested");
+        REQUIRE(readContent(*level) == levelBefore);
+
+        // The restored files are still counted as mounted
+        REQUIRE(vfs.unmountFile("data/old.txt"));
+        REQUIRE(vfs.getFile("data/old.txt") == nullptr);
+    }
+
+    SECTION("Deltas without a file to patch are skipped") {
+        DatVFS empty;
+        std::unique_ptr<DvfsPatchPack> pack = DvfsPatchPack::load(packData);
+        REQUIRE(pack->mount(empty, "sub").fileCount == 2);
+        REQUIRE(empty.getFile("sub/data/level.bin") == nullptr);
+        REQUIRE(readContent(*empty.getFile("sub/data/new.txt")) == "added");
+    }
+
+    SECTION("Packs on disk") {
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / "dvfs-patch-test.pak";
+        REQUIRE(DvfsPatchPack::write(base, target, path));
+
+        std::unique_ptr<DvfsPatchPack> pack = DvfsPatchPack::open(path);
+        REQUIRE(pack != nullptr);
+        pack->mount(base);
+        pack.reset();
+        REQUIRE(readContent(*base.getFile("data/level.bin")) == levelAfter);
+        REQUIRE(readContent(*base.getFile("config.ini")) == "a=2");
+
+        REQUIRE(DvfsPatchPack::open(std::filesystem::temp_directory_path() / "dvfs-missing.pak") == nullptr);
+        std::filesystem::remove(path);
+    }
+
+    SECTION("Malformed packs are rejected") {
+        std::vector<char> truncated(packData.begin(), packData.begin() + 40);
+        REQUIRE(DvfsPatchPack::load(truncated) == nullptr);
+
+        std::vector<char> badMagic = packData;
+        badMagic[0] = 'X';
+        REQUIRE(DvfsPatchPack::load(badMagic) == nullptr);
+
+        std::vector<char> shortData(packData.begin(), packData.end() - 1);
+        REQUIRE(DvfsPatchPack::load(shortData) == nullptr);
+    }
+}
@@ -0,0 +1,112 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+
+#include <DatVfs.h>
+#include <DatVfsPrefetcher.h>
+
+#include "MockDvfsFile.h"
+
+using namespace Dvfs;
+
+namespace {
+    class PrefetchMockDvfsFile : public MockDvfsFile {
+    public:
+        mutable std::atomic<int> prefetches = 0;
+
+        PrefetchMockDvfsFile() : MockDvfsFile("") {}
+
+        void prefetch() const override {
+            ++prefetches;
+        }
+    };
+}
+
+TEST_CASE("DvfsPrefetcher", "[DvfsPrefetcher]") {
+    DatVFS vfs;
+    std::vector<PrefetchMockDvfsFile*> files;
+    for (int i = 0; i < 8; ++i) {
+        files.push_back(new PrefetchMockDvfsFile);
+        vfs.mountFile(DatPath("level") / std::to_string(i), files.back(), true);
+    }
+
+    const std::filesystem::path historyFile = std::filesystem::temp_directory_path() / "dat-vfs-prefetch-test.txt";
+
+    SECTION("Records first accesses in order") {
+        DvfsPrefetcher prefetcher(vfs);
+        REQUIRE(prefetcher.getFile("level/3") == files[3]);
+        REQUIRE(prefetcher.getFile("level/1") == files[1]);
+        REQUIRE(prefetcher.getFile("level/3") == files[3]);
+        REQUIRE(prefetcher.getFile("missing") == nullptr);
+
+        REQUIRE(prefetcher.getSessionHistory() == std::vector<std::string>{"level/3", "level/1", "missing"});
+    }
+
+    SECTION("Explicit prefetch") {
+        DvfsPrefetcher prefetcher(vfs);
+        prefetcher.prefetch({"level/0", "level/5", "missing"});
+        prefetcher.waitForPrefetches();
+
+        REQUIRE(files[0]->prefetches == 1);
+        REQUIRE(files[5]->prefetches == 1);
+        REQUIRE(prefetcher.getPrefetchCount() == 2);
+    }
+
+    SECTION("Replays a saved history") {
+        {
+            DvfsPrefetcher prefetcher(vfs);
+            for (int i = 0; i < 8; ++i) {
+                prefetcher.getFile(DatPath("level") / std::to_string(i));
+            }
+            REQUIRE(prefetcher.saveHistory(historyFile));
+        }
+
+        DvfsPrefetcher prefetcher(vfs, 2);
+        REQUIRE(prefetcher.loadHistory(historyFile));
+        prefetcher.waitForPrefetches();
+
+        // Loading gets ahead of the first accesses
+        REQUIRE(files[0]->prefetches == 1);
+        REQUIRE(files[1]->prefetches == 1);
+        REQUIRE(files[2]->prefetches == 0);
+
+        // Each access prefetches the files that followed it last time
+        prefetcher.getFile("level/1");
+        prefetcher.waitForPrefetches();
+        REQUIRE(files[2]->prefetches == 1);
+        REQUIRE(files[3]->prefetches == 1);
+        REQUIRE(files[4]->prefetches == 0);
+
+        // Files are only prefetched once
+        prefetcher.getFile("level/2");
+        prefetcher.waitForPrefetches();
+        REQUIRE(files[3]->prefetches == 1);
+        REQUIRE(files[4]->prefetches == 1);
+        REQUIRE(prefetcher.getPrefetchCount() == 5);
+
+        std::filesystem::remove(historyFile);
+    }
+
+    SECTION("Rejects invalid history") {
+        {
+            std::ofstream stream(historyFile);
+            stream << "not a history file\n";
+        }
+
+        DvfsPrefetcher prefetcher(vfs);
+        REQUIRE_FALSE(prefetcher.loadHistory(historyFile));
+        REQUIRE_FALSE(prefetcher.loadHistory("blatantly/bad/path"));
+
+        std::filesystem::remove(historyFile);
+    }
+}
+
+TEST_CASE("LooseDvfsFile prefetch", "[DvfsPrefetcher][IDvfsFile]") {
+    LooseDvfsFile file("../../include/DatVfs.h");
+    REQUIRE_NOTHROW(file.prefetch());
+
+    LooseDvfsFile missing("./blatantly/bad/path");
+    REQUIRE_NOTHROW(missing.prefetch());
+}
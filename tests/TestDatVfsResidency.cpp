@@ -0,0 +1,207 @@
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <DatVfs.h>
+
+#include "MockDvfsFile.h"
+
+using namespace Dvfs;
+
+TEST_CASE("DvfsResidencyManager", "[DvfsResidencyManager]") {
+    DvfsResidencyManager manager(100);
+    MockDvfsFile level1(std::string(40, 'a'));
+    MockDvfsFile level2(std::string(40, 'b'));
+    MockDvfsFile ui(std::string(30, 'c'));
+
+    SECTION("Loading and reloading") {
+        DvfsResidencyManager::Content content = manager.load(level1, "level");
+        REQUIRE(content != nullptr);
+        REQUIRE(std::string(content->begin(), content->end()) == level1.content);
+
+        REQUIRE(manager.load(level1, "level") == content);
+        REQUIRE(manager.find(level1) == content);
+        REQUIRE(manager.find(level2) == nullptr);
+        REQUIRE(level1.reads == 1);
+        REQUIRE(manager.isResident(level1));
+
+        DvfsResidencyManager::Residency residency = manager.getResidency();
+        REQUIRE(residency.usedBytes == 40);
+        REQUIRE(residency.heldBytes == 40);
+        REQUIRE(residency.hits == 1);
+        REQUIRE(residency.misses == 1);
+    }
+
+    SECTION("Usage per tag") {
+        REQUIRE(manager.setBudget(200));
+        manager.load(level1, "level");
+        manager.load(level2, "level");
+        manager.load(ui, "ui");
+
+        DvfsResidencyManager::Residency residency = manager.getResidency();
+        REQUIRE(residency.fileCount == 3);
+        REQUIRE(residency.usedBytes == 110);
+        REQUIRE(residency.tags.size() == 2);
+        REQUIRE(residency.tags[0].tag == "level");
+        REQUIRE(residency.tags[0].bytes == 80);
+        REQUIRE(residency.tags[0].fileCount == 2);
+        REQUIRE(residency.tags[1].tag == "ui");
+
+        REQUIRE(manager.unloadTag("level") == 2);
+        REQUIRE(manager.getResidency().usedBytes == 30);
+        REQUIRE(manager.getResidency().tags.size() == 1);
+    }
+
+    SECTION("The lowest priority is unloaded first") {
+        manager.load(ui, "ui", 1);
+        manager.load(level1, "level");
+        manager.load(level2, "level");
+
+        // The UI is used least recently, but has the higher priority
+        REQUIRE(manager.isResident(ui));
+        REQUIRE_FALSE(manager.isResident(level1));
+        REQUIRE(manager.isResident(level2));
+        REQUIRE(manager.getResidency().evictions == 1);
+    }
+
+    SECTION("The least recently used is unloaded first") {
+        manager.load(level1);
+        manager.load(ui);
+        manager.find(level1);
+        manager.load(level2);
+
+        REQUIRE(manager.isResident(level1));
+        REQUIRE_FALSE(manager.isResident(ui));
+    }
+
+    SECTION("Held content is never unloaded to make room") {
+        DvfsResidencyManager::Content held1 = manager.load(level1);
+        DvfsResidencyManager::Content held2 = manager.load(level2);
+
+        REQUIRE(manager.load(ui) == nullptr);
+        REQUIRE(manager.getResidency().failures == 1);
+        REQUIRE(manager.getResidency().usedBytes == 80);
+
+        held1.reset();
+        REQUIRE(manager.load(ui) != nullptr);
+        REQUIRE_FALSE(manager.isResident(level1));
+    }
+
+    SECTION("Unloaded content stays accounted while held") {
+        DvfsResidencyManager::Content held1 = manager.load(level1, "level");
+        DvfsResidencyManager::Content held2 = manager.load(level2, "level");
+        REQUIRE(manager.unloadTag("level") == 2);
+
+        DvfsResidencyManager::Residency residency = manager.getResidency();
+        REQUIRE(residency.fileCount == 0);
+        REQUIRE(residency.usedBytes == 80);
+        REQUIRE(residency.heldBytes == 80);
+        REQUIRE(manager.load(ui) == nullptr);
+
+        held1.reset();
+        REQUIRE(manager.getResidency().usedBytes == 40);
+        REQUIRE(manager.load(ui) != nullptr);
+    }
+
+    SECTION("Content outlives the manager") {
+        DvfsResidencyManager::Content content;
+        {
+            DvfsResidencyManager scoped(100);
+            content = scoped.load(level1);
+        }
+        REQUIRE(std::string(content->begin(), content->end()) == level1.content);
+    }
+
+    SECTION("Throwing reads aren't kept") {
+        struct ThrowingFile : public MockDvfsFile {
+            mutable bool throwing = true;
+
+            ThrowingFile() : MockDvfsFile("content") {}
+
+            bool getContent(char* buffer) const override {
+                if (throwing) throw std::runtime_error("failed");
+                return MockDvfsFile::getContent(buffer);
+            }
+        } file;
+
+        REQUIRE_THROWS_AS(manager.load(file), std::runtime_error);
+        REQUIRE_FALSE(manager.isResident(file));
+        REQUIRE(manager.getResidency().usedBytes == 0);
+        REQUIRE(manager.getResidency().failures == 1);
+
+        // Nothing is left for the next load to wait on
+        file.throwing = false;
+        REQUIRE(manager.load(file) != nullptr);
+    }
+
+    SECTION("Files bigger than the budget fail") {
+        MockDvfsFile huge(std::string(101, 'h'));
+        REQUIRE(manager.load(huge) == nullptr);
+        REQUIRE(manager.getResidency().fileCount == 0);
+    }
+
+    SECTION("Unreadable files aren't kept") {
+        level1.readable = false;
+        REQUIRE(manager.load(level1) == nullptr);
+        REQUIRE_FALSE(manager.isResident(level1));
+        REQUIRE(manager.getResidency().usedBytes == 0);
+    }
+
+    SECTION("Lowering the budget unloads files") {
+        manager.load(level1);
+        manager.load(level2);
+
+        REQUIRE(manager.setBudget(50));
+        REQUIRE(manager.getResidency().usedBytes == 40);
+        REQUIRE(manager.isResident(level2));
+    }
+
+    SECTION("Loading through a VFS") {
+        DatVFS vfs;
+        auto* file = new MockDvfsFile("audio");
+        REQUIRE(vfs.mountFile("sounds/click.wav", file, true));
+
+        DvfsResidencyManager::Content content = manager.load(vfs, "sounds/click.wav", "audio");
+        REQUIRE(content != nullptr);
+        REQUIRE(manager.isResident(*file));
+        REQUIRE(manager.load(vfs, "sounds/missing.wav") == nullptr);
+
+        REQUIRE(manager.unload(*file));
+        REQUIRE_FALSE(manager.unload(*file));
+    }
+
+    SECTION("A new file at an unmounted file's address is read again") {
+        DatVFS vfs;
+        MockDvfsFile reused("first");
+        REQUIRE(vfs.mountFile("a.txt", &reused));
+        DvfsResidencyManager::Content first = manager.load(vfs, "a.txt");
+        REQUIRE(std::string(first->begin(), first->end()) == "first");
+
+        // Unmounting without deleting stands in for the file being deleted and another allocated in its place
+        REQUIRE(vfs.unmountFile("a.txt", false));
+        reused.content = "second";
+        REQUIRE(vfs.mountFile("b.txt", &reused));
+
+        DvfsResidencyManager::Content second = manager.load(vfs, "b.txt");
+        REQUIRE(std::string(second->begin(), second->end()) == "second");
+        REQUIRE(manager.load(vfs, "b.txt") == second);
+        REQUIRE(vfs.unmountFile("b.txt", false));
+    }
+
+    SECTION("Concurrent loads read once") {
+        std::vector<std::thread> threads;
+        std::atomic<int> loaded = 0;
+        for (int i = 0; i < 8; ++i) {
+            threads.emplace_back([&] {
+                if (manager.load(level1) != nullptr) ++loaded;
+            });
+        }
+        for (std::thread& thread: threads) thread.join();
+
+        REQUIRE(loaded == 8);
+        REQUIRE(level1.reads == 1);
+    }
+}
@@ -0,0 +1,81 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <stdexcept>
+
+#include <DatVfsThreadPool.h>
+
+using namespace Dvfs;
+
+TEST_CASE("DvfsThreadPool", "[DvfsThreadPool]") {
+    DvfsThreadPool pool(4);
+
+    SECTION("Size") {
+        REQUIRE(pool.size() == 4);
+    }
+
+    SECTION("Runs all tasks in a group") {
+        std::atomic<int> count = 0;
+        DvfsThreadPool::TaskGroup group(pool);
+        for (int i = 0; i < 1000; ++i) {
+            group.run([&count]() {++count;});
+        }
+        group.wait();
+
+        REQUIRE(count == 1000);
+    }
+
+    SECTION("Exceptions are rethrown once the group finishes") {
+        std::atomic<int> count = 0;
+        DvfsThreadPool::TaskGroup group(pool);
+        for (int i = 0; i < 100; ++i) {
+            group.run([&count, i]() {
+                if (i % 10 == 0) throw std::runtime_error("failed");
+                ++count;
+            });
+        }
+        REQUIRE_THROWS_AS(group.wait(), std::runtime_error);
+        REQUIRE(count == 90);
+
+        // Only thrown once
+        group.wait();
+
+        // A group destroyed without waiting still finishes
+        {
+            DvfsThreadPool::TaskGroup unwaited(pool);
+            unwaited.run([]() { throw std::runtime_error("failed"); });
+        }
+    }
+
+    SECTION("Nested groups") {
+        std::atomic<int> count = 0;
+        DvfsThreadPool::TaskGroup group(pool);
+        for (int i = 0; i < 16; ++i) {
+            group.run([&pool, &count]() {
+                DvfsThreadPool::TaskGroup inner(pool);
+                for (int j = 0; j < 16; ++j) {
+                    inner.run([&count]() {++count;});
+                }
+                inner.wait();
+            });
+        }
+        group.wait();
+
+        REQUIRE(count == 256);
+    }
+
+    SECTION("Tasks adding to their own group") {
+        std::atomic<int> count = 0;
+        DvfsThreadPool::TaskGroup group(pool);
+        std::function<void(int)> spawn = [&](int depth) {
+            ++count;
+            if (depth == 0) return;
+            group.run([&spawn, depth]() {spawn(depth - 1);});
+            group.run([&spawn, depth]() {spawn(depth - 1);});
+        };
+        group.run([&spawn]() {spawn(6);});
+        group.wait();
+
+        REQUIRE(count == 127);
+    }
+}
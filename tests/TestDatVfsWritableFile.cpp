@@ -0,0 +1,229 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <DatVfs.h>
+#include <DatVfsWritableDirectory.h>
+#include <DatVfsWritableFile.h>
+
+#include "MockDvfsFile.h"
+
+using namespace Dvfs;
+
+namespace {
+    std::string readContent(const IDvfsFile& file) {
+        std::string content(file.fileSize(), '\0');
+        if (!file.getContent(content.data())) return {};
+        return content;
+    }
+
+    std::filesystem::path makeTestDirectory() {
+        std::filesystem::path directory = std::filesystem::temp_directory_path() / "dat-vfs-writable-test";
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+        return directory;
+    }
+}
+
+TEST_CASE("LooseDvfsWritableFile", "[IDvfsWritableFile]") {
+    const std::filesystem::path directory = makeTestDirectory();
+    const std::filesystem::path filePath = directory / "save.dat";
+
+    SECTION("New file") {
+        LooseDvfsWritableFile file(filePath);
+        REQUIRE_FALSE(file.isValidFile());
+        REQUIRE_FALSE(file.hasPendingChanges());
+
+        REQUIRE(file.append("hello", 5));
+        REQUIRE(file.hasPendingChanges());
+
+        // Nothing is visible until committed
+        REQUIRE_FALSE(file.isValidFile());
+
+        REQUIRE(file.commit());
+        REQUIRE_FALSE(file.hasPendingChanges());
+        REQUIRE(file.isValidFile());
+        REQUIRE(readContent(file) == "hello");
+    }
+
+    SECTION("Writes build on committed content") {
+        LooseDvfsWritableFile file(filePath);
+        REQUIRE(file.append("hello world", 11));
+        REQUIRE(file.commit());
+
+        REQUIRE(file.write("WORLD", 5, 6));
+        REQUIRE(file.append("!", 1));
+        REQUIRE(file.commit());
+        REQUIRE(readContent(file) == "hello WORLD!");
+    }
+
+    SECTION("Non-contiguous and large writes") {
+        LooseDvfsWritableFile file(filePath, 4);
+        REQUIRE(file.write("ab", 2, 0));
+        REQUIRE(file.write("ef", 2, 4));
+        REQUIRE(file.write("cd", 2, 2));
+        REQUIRE(file.append("ghijklmnop", 10));
+        REQUIRE(file.commit());
+
+        REQUIRE(readContent(file) == "abcdefghijklmnop");
+    }
+
+    SECTION("Truncate") {
+        LooseDvfsWritableFile file(filePath);
+        REQUIRE(file.append("hello world", 11));
+        REQUIRE(file.truncate(5));
+        REQUIRE(file.commit());
+        REQUIRE(readContent(file) == "hello");
+
+        REQUIRE(file.truncate(0));
+        REQUIRE(file.append("bye", 3));
+        REQUIRE(file.commit());
+        REQUIRE(readContent(file) == "bye");
+    }
+
+    SECTION("Discard") {
+        LooseDvfsWritableFile file(filePath);
+        REQUIRE(file.append("hello", 5));
+        REQUIRE(file.commit());
+
+        REQUIRE(file.append(" world", 6));
+        file.discard();
+
+        REQUIRE_FALSE(file.hasPendingChanges());
+        REQUIRE(readContent(file) == "hello");
+        REQUIRE_FALSE(std::filesystem::exists(directory / "save.dat.dvfs-staging"));
+    }
+
+    SECTION("Failed publishes keep the staged writes") {
+        LooseDvfsWritableFile file(filePath);
+        REQUIRE(file.append("hello", 5));
+
+        // A directory in the way makes the rename fail
+        std::filesystem::create_directories(filePath / "blocker");
+        REQUIRE_FALSE(file.commit());
+        REQUIRE(file.hasPendingChanges());
+
+        std::filesystem::remove_all(filePath);
+        REQUIRE(file.commit());
+        REQUIRE(readContent(file) == "hello");
+    }
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("DvfsLooseWritableDirectory", "[IDvfsWritableFile][DatVFS]") {
+    const std::filesystem::path directory = makeTestDirectory();
+    DatVFS vfs;
+
+    SECTION("Open mounts the file") {
+        DvfsLooseWritableDirectory overlay(vfs, "saves", directory);
+        IDvfsWritableFile* file = overlay.openFile("slot1/save.dat");
+
+        REQUIRE(file != nullptr);
+        REQUIRE(vfs.getFile("saves/slot1/save.dat") == file);
+        REQUIRE(overlay.openFile("slot1/save.dat") == file);
+    }
+
+    SECTION("Overlays existing files") {
+        auto* lower = new MockDvfsFile("volume=5\n");
+        REQUIRE(vfs.mountFile("saves/config.ini", lower, true));
+
+        DvfsLooseWritableDirectory overlay(vfs, "saves", directory);
+        IDvfsWritableFile* file = overlay.openFile("config.ini");
+        REQUIRE(vfs.getFile("saves/config.ini") == file);
+
+        // The lower file is read until something is committed over it
+        REQUIRE(file->isValidFile());
+        REQUIRE(readContent(*file) == "volume=5\n");
+
+        REQUIRE(file->append("fov=90\n", 7));
+        REQUIRE(readContent(*file) == "volume=5\n");
+        file->discard();
+        REQUIRE(readContent(*file) == "volume=5\n");
+
+        REQUIRE(file->append("fov=90\n", 7));
+        REQUIRE(file->commit());
+        REQUIRE(readContent(*file) == "volume=5\nfov=90\n");
+        REQUIRE(lower->content == "volume=5\n");
+    }
+
+    SECTION("Files on disk are read over the lower file") {
+        {
+            std::ofstream stream(directory / "config.ini");
+            stream << "volume=8\n";
+        }
+        REQUIRE(vfs.mountFile("saves/config.ini", new MockDvfsFile("volume=5\n"), true));
+
+        DvfsLooseWritableDirectory overlay(vfs, "saves", directory);
+        REQUIRE(overlay.mountExisting() == 1);
+        REQUIRE(readContent(*vfs.getFile("saves/config.ini")) == "volume=8\n");
+
+        REQUIRE(overlay.openFile("config.ini")->truncate(0));
+        REQUIRE(overlay.openFile("config.ini")->commit());
+        REQUIRE(vfs.getFile("saves/config.ini")->fileSize() == 0);
+    }
+
+    SECTION("Lower files are released through the VFS") {
+        vfs.enableDeduplication();
+        REQUIRE(vfs.mountFile("saves/config.ini", new MockDvfsFile("volume=5\n"), true));
+        const DvfsFileHandle handle = vfs.getFileHandle("saves/config.ini");
+
+        DvfsLooseWritableDirectory overlay(vfs, "saves", directory);
+        REQUIRE(overlay.openFile("config.ini") != nullptr);
+        REQUIRE(vfs.isValid(handle));
+
+        // Unmounting the writable file releases the lower file too
+        REQUIRE(vfs.unmountFile("saves/config.ini"));
+        REQUIRE_FALSE(vfs.isValid(handle));
+
+        // The deduplicator must have forgotten the released file
+        REQUIRE(vfs.mountFile("saves/other.ini", new MockDvfsFile("volume=5\n"), true));
+        REQUIRE(readContent(*vfs.getFile("saves/other.ini")) == "volume=5\n");
+    }
+
+    SECTION("Refuses directories") {
+        REQUIRE(vfs.createDirectory("saves/save.dat", true));
+
+        DvfsLooseWritableDirectory overlay(vfs, "saves", directory);
+        REQUIRE(overlay.openFile("save.dat") == nullptr);
+    }
+
+    SECTION("Commit all") {
+        DvfsLooseWritableDirectory overlay(vfs, "saves", directory);
+        REQUIRE(overlay.openFile("a.dat")->append("a", 1));
+        REQUIRE(overlay.openFile("nested/b.dat")->append("b", 1));
+        REQUIRE(overlay.commitAll());
+
+        REQUIRE(readContent(*vfs.getFile("saves/a.dat")) == "a");
+        REQUIRE(readContent(*vfs.getFile("saves/nested/b.dat")) == "b");
+    }
+
+    SECTION("Mount existing") {
+        {
+            std::ofstream stream(directory / "existing.dat");
+            stream << "existing";
+        }
+        {
+            std::ofstream stream(directory / ("leftover.dat" + std::string(DvfsLooseWritableDirectory::stagingExtension)));
+            stream << "leftover";
+        }
+
+        DvfsLooseWritableDirectory overlay(vfs, "saves", directory);
+        REQUIRE(overlay.mountExisting() == 1);
+        REQUIRE(readContent(*vfs.getFile("saves/existing.dat")) == "existing");
+        REQUIRE(overlay.openFile("existing.dat") == vfs.getFile("saves/existing.dat"));
+    }
+
+    SECTION("Discard all") {
+        DvfsLooseWritableDirectory overlay(vfs, "saves", directory);
+        REQUIRE(overlay.openFile("a.dat")->append("a", 1));
+        overlay.discardAll();
+
+        REQUIRE_FALSE(overlay.openFile("a.dat")->hasPendingChanges());
+        REQUIRE_FALSE(vfs.getFile("saves/a.dat")->isValidFile());
+    }
+
+    std::filesystem::remove_all(directory);
+}